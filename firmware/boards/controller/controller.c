@@ -1,14 +1,14 @@
 #include <avr/interrupt.h>
+#include <string.h>
 
 #include "controller.h"
 
 #define _CONTROLLER_ADC_MAX 1023U
 
-// Calibration of joystick
-#define _ADC_CONVERT_LX(x) ((((int)x - 505) / 19) * 10)
-#define _ADC_CONVERT_LY(x) ((((int)x - 518) / 20) * 10)
-#define _ADC_CONVERT_RX(x) (((504 - (int)x) / 19) * 10)
-#define _ADC_CONVERT_RY(x) (((538 - (int)x) / 20) * 10)
+/** @brief Each scanned channel averages `2^shift` conversions */
+#define _CONTROLLER_OVERSAMPLE 2
+
+#define _CONTROLLER_CAL_SAMPLES 16U /**< Scans averaged for the centres */
 
 #define _CONTROLLER_MODE_COUNT 5
 #define _CONTROLLER_MASK_MODE 0x0F           /**< Mask of display */
@@ -23,7 +23,67 @@
 
 #define _CONTROLLER_TX_ENABLED 0x02 /**< Radio Transmission is enabled */
 #define _CONTROLLER_RX_ENABLED 0x01 /**< Radio Reception is enabled */
-#define _CONTROLLER_RX_DELAY 8000U  /**< Delay for reception */
+#define _CONTROLLER_RX_TIMEOUT 40U  /**< Milliseconds waiting for a packet */
+
+#define _CONTROLLER_PERIOD_TX 20U     /**< Control frame, milliseconds */
+#define _CONTROLLER_PERIOD_RX 5U      /**< Reception polling, milliseconds */
+#define _CONTROLLER_PERIOD_LINK 100U  /**< Link quality, milliseconds */
+#define _CONTROLLER_PERIOD_PROFILE 200U /**< Profile command, milliseconds */
+#define _CONTROLLER_PERIOD_SRAM 1000U   /**< SRAM check, milliseconds */
+#define _CONTROLLER_PERIOD_UI 10U       /**< UI events, milliseconds */
+
+#define _CONTROLLER_EVENT_TOGGLE 0x02 /**< Toggle moved: radio mode changed */
+
+/** @brief Milliseconds without change before the last frame is sent again */
+#define _CONTROLLER_KEEPALIVE 50U
+
+/** @brief Milliseconds without a packet before a module value is stale */
+#define _CONTROLLER_STALE_AFTER 3000U
+
+#define _CONTROLLER_STORE_VALID 0x01 /**< A packet has been received */
+#define _CONTROLLER_STORE_STALE 0x02 /**< Shown greyed out */
+
+#define _CONTROLLER_GMC_BIN 10000U     /**< Count bin width, milliseconds */
+#define _CONTROLLER_GMC_BIN_PER_MIN 6U /**< Count bins in a minute */
+#define _CONTROLLER_GMC_BINS 60U       /**< Ten minutes of count bins */
+#define _CONTROLLER_GMC_WIDTH 6U       /**< Characters of a value */
+#define _CONTROLLER_GMC_COL_UNIT 216U
+
+#define _CONTROLLER_GMC_CHART_X 10U
+#define _CONTROLLER_GMC_CHART_Y ROW7
+#define _CONTROLLER_GMC_CHART_H 80U
+#define _CONTROLLER_GMC_CHART_BAR 5U   /**< Width of a bin, in pixels */
+#define _CONTROLLER_GMC_CHART_MAX 120U /**< Full scale, counts per minute */
+
+/** @brief Slot of a module in the store, from its packet ID */
+#define _CONTROLLER_STORE(id) ((id) - PACKET_ID_ATM)
+#define _CONTROLLER_STORE_COUNT _CONTROLLER_STORE(PACKET_ID_GMC + 1)
+
+/**
+ * @brief Position of the analog inputs in the background ADC scan
+ */
+typedef enum
+{
+    _CONTROLLER_SCAN_POT = 0,
+    _CONTROLLER_SCAN_LX,
+    _CONTROLLER_SCAN_LY,
+    _CONTROLLER_SCAN_RX,
+    _CONTROLLER_SCAN_RY,
+    _CONTROLLER_SCAN_COUNT
+} _controller_scan_t;
+
+/** @brief Joystick axis of a scanned channel */
+#define _CONTROLLER_AXIS(scan) ((scan) - _CONTROLLER_SCAN_LX)
+#define _CONTROLLER_AXIS_COUNT _CONTROLLER_AXIS(_CONTROLLER_SCAN_COUNT)
+
+/**
+ * @brief Calibration used until one is stored in EEPROM
+ */
+static const joystick_cal_t g_joystick_default[_CONTROLLER_AXIS_COUNT] = {
+    [_CONTROLLER_AXIS(_CONTROLLER_SCAN_LX)] = {0, 505, _CONTROLLER_ADC_MAX},
+    [_CONTROLLER_AXIS(_CONTROLLER_SCAN_LY)] = {0, 518, _CONTROLLER_ADC_MAX},
+    [_CONTROLLER_AXIS(_CONTROLLER_SCAN_RX)] = {0, 504, _CONTROLLER_ADC_MAX},
+    [_CONTROLLER_AXIS(_CONTROLLER_SCAN_RY)] = {0, 538, _CONTROLLER_ADC_MAX}};
 
 #define _DISPLAY_W 8U
 #define _DISPLAY_H 8U
@@ -33,13 +93,41 @@
 /** @brief Maximum signal strength */
 #define _RADIO_SIGNAL_MAX 0x10
 
+/**
+ * @brief Latest packet of a module, kept whichever screen is shown
+ */
+typedef struct
+{
+    packet_t packet; /**< Latest packet */
+    uint32_t stamp;  /**< Time of reception, in milliseconds */
+    byte_t flags;    /**< `_CONTROLLER_STORE_*` flags */
+} _controller_store_t;
+
+/**
+ * @brief Count history of the Geiger counter, in fixed-width time bins
+ */
+typedef struct
+{
+    uint16_t bin[_CONTROLLER_GMC_BINS]; /**< Counts of the closed bins, ring */
+    uint16_t count;                     /**< Counts of the open bin */
+    uint16_t peak;                      /**< Highest bin rate, CPM */
+    uint32_t total;                     /**< Counts since start */
+    byte_t head;                        /**< Slot of the open bin */
+    byte_t filled;                      /**< Closed bins, up to the ring size */
+} _controller_gmc_t;
+
 controller_t g_controller;
 packet_t g_packet;
 packet_t g_packet_tx;
+_controller_store_t g_store[_CONTROLLER_STORE_COUNT]; /**< Per-module data */
+_controller_gmc_t g_gmc;
 
 volatile byte_t g_ctrl_mode = 1;
 volatile byte_t g_module_en;
 volatile byte_t g_module_curr = 1;
+uint32_t g_last_tx; /**< Time of the last transmission, in milliseconds */
+uint32_t g_last_rx; /**< Time of the last reception, in milliseconds */
+joystick_axis_t g_axis[_CONTROLLER_AXIS_COUNT]; /**< Joystick filters */
 
 /**
  * @brief VEMAR Radio Status
@@ -65,8 +153,104 @@ static inline void _CONTROLLER_connect(void);
  */
 static inline void _CONTROLLER_reset_connection(void);
 
+/**
+ * @brief Switch the radio link profile according to the measured link quality,
+ * the car is notified before the switch
+ */
+static void _CONTROLLER_adapt_link(void);
+
+/**
+ * @brief Task sending the control frame, when transmission is enabled
+ */
+static void _CONTROLLER_task_tx(void);
+
+/**
+ * @brief Task polling the radio, when reception is enabled
+ */
+static void _CONTROLLER_task_rx(void);
+
+/**
+ * @brief Task adapting the link profile and showing the signal strength
+ */
+static void _CONTROLLER_task_link(void);
+
+/**
+ * @brief Keep the received packet as the latest data of its module
+ * @param mode Module, also the packet ID
+ */
+static void _CONTROLLER_store(byte_t mode);
+
+/**
+ * @brief Draw the stored values of a module if it is on screen, in grey when
+ * they are stale
+ * @param mode Module, also the packet ID
+ */
+static void _CONTROLLER_render(byte_t mode);
+
+/**
+ * @brief Grey out the values of the modules that stopped sending
+ */
+static void _CONTROLLER_check_stale(void);
+
+/**
+ * @brief Add the counts of the received Geiger packet to the open bin
+ */
+static void _CONTROLLER_gmc_count(void);
+
+/**
+ * @brief Get the average count rate of the last closed bins
+ * @param bins Number of bins averaged, fewer while the history fills up
+ * @return Count rate, in counts per minute
+ */
+static uint16_t _CONTROLLER_gmc_rate(byte_t bins);
+
+/**
+ * @brief Draw one bin of the count rate chart
+ * @param slot Slot of the bin in the history
+ */
+static void _CONTROLLER_gmc_chart_bar(byte_t slot);
+
+/**
+ * @brief Task closing the open Geiger bin, then drawing it on the chart
+ */
+static void _CONTROLLER_task_gmc(void);
+
+/**
+ * @brief Task handling the UI events posted by the interrupt handlers and
+ * the debounced presses of button 1, it runs between two radio tasks so the
+ * display never interrupts a transaction
+ */
+static void _CONTROLLER_task_ui(void);
+
+/**
+ * @brief Task checking the free SRAM, the LED is lit once the stack has come
+ * within `SRAM_WARNING_MARGIN` bytes of the data
+ */
+static void _CONTROLLER_task_sram(void);
+
+#if defined(VEMAR_PROFILE_ENABLED) && defined(VEMAR_DEBUG_ENABLED)
+/**
+ * @brief Task answering the serial commands of the profiler: `p` prints the
+ * table, `r` clears it
+ */
+static void _CONTROLLER_task_profile(void);
+#endif
+
+/**
+ * @brief Load the joystick calibration from EEPROM, or the default one
+ */
+static void _CONTROLLER_load_calibration(void);
+
+/**
+ * @brief Interactive joystick calibration, started by holding button 1 at
+ * boot: the centres are sampled with both sticks released, then the extents
+ * are tracked until button 1 is pressed, and the result is saved to EEPROM
+ */
+static void _CONTROLLER_calibrate(void);
+
 /**
  * @brief Display layout
+ * @param label Title of the screen, in program memory
  */
 static void _CONTROLLER_display_layout(const char *label);
 
@@ -93,19 +277,47 @@ void setup(void)
 #ifdef VEMAR_DEBUG_ENABLED
     SERIAL_init();
 #endif
+#ifdef VEMAR_TRACE_ENABLED
+    TRACE_init(); // telemetry for the ground station
+#endif
 
     CONTROLLER_DEBUG(str, "start setup\r\n");
+    PROFILE_init();
     CONTROLLER_init();
     RADIO_init(PIN_RADIO_CE, PIN_RADIO_CSN);
     TFT_init(PIN_TFT_CS, PIN_TFT_DC, PIN_TFT_RST);
     TFT_set_mode(TFT_LANDSCAPE, TFT_INVERTED, TFT_INVERTED);
     TFT_setup_text(TFT_TEXT_S, 1, RGB16_WHITE, RGB16_BLACK);
     CONTROLLER_interrupt();
+    if (PIN_LOW == PIN_read(PIN_BUTTON1))
+    {
+        _CONTROLLER_calibrate();
+    } // button 1 held at boot
 
     // g_module_en = 0x10;
     CONTROLLER_display_menu();
     _CONTROLLER_reset_connection();
     _CONTROLLER_set_radio_mode();
+
+    SCHED_every(_CONTROLLER_task_tx, _CONTROLLER_PERIOD_TX, SCHED_PRIO_HIGH);
+    SCHED_every(_CONTROLLER_task_rx, _CONTROLLER_PERIOD_RX, SCHED_PRIO_NORMAL);
+    SCHED_every(_CONTROLLER_task_link, _CONTROLLER_PERIOD_LINK,
+                SCHED_PRIO_LOW);
+    SCHED_every(_CONTROLLER_task_ui, _CONTROLLER_PERIOD_UI, SCHED_PRIO_NORMAL);
+    SCHED_every(_CONTROLLER_task_gmc, _CONTROLLER_GMC_BIN, SCHED_PRIO_LOW);
+    SCHED_every(_CONTROLLER_task_sram, _CONTROLLER_PERIOD_SRAM,
+                SCHED_PRIO_LOW);
+#if defined(VEMAR_PROFILE_ENABLED) && defined(VEMAR_DEBUG_ENABLED)
+    SCHED_every(_CONTROLLER_task_profile, _CONTROLLER_PERIOD_PROFILE,
+                SCHED_PRIO_LOW);
+#endif
+#ifdef VEMAR_DEBUG_ENABLED
+    sram_usage_t usage;
+
+    SRAM_get_usage(&usage);
+    CONTROLLER_DEBUGF("SRAM: data %u, bss %u, free %u\r\n",
+                      usage.data, usage.bss, usage.stack_free_min);
+#endif
     CONTROLLER_DEBUG(str, "end setup\r\n");
 }
 
@@ -114,15 +326,9 @@ void setup(void)
 //------------------------------------------------------------------------------
 void loop(void)
 {
-    if (BIT_is_set(g_ctrl_mode, _CONTROLLER_MODE_RX))
-    {
-        CONTROLLER_read();
-    }
-    if (BIT_is_set(g_ctrl_mode, _CONTROLLER_MODE_TX))
-    {
-        CONTROLLER_write();
-    }
-    CONTROLLER_update_connection();
+    PROFILE_BEGIN(PROFILE_LOOP);
+    SCHED_dispatch();
+    PROFILE_END(PROFILE_LOOP);
 }
 
 //------------------------------------------------------------------------------
@@ -138,13 +344,29 @@ void CONTROLLER_init(void)
     g_controller.jright = JOYSTICK_new(PIN_JOY_RX, PIN_JOY_RY, PIN_JOY_RB);
     g_controller.jleft = JOYSTICK_new(PIN_JOY_LX, PIN_JOY_LY, PIN_JOY_LB);
     g_controller.led = LED_new(PIN_LED);
+
+    BUTTON_register(&(g_controller.btn1));
+    BUTTON_register(&(g_controller.jright.button));
+    BUTTON_register(&(g_controller.jleft.button));
+    TIMER_tick_init_timer2();
+    BUTTON_service_start(); // runs once sei() is called
+
+    const adc_ch_t scan[_CONTROLLER_SCAN_COUNT] = {
+        [_CONTROLLER_SCAN_POT] = PIN_POTENTIOMETER,
+        [_CONTROLLER_SCAN_LX] = PIN_JOY_LX,
+        [_CONTROLLER_SCAN_LY] = PIN_JOY_LY,
+        [_CONTROLLER_SCAN_RX] = PIN_JOY_RX,
+        [_CONTROLLER_SCAN_RY] = PIN_JOY_RY};
+    ADC_scan_oversample(_CONTROLLER_OVERSAMPLE);
+    ADC_scan_start(scan, _CONTROLLER_SCAN_COUNT); // runs once sei() is called
+    _CONTROLLER_load_calibration();
 }
 
 void CONTROLLER_interrupt(void)
 {
     BIT_set(PCICR, (BIT(PCIE1) | BIT(PCIE2)));      // enable interrupt (Port C & D)
-    BIT_set(PCMSK1, (BIT(PCINT8) | BIT(PCINT9)));   // enable PC0 and PC1
-    BIT_set(PCMSK2, (BIT(PCINT19) | BIT(PCINT20))); // enable PD3 and PD4
+    BIT_set(PCMSK1, BIT(PCINT9)); // enable PC1, button 1 is debounced by polling
+    BIT_set(PCMSK2, (BIT(PCINT_TOGGLE_UP) | BIT(PCINT_TOGGLE_DOWN))); // toggle
     sei();
 }
 
@@ -156,14 +378,15 @@ void CONTROLLER_display_atmosphere(void)
     if (_CONTROLLER_MODE_ATM != BIT_read(g_ctrl_mode, _CONTROLLER_MASK_MODE))
     {
         TFT_fill_screen(RGB16_BLACK);
-        _CONTROLLER_display_layout("MODULE: Atmosphere");
-        TFT_print_str(COL1, ROW1, "Temperature: ");
-        TFT_print_str(COL3, ROW1, "C");
-        TFT_print_str(COL1, ROW2, "Humidity   : ");
-        TFT_print_str(COL3, ROW2, "%");
-        TFT_print_str(COL1, ROW3, "Pressure   : ");
-        TFT_print_str(COL3, ROW3, "hPa");
+        _CONTROLLER_display_layout(PSTR("MODULE: Atmosphere"));
+        TFT_print_str_P(COL1, ROW1, PSTR("Temperature: "));
+        TFT_print_str_P(COL3, ROW1, PSTR("C"));
+        TFT_print_str_P(COL1, ROW2, PSTR("Humidity   : "));
+        TFT_print_str_P(COL3, ROW2, PSTR("%"));
+        TFT_print_str_P(COL1, ROW3, PSTR("Pressure   : "));
+        TFT_print_str_P(COL3, ROW3, PSTR("hPa"));
         BIT_write(g_ctrl_mode, _CONTROLLER_MODE_ATM, _CONTROLLER_MASK_MODE);
+        _CONTROLLER_render(_CONTROLLER_MODE_ATM);
     }
 }
 
@@ -172,18 +395,19 @@ void CONTROLLER_display_gas(void)
     if (_CONTROLLER_MODE_GAS != BIT_read(g_ctrl_mode, _CONTROLLER_MASK_MODE))
     {
         TFT_fill_screen(RGB16_BLACK);
-        _CONTROLLER_display_layout("MODULE: Gas");
-        TFT_print_str(COL1, ROW1, "CO2        : ");
-        TFT_print_str(COL3, ROW1, "ppm");
-        TFT_print_str(COL1, ROW2, "CO         : ");
-        TFT_print_str(COL3, ROW2, "(raw ADC)");
-        TFT_print_str(COL1, ROW3, "NH3        : ");
-        TFT_print_str(COL3, ROW3, "(raw ADC)");
-        TFT_print_str(COL1, ROW4, "NO2        : ");
-        TFT_print_str(COL3, ROW4, "(raw ADC)");
-        TFT_print_str(COL1, ROW5, "O2         : ");
-        TFT_print_str(COL3, ROW5, "(raw ADC)");
+        _CONTROLLER_display_layout(PSTR("MODULE: Gas"));
+        TFT_print_str_P(COL1, ROW1, PSTR("CO2        : "));
+        TFT_print_str_P(COL3, ROW1, PSTR("ppm"));
+        TFT_print_str_P(COL1, ROW2, PSTR("CO         : "));
+        TFT_print_str_P(COL3, ROW2, PSTR("(raw ADC)"));
+        TFT_print_str_P(COL1, ROW3, PSTR("NH3        : "));
+        TFT_print_str_P(COL3, ROW3, PSTR("(raw ADC)"));
+        TFT_print_str_P(COL1, ROW4, PSTR("NO2        : "));
+        TFT_print_str_P(COL3, ROW4, PSTR("(raw ADC)"));
+        TFT_print_str_P(COL1, ROW5, PSTR("O2         : "));
+        TFT_print_str_P(COL3, ROW5, PSTR("(raw ADC)"));
         BIT_write(g_ctrl_mode, _CONTROLLER_MODE_GAS, _CONTROLLER_MASK_MODE);
+        _CONTROLLER_render(_CONTROLLER_MODE_GAS);
     }
 }
 
@@ -195,7 +419,7 @@ void CONTROLLER_display_map(void)
     if (_CONTROLLER_MODE_MAP != BIT_read(g_ctrl_mode, _CONTROLLER_MASK_MODE))
     {
         TFT_fill_screen(RGB16_BLACK);
-        _CONTROLLER_display_layout("MODULE: LiDAR");
+        _CONTROLLER_display_layout(PSTR("MODULE: LiDAR"));
         BIT_write(g_ctrl_mode, _CONTROLLER_MODE_MAP, _CONTROLLER_MASK_MODE);
         // g_packet.lidar.line[0].row = 3;
         // g_packet.lidar.line[0].data[0] = 0xff;
@@ -212,8 +436,32 @@ void CONTROLLER_display_radioactivity(void)
     if (_CONTROLLER_MODE_GMC != BIT_read(g_ctrl_mode, _CONTROLLER_MASK_MODE))
     {
         TFT_fill_screen(RGB16_BLACK);
-        _CONTROLLER_display_layout("MODULE: Geiger Counter");
+        _CONTROLLER_display_layout(PSTR("MODULE: Geiger Counter"));
+        TFT_print_str_P(COL1, ROW1, PSTR("Count rate : "));
+        TFT_print_str_P(_CONTROLLER_GMC_COL_UNIT, ROW1, PSTR("CPM"));
+        TFT_print_str_P(COL1, ROW2, PSTR("Dose rate  : "));
+        TFT_print_str_P(_CONTROLLER_GMC_COL_UNIT, ROW2, PSTR("uSv/h"));
+        TFT_print_str_P(COL1, ROW3, PSTR("Avg 1 min  : "));
+        TFT_print_str_P(_CONTROLLER_GMC_COL_UNIT, ROW3, PSTR("CPM"));
+        TFT_print_str_P(COL1, ROW4, PSTR("Avg 10 min : "));
+        TFT_print_str_P(_CONTROLLER_GMC_COL_UNIT, ROW4, PSTR("CPM"));
+        TFT_print_str_P(COL1, ROW5, PSTR("Peak       : "));
+        TFT_print_str_P(_CONTROLLER_GMC_COL_UNIT, ROW5, PSTR("CPM"));
+        TFT_print_str_P(COL1, ROW6, PSTR("Total      : "));
+        TFT_fill_area(_CONTROLLER_GMC_CHART_X,
+                      _CONTROLLER_GMC_CHART_Y + _CONTROLLER_GMC_CHART_H,
+                      _CONTROLLER_GMC_BINS * _CONTROLLER_GMC_CHART_BAR, 1,
+                      RGB16_GRAY); // chart baseline
         BIT_write(g_ctrl_mode, _CONTROLLER_MODE_GMC, _CONTROLLER_MASK_MODE);
+        _CONTROLLER_render(_CONTROLLER_MODE_GMC);
+
+        for (byte_t slot = 0; slot < g_gmc.filled; ++slot)
+        {
+            if (slot != g_gmc.head)
+            {
+                _CONTROLLER_gmc_chart_bar(slot);
+            }
+        } // the open bin is left blank, as the sweep cursor
     }
 }
 
@@ -222,7 +470,7 @@ void CONTROLLER_display_none(void)
     if (0 != g_module_en)
     {
         TFT_fill_screen(RGB16_BLACK);
-        _CONTROLLER_display_layout("No Module detected");
+        _CONTROLLER_display_layout(PSTR("No Module detected"));
     }
 }
 
@@ -231,15 +479,16 @@ void CONTROLLER_display_none(void)
 //------------------------------------------------------------------------------
 void CONTROLLER_update_atmosphere(void)
 {
+    const packet_t *pkt = &g_store[_CONTROLLER_STORE(PACKET_ID_ATM)].packet;
     char *str;
 
-    str = UTIL_itoa_decimal(g_packet.atmosphere.temperature, 4);
+    str = UTIL_itoa_decimal(pkt->atmosphere.temperature, 4);
     TFT_print_str(COL2, ROW1, str);
 
-    str = UTIL_itoa_decimal(g_packet.atmosphere.humidity, 4);
+    str = UTIL_itoa_decimal(pkt->atmosphere.humidity, 4);
     TFT_print_str(COL2, ROW2, str);
 
-    str = UTIL_itoa_decimal(g_packet.atmosphere.pressure, 4);
+    str = UTIL_itoa_decimal(pkt->atmosphere.pressure, 4);
     TFT_print_str(COL2, ROW3, str);
 }
 
@@ -248,21 +497,22 @@ void CONTROLLER_update_atmosphere(void)
 //------------------------------------------------------------------------------
 void CONTROLLER_update_gas(void)
 {
+    const packet_t *pkt = &g_store[_CONTROLLER_STORE(PACKET_ID_GAS)].packet;
     char *str;
 
-    str = UTIL_itoa(g_packet.gas.co2, 4);
+    str = UTIL_itoa(pkt->gas.co2, 4);
     TFT_print_str(COL2, ROW1, str);
 
-    str = UTIL_itoa(g_packet.gas.co, 4);
+    str = UTIL_itoa(pkt->gas.co, 4);
     TFT_print_str(COL2, ROW2, str);
 
-    str = UTIL_itoa(g_packet.gas.nh3, 4);
+    str = UTIL_itoa(pkt->gas.nh3, 4);
     TFT_print_str(COL2, ROW3, str);
 
-    str = UTIL_itoa(g_packet.gas.no2, 4);
+    str = UTIL_itoa(pkt->gas.no2, 4);
     TFT_print_str(COL2, ROW4, str);
 
-    str = UTIL_itoa(g_packet.gas.o2, 4);
+    str = UTIL_itoa(pkt->gas.o2, 4);
     TFT_print_str(COL2, ROW5, str);
 }
 
@@ -270,6 +520,7 @@ void CONTROLLER_update_map(void)
 {
 #define LINE_SIZE 8
 #define LINE_OFFSET 64
+    const packet_t *pkt = &g_store[_CONTROLLER_STORE(PACKET_ID_LIDAR)].packet;
 
     for (uint16_t row = 0; row < LIDAR_DATA_PER_PACKET; ++row)
     {
@@ -277,10 +528,10 @@ void CONTROLLER_update_map(void)
         {
             for (length_t pos = 0; pos < LINE_SIZE; ++pos)
             {
-                if (BIT_read((g_packet.lidar.line[row]).data[col], BIT(pos)))
+                if (BIT_read((pkt->lidar.line[row]).data[col], BIT(pos)))
                 {
                     uint16_t x = (LINE_SIZE - 1 - pos) * _DISPLAY_W + LINE_OFFSET * col;
-                    uint16_t y = ((g_packet.lidar.line[row]).row * _DISPLAY_H) + ROW1;
+                    uint16_t y = ((pkt->lidar.line[row]).row * _DISPLAY_H) + ROW1;
                     TFT_fill_area(x, y, _DISPLAY_W, _DISPLAY_H, RGB16_WHITE);
                 }
             }
@@ -290,6 +541,24 @@ void CONTROLLER_update_map(void)
 
 void CONTROLLER_update_radioactivity(void)
 {
+    const packet_t *pkt = &g_store[_CONTROLLER_STORE(PACKET_ID_GMC)].packet;
+    uint16_t cpm_1 = _CONTROLLER_gmc_rate(_CONTROLLER_GMC_BIN_PER_MIN);
+    int32_t values[] = {
+        pkt->geiger.cpm,
+        (int32_t)(cpm_1 * 10000UL / CONTROLLER_GMC_TUBE), // uSv/h, 3 digits
+        cpm_1,
+        _CONTROLLER_gmc_rate(_CONTROLLER_GMC_BINS),
+        g_gmc.peak,
+        (int32_t)g_gmc.total};
+    char buf[FMT_BUFFER_SIZE];
+
+    for (byte_t i = 0; i < sizeof(values) / sizeof(*values); ++i)
+    {
+        length_t len = FMT_fixed(buf, values[i], (1 == i) ? 3 : 0);
+
+        FMT_justify(buf, len, _CONTROLLER_GMC_WIDTH);
+        TFT_print_str(COL2, _ROW_num(i + 1), buf);
+    }
 }
 
 //------------------------------------------------------------------------------
@@ -306,50 +575,29 @@ void CONTROLLER_update_connection(void)
 //------------------------------------------------------------------------------
 void CONTROLLER_read(void)
 {
-    bool_t signal = FALSE;
-
-    for (uint16_t r = 0; r < _CONTROLLER_RX_DELAY; ++r)
-    {
-        if (RADIO_read(g_packet.buffer, PACKET_SIZE))
-        {
-            signal = TRUE;
-            break;
-        } // has received a packet
-    }
-
-    if (TRUE == signal)
+    PROFILE_BEGIN(PROFILE_CONTROLLER_READ);
+    if (RADIO_read(g_packet.buffer, PACKET_SIZE))
     {
+        g_last_rx = TIMER_millis();
+        CONTROLLER_TRACE(module, g_packet.buffer);
         if (PACKET_ID_CAR == g_packet.header.id)
         {
             g_module_en = g_packet.header.module;
         }
-        else if (PACKET_ID_ATM == g_packet.header.id)
-        {
-            BIT_set(g_module_en, BIT(_CONTROLLER_MODE_ATM));
-            if (_CONTROLLER_MODE_ATM == BIT_read(g_ctrl_mode, _CONTROLLER_MASK_MODE))
-            {
-                CONTROLLER_update_atmosphere();
-            }
-        }
-        else if (PACKET_ID_GAS == g_packet.header.id)
-        {
-            BIT_set(g_module_en, BIT(_CONTROLLER_MODE_GAS));
-            if (_CONTROLLER_MODE_GAS == BIT_read(g_ctrl_mode, _CONTROLLER_MASK_MODE))
-            {
-                CONTROLLER_update_gas();
-            }
-        }
-        else if (PACKET_ID_GMC == g_packet.header.id)
+        else if ((PACKET_ID_ATM == g_packet.header.id) ||
+                 (PACKET_ID_GAS == g_packet.header.id) ||
+                 (PACKET_ID_GMC == g_packet.header.id))
         {
-            BIT_set(g_module_en, BIT(_CONTROLLER_MODE_GMC));
-            if (_CONTROLLER_MODE_GMC == BIT_read(g_ctrl_mode, _CONTROLLER_MASK_MODE))
+            if (PACKET_ID_GMC == g_packet.header.id)
             {
-                CONTROLLER_update_radioactivity();
-            }
+                _CONTROLLER_gmc_count();
+            } // before the previous total is replaced
+            _CONTROLLER_store(g_packet.header.id);
+            _CONTROLLER_render(g_packet.header.id);
         }
         else if (PACKET_ID_LIDAR == g_packet.header.id)
         {
-            BIT_set(g_module_en, BIT(_CONTROLLER_MODE_MAP));
+            _CONTROLLER_store(_CONTROLLER_MODE_MAP);
             if (_CONTROLLER_MODE_MAP == BIT_read(g_ctrl_mode, _CONTROLLER_MASK_MODE))
             {
                 CONTROLLER_display_map();
@@ -362,10 +610,12 @@ void CONTROLLER_read(void)
         _CONTROLLER_connect();
         CONTROLLER_DEBUG(str, "packet received\r\n");
     }
-    else
+    else if (TIMER_elapsed(g_last_rx) >= _CONTROLLER_RX_TIMEOUT)
     {
+        g_last_rx = TIMER_millis();
         _CONTROLLER_disconnect();
-    }
+    } // nothing received for a whole timeout
+    PROFILE_END(PROFILE_CONTROLLER_READ);
 }
 
 //------------------------------------------------------------------------------
@@ -373,16 +623,33 @@ void CONTROLLER_read(void)
 //------------------------------------------------------------------------------
 void CONTROLLER_write(void)
 {
-    uint16_t pot = _CONTROLLER_ADC_MAX - ANALOG_read(g_controller.pot);
+    uint16_t samples[_CONTROLLER_SCAN_COUNT];
 
-    int16_t joy_xl = _ADC_CONVERT_LX(ANALOG_read(g_controller.jleft.x));
-    int16_t joy_yl = _ADC_CONVERT_LY(ANALOG_read(g_controller.jleft.y));
+    if (!ADC_scan_read(samples))
+    {
+        return;
+    } // first scan not complete yet
+
+    uint16_t pot = _CONTROLLER_ADC_MAX - samples[_CONTROLLER_SCAN_POT];
+
+    int16_t joy_xl = JOYSTICK_axis_update(
+        &g_axis[_CONTROLLER_AXIS(_CONTROLLER_SCAN_LX)],
+        samples[_CONTROLLER_SCAN_LX]);
+    int16_t joy_yl = JOYSTICK_axis_update(
+        &g_axis[_CONTROLLER_AXIS(_CONTROLLER_SCAN_LY)],
+        samples[_CONTROLLER_SCAN_LY]);
     bool_t joy_bl = BUTTON_is_active(&(g_controller.jleft.button));
 
-    int16_t joy_xr = _ADC_CONVERT_RX(ANALOG_read(g_controller.jright.x));
-    int16_t joy_yr = _ADC_CONVERT_RY(ANALOG_read(g_controller.jright.y));
+    int16_t joy_xr = -JOYSTICK_axis_update(
+        &g_axis[_CONTROLLER_AXIS(_CONTROLLER_SCAN_RX)],
+        samples[_CONTROLLER_SCAN_RX]); // right stick is mounted reversed
+    int16_t joy_yr = -JOYSTICK_axis_update(
+        &g_axis[_CONTROLLER_AXIS(_CONTROLLER_SCAN_RY)],
+        samples[_CONTROLLER_SCAN_RY]);
     bool_t joy_br = BUTTON_is_active(&(g_controller.jright.button));
 
+    bool_t sent;
+
     if ((pot == g_packet_tx.car.pot) &&
         (joy_xl == g_packet_tx.car.lx) &&
         (joy_yl == g_packet_tx.car.ly) &&
@@ -391,34 +658,44 @@ void CONTROLLER_write(void)
         (joy_yr == g_packet_tx.car.ry) &&
         (joy_br == g_packet_tx.car.rb))
     {
-        return;
+        if (TIMER_elapsed(g_last_tx) < _CONTROLLER_KEEPALIVE)
+        {
+            return;
+        }
+        // keepalive: retransmit the frame still held in the TX FIFO
+        if (RADIO_can_resend())
+        {
+            sent = RADIO_resend();
+        }
+        else
+        {
+            sent = RADIO_write(g_packet_tx.buffer, PACKET_SIZE);
+        }
+    }
+    else
+    {
+        g_packet_tx.header.id = PACKET_ID_CAR;
+        g_packet_tx.car.pot = pot;
+        g_packet_tx.car.lx = joy_xl;
+        g_packet_tx.car.ly = joy_yl;
+        g_packet_tx.car.lb = joy_bl;
+        g_packet_tx.car.rx = joy_xr;
+        g_packet_tx.car.ry = joy_yr;
+        g_packet_tx.car.rb = joy_br;
+
+        CONTROLLER_DEBUGF("LX: %d; LY: %d; LB: %u\r\n"
+                          "RX: %d; RY: %d; RB: %u\r\n"
+                          "Potentiometer: %u\r\n--------\r\n",
+                          g_packet_tx.car.lx, g_packet_tx.car.ly,
+                          g_packet_tx.car.lb, g_packet_tx.car.rx,
+                          g_packet_tx.car.ry, g_packet_tx.car.rb,
+                          g_packet_tx.car.pot);
+
+        sent = RADIO_write(g_packet_tx.buffer, PACKET_SIZE);
     }
-    g_packet_tx.header.id = PACKET_ID_CAR;
-    g_packet_tx.car.pot = pot;
-    g_packet_tx.car.lx = joy_xl;
-    g_packet_tx.car.ly = joy_yl;
-    g_packet_tx.car.lb = joy_bl;
-    g_packet_tx.car.rx = joy_xr;
-    g_packet_tx.car.ry = joy_yr;
-    g_packet_tx.car.rb = joy_br;
-
-    CONTROLLER_DEBUG(str, "LX: ");
-    CONTROLLER_DEBUG(int, g_packet_tx.car.lx);
-    CONTROLLER_DEBUG(str, "; LY: ");
-    CONTROLLER_DEBUG(int, g_packet_tx.car.ly);
-    CONTROLLER_DEBUG(str, "; LB: ");
-    CONTROLLER_DEBUG(bool, g_packet_tx.car.lb);
-    CONTROLLER_DEBUG(str, "\r\nRX: ");
-    CONTROLLER_DEBUG(int, g_packet_tx.car.rx);
-    CONTROLLER_DEBUG(str, "; RY: ");
-    CONTROLLER_DEBUG(int, g_packet_tx.car.ry);
-    CONTROLLER_DEBUG(str, "; RB: ");
-    CONTROLLER_DEBUG(bool, g_packet_tx.car.rb);
-    CONTROLLER_DEBUG(str, "\r\nPotentiometer: ");
-    CONTROLLER_DEBUG(uint, g_packet_tx.car.pot);
-    CONTROLLER_DEBUG(str, "\r\n--------\r\n");
-
-    if (RADIO_write(g_packet_tx.buffer, PACKET_SIZE))
+    g_last_tx = TIMER_millis();
+
+    if (sent)
     {
         _CONTROLLER_connect();
         CONTROLLER_DEBUG(str, "send movement\r\n");
@@ -454,15 +731,396 @@ void _CONTROLLER_reset_connection(void)
     g_radio_status = 8;
 }
 
+//------------------------------------------------------------------------------
+// _CONTROLLER_adapt_link
+//------------------------------------------------------------------------------
+void _CONTROLLER_adapt_link(void)
+{
+    packet_t packet = {0};
+    radio_link_t link;
+
+    if (0 == g_radio_status)
+    {
+        if (RADIO_LINK_FALLBACK != RADIO_get_link())
+        {
+            RADIO_set_link(RADIO_LINK_FALLBACK);
+            CONTROLLER_DEBUG(str, "link lost, fallback profile\r\n");
+        }
+        return;
+    } // the car falls back on the same profile when its watchdog expires
+
+    link = RADIO_evaluate_link();
+    if (link == RADIO_get_link())
+    {
+        return;
+    }
+    packet.link.id = PACKET_ID_LINK;
+    packet.link.link = link;
+    if (RADIO_write(packet.buffer, PACKET_SIZE))
+    {
+        RADIO_set_link(link);
+        CONTROLLER_DEBUG(str, "link profile: ");
+        CONTROLLER_DEBUG(uint, link);
+        CONTROLLER_DEBUG(str, "\r\n");
+
+        // the control frame must be written again to be reused as keepalive
+        RADIO_write(g_packet_tx.buffer, PACKET_SIZE);
+    } // the car has acknowledged the switch
+}
+
+//------------------------------------------------------------------------------
+// _CONTROLLER_task_tx
+//------------------------------------------------------------------------------
+void _CONTROLLER_task_tx(void)
+{
+    if (BIT_is_set(g_ctrl_mode, _CONTROLLER_MODE_TX))
+    {
+        CONTROLLER_write();
+    }
+}
+
+//------------------------------------------------------------------------------
+// _CONTROLLER_task_rx
+//------------------------------------------------------------------------------
+void _CONTROLLER_task_rx(void)
+{
+    if (BIT_is_set(g_ctrl_mode, _CONTROLLER_MODE_RX))
+    {
+        CONTROLLER_read();
+    }
+}
+
+//------------------------------------------------------------------------------
+// _CONTROLLER_task_link
+//------------------------------------------------------------------------------
+void _CONTROLLER_task_link(void)
+{
+    _CONTROLLER_adapt_link();
+    CONTROLLER_update_connection();
+}
+
+//------------------------------------------------------------------------------
+// _CONTROLLER_store
+//------------------------------------------------------------------------------
+void _CONTROLLER_store(byte_t mode)
+{
+    _controller_store_t *entry = &g_store[_CONTROLLER_STORE(mode)];
+
+    BIT_set(g_module_en, BIT(mode));
+    memcpy(&(entry->packet), &g_packet, sizeof(packet_t));
+    entry->stamp = g_last_rx;
+    entry->flags = _CONTROLLER_STORE_VALID; // fresh again
+}
+
+//------------------------------------------------------------------------------
+// _CONTROLLER_render
+//------------------------------------------------------------------------------
+void _CONTROLLER_render(byte_t mode)
+{
+    const _controller_store_t *entry = &g_store[_CONTROLLER_STORE(mode)];
+
+    if ((mode != BIT_read(g_ctrl_mode, _CONTROLLER_MASK_MODE)) ||
+        BIT_is_clear(entry->flags, _CONTROLLER_STORE_VALID))
+    {
+        return;
+    } // not on screen, or nothing received yet
+
+    if (BIT_is_set(entry->flags, _CONTROLLER_STORE_STALE))
+    {
+        ILI9341_set_text_color(RGB16_GRAY);
+    }
+    switch (mode)
+    {
+    case _CONTROLLER_MODE_ATM:
+        CONTROLLER_update_atmosphere();
+        break;
+    case _CONTROLLER_MODE_GAS:
+        CONTROLLER_update_gas();
+        break;
+    case _CONTROLLER_MODE_GMC:
+        CONTROLLER_update_radioactivity();
+        break;
+    default:
+        break;
+    }
+    ILI9341_set_text_color(RGB16_WHITE);
+}
+
+//------------------------------------------------------------------------------
+// _CONTROLLER_check_stale
+//------------------------------------------------------------------------------
+void _CONTROLLER_check_stale(void)
+{
+    for (byte_t mode = PACKET_ID_ATM; mode <= PACKET_ID_GMC; ++mode)
+    {
+        _controller_store_t *entry = &g_store[_CONTROLLER_STORE(mode)];
+
+        if ((_CONTROLLER_STORE_VALID == entry->flags) &&
+            (TIMER_elapsed(entry->stamp) >= _CONTROLLER_STALE_AFTER))
+        {
+            BIT_set(entry->flags, _CONTROLLER_STORE_STALE);
+            _CONTROLLER_render(mode);
+        } // fresh until now
+    }
+}
+
+//------------------------------------------------------------------------------
+// _CONTROLLER_gmc_count
+//------------------------------------------------------------------------------
+void _CONTROLLER_gmc_count(void)
+{
+    const packet_t *prev = &g_store[_CONTROLLER_STORE(PACKET_ID_GMC)].packet;
+    uint16_t delta = g_packet.geiger.delta;
+
+    if (BIT_is_set(g_store[_CONTROLLER_STORE(PACKET_ID_GMC)].flags,
+                   _CONTROLLER_STORE_VALID) &&
+        (g_packet.geiger.total >= prev->geiger.total))
+    {
+        delta = g_packet.geiger.total - prev->geiger.total;
+    } // counts of the lost packets are kept, unless the module restarted
+
+    g_gmc.count = (0xFFFF - g_gmc.count < delta) ? 0xFFFF
+                                                 : g_gmc.count + delta;
+    g_gmc.total += delta;
+}
+
+//------------------------------------------------------------------------------
+// _CONTROLLER_gmc_rate
+//------------------------------------------------------------------------------
+uint16_t _CONTROLLER_gmc_rate(byte_t bins)
+{
+    uint32_t sum = 0;
+    byte_t slot = g_gmc.head;
+
+    if (bins > g_gmc.filled)
+    {
+        bins = g_gmc.filled;
+    }
+    if (0 == bins)
+    {
+        return (0);
+    }
+    for (byte_t i = 0; i < bins; ++i)
+    {
+        slot = (slot + _CONTROLLER_GMC_BINS - 1) % _CONTROLLER_GMC_BINS;
+        sum += g_gmc.bin[slot];
+    } // newest first
+
+    sum = sum * _CONTROLLER_GMC_BIN_PER_MIN / bins;
+    return ((0xFFFF < sum) ? 0xFFFF : (uint16_t)sum);
+}
+
+//------------------------------------------------------------------------------
+// _CONTROLLER_gmc_chart_bar
+//------------------------------------------------------------------------------
+void _CONTROLLER_gmc_chart_bar(byte_t slot)
+{
+    uint16_t x = _CONTROLLER_GMC_CHART_X + slot * _CONTROLLER_GMC_CHART_BAR;
+    uint32_t cpm = (uint32_t)g_gmc.bin[slot] * _CONTROLLER_GMC_BIN_PER_MIN;
+    uint16_t h = _CONTROLLER_GMC_CHART_H;
+    color16_t color = RGB16_RED; // clipped
+
+    if (cpm < _CONTROLLER_GMC_CHART_MAX)
+    {
+        h = (uint16_t)(cpm * _CONTROLLER_GMC_CHART_H /
+                       _CONTROLLER_GMC_CHART_MAX);
+        color = RGB16_GREEN;
+    }
+    TFT_fill_area(x, _CONTROLLER_GMC_CHART_Y, _CONTROLLER_GMC_CHART_BAR - 1,
+                  _CONTROLLER_GMC_CHART_H - h, RGB16_BLACK);
+    if (0 != h)
+    {
+        TFT_fill_area(x, _CONTROLLER_GMC_CHART_Y + _CONTROLLER_GMC_CHART_H - h,
+                      _CONTROLLER_GMC_CHART_BAR - 1, h, color);
+    }
+}
+
+//------------------------------------------------------------------------------
+// _CONTROLLER_task_gmc
+//------------------------------------------------------------------------------
+void _CONTROLLER_task_gmc(void)
+{
+    byte_t slot = g_gmc.head;
+    uint32_t cpm = (uint32_t)g_gmc.count * _CONTROLLER_GMC_BIN_PER_MIN;
+
+    g_gmc.bin[slot] = g_gmc.count; // 0 when no report came in the period
+    g_gmc.count = 0;
+    if (cpm > g_gmc.peak)
+    {
+        g_gmc.peak = (0xFFFF < cpm) ? 0xFFFF : (uint16_t)cpm;
+    }
+    g_gmc.head = (slot + 1) % _CONTROLLER_GMC_BINS;
+    if (g_gmc.filled < _CONTROLLER_GMC_BINS)
+    {
+        ++g_gmc.filled;
+    }
+
+    if (_CONTROLLER_MODE_GMC == BIT_read(g_ctrl_mode, _CONTROLLER_MASK_MODE))
+    {
+        _CONTROLLER_gmc_chart_bar(slot);
+        TFT_fill_area(_CONTROLLER_GMC_CHART_X +
+                          g_gmc.head * _CONTROLLER_GMC_CHART_BAR,
+                      _CONTROLLER_GMC_CHART_Y, _CONTROLLER_GMC_CHART_BAR - 1,
+                      _CONTROLLER_GMC_CHART_H, RGB16_BLACK); // sweep cursor
+        _CONTROLLER_render(_CONTROLLER_MODE_GMC);
+    } // only the new bin is drawn
+}
+
+//------------------------------------------------------------------------------
+// _CONTROLLER_task_ui
+//------------------------------------------------------------------------------
+void _CONTROLLER_task_ui(void)
+{
+    event_t ev;
+    bool_t toggled = FALSE;
+
+    while (EVENT_get(&ev))
+    {
+        switch (ev)
+        {
+        case _CONTROLLER_EVENT_TOGGLE:
+            toggled = TRUE; // a bouncing toggle posts a burst, read it once
+            break;
+        default:
+            break;
+        }
+    }
+    if (toggled)
+    {
+        _CONTROLLER_set_radio_mode();
+    }
+    if (BUTTON_is_active(&(g_controller.btn1)))
+    {
+        _CONTROLLER_switch_display();
+    } // press latched by the debouncing service, bounces never reach it
+    _CONTROLLER_check_stale();
+}
+
+//------------------------------------------------------------------------------
+// _CONTROLLER_task_sram
+//------------------------------------------------------------------------------
+void _CONTROLLER_task_sram(void)
+{
+    static bool_t warned = FALSE;
+
+    if (!warned && !SRAM_check(SRAM_WARNING_MARGIN))
+    {
+        warned = TRUE;
+        LED_on(g_controller.led);
+        CONTROLLER_DEBUGF("SRAM low: %u bytes free\r\n", SRAM_stack_free_min());
+    }
+}
+
+#if defined(VEMAR_PROFILE_ENABLED) && defined(VEMAR_DEBUG_ENABLED)
+//------------------------------------------------------------------------------
+// _CONTROLLER_task_profile
+//------------------------------------------------------------------------------
+void _CONTROLLER_task_profile(void)
+{
+    byte_t command;
+
+    while (UART_read(&command))
+    {
+        if ('p' == command)
+        {
+            PROFILE_report();
+        }
+        else if ('r' == command)
+        {
+            PROFILE_reset();
+        }
+    }
+}
+#endif
+
+//------------------------------------------------------------------------------
+// _CONTROLLER_load_calibration
+//------------------------------------------------------------------------------
+void _CONTROLLER_load_calibration(void)
+{
+    joystick_cal_t cal[_CONTROLLER_AXIS_COUNT];
+
+    if (!JOYSTICK_cal_load(cal, _CONTROLLER_AXIS_COUNT))
+    {
+        memcpy(cal, g_joystick_default, sizeof(cal));
+        CONTROLLER_DEBUG(str, "joystick: default calibration\r\n");
+    } // nothing valid in EEPROM
+    for (length_t i = 0; i < _CONTROLLER_AXIS_COUNT; ++i)
+    {
+        JOYSTICK_axis_init(&g_axis[i], &cal[i]);
+    }
+}
+
+//------------------------------------------------------------------------------
+// _CONTROLLER_calibrate
+//------------------------------------------------------------------------------
+void _CONTROLLER_calibrate(void)
+{
+    uint16_t samples[_CONTROLLER_SCAN_COUNT];
+    uint16_t sum[_CONTROLLER_AXIS_COUNT] = {0};
+    joystick_cal_t cal[_CONTROLLER_AXIS_COUNT];
+    byte_t scans;
+
+    TFT_fill_screen(RGB16_BLACK);
+    TFT_print_str_P(COL1, ROW1, PSTR("Joystick calibration"));
+    TFT_print_str_P(COL1, ROW3, PSTR("Release all the controls"));
+    WAIT_UNTIL(PIN_HIGH == PIN_read(PIN_BUTTON1));
+    delay(500); // let the sticks settle
+
+    for (length_t n = 0; n < _CONTROLLER_CAL_SAMPLES; ++n)
+    {
+        scans = ADC_scan_count();
+        WAIT_UNTIL(scans != ADC_scan_count()); // fresh set of samples
+        ADC_scan_read(samples);
+        for (length_t i = 0; i < _CONTROLLER_AXIS_COUNT; ++i)
+        {
+            sum[i] += samples[_CONTROLLER_SCAN_LX + i];
+        }
+    } // average the centres
+    for (length_t i = 0; i < _CONTROLLER_AXIS_COUNT; ++i)
+    {
+        JOYSTICK_cal_begin(&cal[i], sum[i] / _CONTROLLER_CAL_SAMPLES);
+    }
+
+    TFT_print_str_P(COL1, ROW4, PSTR("Move both sticks to every edge,"));
+    TFT_print_str_P(COL1, ROW5, PSTR("then press button 1"));
+    BUTTON_is_active(&(g_controller.btn1)); // discard a stale press
+    while (!BUTTON_is_active(&(g_controller.btn1)))
+    {
+        ADC_scan_read(samples);
+        for (length_t i = 0; i < _CONTROLLER_AXIS_COUNT; ++i)
+        {
+            JOYSTICK_cal_track(&cal[i], samples[_CONTROLLER_SCAN_LX + i]);
+        }
+    }
+
+    for (length_t i = 0; i < _CONTROLLER_AXIS_COUNT; ++i)
+    {
+        if (!JOYSTICK_cal_is_valid(&cal[i]))
+        {
+            TFT_print_str_P(COL1, ROW7, PSTR("Range too small, not saved"));
+            delay(2000);
+            return;
+        }
+    }
+    JOYSTICK_cal_save(cal, _CONTROLLER_AXIS_COUNT);
+    for (length_t i = 0; i < _CONTROLLER_AXIS_COUNT; ++i)
+    {
+        JOYSTICK_axis_init(&g_axis[i], &cal[i]);
+    }
+    TFT_print_str_P(COL1, ROW7, PSTR("Saved"));
+    delay(1000);
+}
+
 void CONTROLLER_display_menu(void)
 {
     if (0 != g_ctrl_mode)
     {
         TFT_fill_screen(RGB16_BLACK);
         TFT_setup_text(TFT_TEXT_XXL, 8, RGB16_WHITE, RGB16_BLACK);
-        TFT_print_str(60, 100, "VEMAR");
+        TFT_print_str_P(60, 100, PSTR("VEMAR"));
         TFT_setup_text(TFT_TEXT_S, 1, RGB16_WHITE, RGB16_BLACK);
-        TFT_print_str(COL1, ROW_LAST, "signal: ");
+        TFT_print_str_P(COL1, ROW_LAST, PSTR("signal: "));
         _CONTROLLER_display_module();
         g_ctrl_mode = 0;
     }
@@ -506,51 +1164,51 @@ void _CONTROLLER_display_module(void)
 
 void _CONTROLLER_display_layout(const char *label)
 {
-    TFT_print_str(COL1, ROW_LABEL, label);
+    TFT_print_str_P(COL1, ROW_LABEL, label);
     TFT_fill_area(0, ROW_LABEL + 14, TFT_HEIGHT, 2, RGB16_WHITE);
 
     _CONTROLLER_display_module();
 
     TFT_fill_area(0, ROW_LAST - 4, TFT_HEIGHT, 2, RGB16_WHITE);
-    TFT_print_str(COL1, ROW_LAST, "signal: ");
+    TFT_print_str_P(COL1, ROW_LAST, PSTR("signal: "));
 
     if (_CONTROLLER_MODE_RX == BIT_read(g_ctrl_mode, _CONTROLLER_MASK_RADIO))
     {
-        TFT_print_str(COL_RXTX, ROW_LAST, "Rx   ");
+        TFT_print_str_P(COL_RXTX, ROW_LAST, PSTR("Rx   "));
     }
     else if (_CONTROLLER_MODE_TX == BIT_read(g_ctrl_mode, _CONTROLLER_MASK_RADIO))
     {
-        TFT_print_str(COL_RXTX, ROW_LAST, "   Tx");
+        TFT_print_str_P(COL_RXTX, ROW_LAST, PSTR("   Tx"));
     }
     else
     {
-        TFT_print_str(COL_RXTX, ROW_LAST, "Rx/Tx");
+        TFT_print_str_P(COL_RXTX, ROW_LAST, PSTR("Rx/Tx"));
     }
 }
 
 void _CONTROLLER_set_radio_mode(void)
 {
     BIT_set(g_ctrl_mode, (_CONTROLLER_MODE_RX | _CONTROLLER_MODE_TX));
-    if (BIT_is_clear(PIND, BIT(PIND3)))
+    if (PIN_LOW == PIN_read(PIN_TOGGLE_UP))
     {
         BIT_clear(g_ctrl_mode, _CONTROLLER_MODE_RX);
     } // if TX enabled
-    if (BIT_is_clear(PIND, BIT(PIND4)))
+    if (PIN_LOW == PIN_read(PIN_TOGGLE_DOWN))
     {
         BIT_clear(g_ctrl_mode, _CONTROLLER_MODE_TX);
     } // if RX enabled
 
     if (_CONTROLLER_MODE_RX == BIT_read(g_ctrl_mode, _CONTROLLER_MASK_RADIO))
     {
-        TFT_print_str(COL_RXTX, ROW_LAST, "Rx   ");
+        TFT_print_str_P(COL_RXTX, ROW_LAST, PSTR("Rx   "));
     }
     else if (_CONTROLLER_MODE_TX == BIT_read(g_ctrl_mode, _CONTROLLER_MASK_RADIO))
     {
-        TFT_print_str(COL_RXTX, ROW_LAST, "   Tx");
+        TFT_print_str_P(COL_RXTX, ROW_LAST, PSTR("   Tx"));
     }
     else
     {
-        TFT_print_str(COL_RXTX, ROW_LAST, "Rx/Tx");
+        TFT_print_str_P(COL_RXTX, ROW_LAST, PSTR("Rx/Tx"));
     }
 }
 
@@ -594,11 +1252,6 @@ void _CONTROLLER_switch_display(void)
 
 ISR(PCINT1_vect)
 {
-    if (BIT_is_clear(PINC, BIT(PINC0)))
-    {
-        _CONTROLLER_switch_display();
-    } // PC0 interrupt
-
     if (BIT_is_clear(PINC, BIT(PINC1)))
     {
         // Nothing to do
@@ -607,5 +1260,5 @@ ISR(PCINT1_vect)
 
 ISR(PCINT2_vect)
 {
-    _CONTROLLER_set_radio_mode();
+    EVENT_post(_CONTROLLER_EVENT_TOGGLE);
 }
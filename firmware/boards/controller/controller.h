@@ -3,20 +3,50 @@
 
 #include <joystick.h>
 #include <tft.h>
+#include <timer.h>
+#include <scheduler.h>
+#include <profile.h>
+#include <sram.h>
+#include <event.h>
 #include <radio.h>
 #include <util.h>
+#include <fmt.h>
 #include <util/packet.h>
 
+#if defined(ILI9341_SPI_UART) && defined(VEMAR_DEBUG_ENABLED)
+#error "USART0 drives the display, serial debug is not available"
+#endif
+
 #ifdef VEMAR_DEBUG_ENABLED
 #include "serial.h"
 #define CONTROLLER_DEBUG(_type, ...) \
-    SERIAL_print(_type, __VA_ARGS__)
+    SERIAL_print_P(_type, __VA_ARGS__)
+#define CONTROLLER_DEBUGF(_fmt, ...) \
+    SERIAL_printf_P(PSTR(_fmt), __VA_ARGS__)
 #else
 #define CONTROLLER_DEBUG(_type, ...)
+#define CONTROLLER_DEBUGF(_fmt, ...)
+#endif
+
+#ifdef VEMAR_TRACE_ENABLED
+#if defined(ILI9341_SPI_UART) || defined(VEMAR_DEBUG_ENABLED)
+#error "The telemetry stream needs USART0 to itself"
+#endif
+#include <trace.h>
+#define CONTROLLER_TRACE(_type, ...) TRACE_##_type(__VA_ARGS__)
+#else
+#define CONTROLLER_TRACE(_type, ...)
 #endif
 
 #define PIN_TOGGLE_UP PIN_PD3
+#define PCINT_TOGGLE_UP PCINT19
+#ifdef ILI9341_SPI_UART
+#define PIN_TOGGLE_DOWN PIN_PD0 /**< PD4 is XCK0, clock of the display */
+#define PCINT_TOGGLE_DOWN PCINT16
+#else
 #define PIN_TOGGLE_DOWN PIN_PD4
+#define PCINT_TOGGLE_DOWN PCINT20
+#endif
 #define PIN_BUTTON1 PIN_PC0
 #define PIN_BUTTON2 PIN_PC1
 #define PIN_POTENTIOMETER ADC_CH3
@@ -34,7 +64,20 @@
 #define PIN_TFT_DC PIN_PB0
 #define PIN_TFT_RST PIN_PB1
 
-#define _ROW_num(x) (18U * x + 6U)
+/**
+ * @brief Counts per minute giving 1 uSv/h, in tenths, for common tubes
+ */
+#define CONTROLLER_GMC_TUBE_J305 1231UL
+#define CONTROLLER_GMC_TUBE_SBM20 1754UL
+
+/**
+ * @brief Tube of the Geiger counter module
+ */
+#ifndef CONTROLLER_GMC_TUBE
+#define CONTROLLER_GMC_TUBE CONTROLLER_GMC_TUBE_J305
+#endif // CONTROLLER_GMC_TUBE
+
+#define _ROW_num(x) (18U * (x) + 6U)
 
 #define COL1 4U
 #define COL2 140U
@@ -115,6 +158,9 @@ void CONTROLLER_update_atmosphere(void);
 
 void CONTROLLER_update_gas(void);
 
+/**
+ * @brief Update the count rates and dose rate on the display
+ */
 void CONTROLLER_update_radioactivity(void);
 
 /**
@@ -131,6 +131,9 @@ static uint16_t adc_read(uint8_t muxpos) {
 
 // ─── I2C slave ───────────────────────────────────────────────────────────────
 
+// The TWI holds SCL low from the address or data interrupt until SCTRLB is
+// written: a master at 400 kHz waits for this handler instead of sampling a
+// byte not loaded yet. Keep it short, every cycle here stretches the bus.
 ISR(TWI0_TWIS_vect) {
     if (TWI0.SSTATUS & TWI_APIF_bm) {
         // Address or stop condition from master
@@ -1,11 +1,42 @@
+#include <string.h>
 #include <radio.h>
 #include <i2c.h>
+#include <timer.h>
+#include <scheduler.h>
+#include <profile.h>
+#include <sram.h>
 #include <util/packet.h>
 #include "motor.h"
 
 #define PIN_RADIO_CE PIN_PD2
 #define PIN_RADIO_CSN PIN_PD3
 
+/**
+ * @brief Milliseconds without control frame before the motors are stopped,
+ * must stay above the keepalive interval of the controller
+ */
+#define CAR_WATCHDOG_TIMEOUT 250U
+
+/**
+ * @brief Milliseconds between two sensor readings
+ */
+#define CAR_SENSOR_PERIOD 500U
+
+/**
+ * @brief Milliseconds between two polls of the radio
+ */
+#define CAR_CONTROL_PERIOD 5U
+
+/**
+ * @brief Milliseconds between two checks of the free SRAM
+ */
+#define CAR_SRAM_PERIOD 1000U
+
+/**
+ * @brief Milliseconds between two profile reports
+ */
+#define CAR_PROFILE_PERIOD 1000U
+
 /**
  * @brief Combine 2 bytes into 16-bit value
  * @param _high High byte
@@ -13,17 +44,45 @@
  */
 #define U8HL_TO_U16BIT(_high, _low) ((uint16_t)((_high) << 8) | (_low))
 
+#if defined(VEMAR_DEBUG_ENABLED) && defined(VEMAR_TRACE_ENABLED)
+#error "VEMAR_DEBUG_ENABLED and VEMAR_TRACE_ENABLED both use the UART"
+#endif
+
 #ifdef VEMAR_DEBUG_ENABLED
 #include <serial.h>
-#define VEMAR_DEBUG(_type, ...) SERIAL_print(_type, __VA_ARGS__)
+#define VEMAR_DEBUG(_type, ...) SERIAL_print_P(_type, __VA_ARGS__)
+#define VEMAR_DEBUGF(_fmt, ...) SERIAL_printf_P(PSTR(_fmt), __VA_ARGS__)
 #else
 #define VEMAR_DEBUG(_type, ...)
+#define VEMAR_DEBUGF(_fmt, ...)
+#endif
+
+#ifdef VEMAR_TRACE_ENABLED
+#include <trace.h>
+#define VEMAR_TRACE(_type, ...) TRACE_##_type(__VA_ARGS__)
+#else
+#define VEMAR_TRACE(_type, ...)
 #endif
 
 packet_t g_packet;
+uint8_t g_gas_buffer[I2C_BUFFER_SIZE];
+/**
+ * @brief Gas module packet, read by the TWI interrupt while the loop runs
+ */
+i2c_xfer_t g_gas_read = {.addr = GAS_ADDRESS,
+                         .rx = g_gas_buffer,
+                         .rx_len = sizeof(g_gas_buffer),
+                         .flags = I2C_XFER_PACKET};
 uint8_t g_module_en;
+uint32_t g_watchdog; /**< Time of the last control frame, in milliseconds */
+uint8_t g_failsafe;  /**< Motors stopped until the next control frame */
 
+void CAR_task_control(void);
+void CAR_task_sensors(void);
+void CAR_task_sram(void);
+void CAR_task_profile(void);
 void CAR_handle_movement(void);
+void CAR_failsafe(void);
 void CAR_read_atmosphere(void);
 void CAR_read_gas(void);
 
@@ -41,62 +100,139 @@ void setup(void)
 {
 #ifdef VEMAR_DEBUG_ENABLED
     SERIAL_init();
+#endif
+#ifdef VEMAR_TRACE_ENABLED
+    TRACE_init();
 #endif
     RADIO_init(PIN_RADIO_CE, PIN_RADIO_CSN);
 	motor_init();
+    i2c_init();
+    i2c_set_speed(GAS_ADDRESS, I2C_FAST); // TWI slave of a tinyAVR, stretches
+    TIMER_tick_init_timer0(); // shares Timer0 with the left motor PWM
+    sei();
+
+    SCHED_every(CAR_task_control, CAR_CONTROL_PERIOD, SCHED_PRIO_HIGH);
+    SCHED_every(CAR_task_sensors, CAR_SENSOR_PERIOD, SCHED_PRIO_LOW);
+    SCHED_every(CAR_task_sram, CAR_SRAM_PERIOD, SCHED_PRIO_LOW);
+#ifdef VEMAR_PROFILE_ENABLED
+    PROFILE_init();
+    SCHED_every(CAR_task_profile, CAR_PROFILE_PERIOD, SCHED_PRIO_LOW);
+#endif
 }
 
 void loop(void)
 {
-    static uint32_t count = 0;
-    static uint8_t data_type = 0;
+    PROFILE_BEGIN(PROFILE_LOOP);
+    SCHED_dispatch();
+    PROFILE_END(PROFILE_LOOP);
+}
 
+void CAR_task_control(void)
+{
     if (RADIO_read(g_packet.buffer, PACKET_SIZE))
     {
         if (PACKET_ID_CAR == g_packet.header.id)
         {
+            g_watchdog = TIMER_millis();
+            g_failsafe = 0;
             CAR_handle_movement();
         }
+        else if (PACKET_ID_LINK == g_packet.header.id)
+        {
+            g_watchdog = TIMER_millis();
+            g_failsafe = 0;
+            RADIO_set_link(g_packet.link.link);
+        } // switch in lockstep with the controller
     }
-    if (++count > 10000)
+    if (!g_failsafe && (TIMER_elapsed(g_watchdog) >= CAR_WATCHDOG_TIMEOUT))
     {
-        count = 0;
-        if (0 == data_type)
+        g_failsafe = 1;
+        CAR_failsafe();
+    } // neither control frame nor keepalive received
+}
+
+void CAR_task_sensors(void)
+{
+    static uint8_t data_type = 0;
+
+    if (0 == data_type)
+    {
+        CAR_read_atmosphere();
+        i2c_submit(&g_gas_read); // on the bus until the next run
+        data_type = 1;
+    }
+    else
+    {
+        CAR_read_gas();
+        data_type = 0;
+    }
+}
+
+void CAR_task_sram(void)
+{
+    static bool_t warned = FALSE;
+    sram_usage_t usage;
+
+    if (!warned && !SRAM_check(SRAM_WARNING_MARGIN))
+    {
+        warned = TRUE;
+        SRAM_get_usage(&usage);
+        VEMAR_DEBUGF("SRAM low: %u bytes free\r\n", usage.stack_free_min);
+        VEMAR_TRACE(sram, usage.stack_free_min, usage.stack_free, usage.heap);
+    } // reported once, the low-water mark never goes back up
+}
+
+#ifdef VEMAR_PROFILE_ENABLED
+void CAR_task_profile(void)
+{
+#ifdef VEMAR_TRACE_ENABLED
+    PROFILE_report_trace();
+#elif defined(VEMAR_DEBUG_ENABLED)
+    uint8_t command;
+
+    while (UART_read(&command))
+    {
+        if ('p' == command)
         {
-            CAR_read_atmosphere();
-            data_type = 1;
+            PROFILE_report();
         }
-        else
+        else if ('r' == command)
         {
-            CAR_read_gas();
-            data_type = 0;
+            PROFILE_reset();
         }
     }
+#endif
 }
+#endif
 
 void CAR_handle_movement(void)
 {
     /** @todo handle car movement */
 
-    VEMAR_DEBUG(str, "-- from controller\r\n");
-    VEMAR_DEBUG(str, "LX: ");
-    VEMAR_DEBUG(int, g_packet.car.lx);
-    VEMAR_DEBUG(str, "; LY: ");
-    VEMAR_DEBUG(int, g_packet.car.ly);
-    VEMAR_DEBUG(str, "; LB: ");
-    VEMAR_DEBUG(bool, g_packet.car.lb);
-    VEMAR_DEBUG(str, "\r\nRX: ");
-    VEMAR_DEBUG(int, g_packet.car.rx);
-    VEMAR_DEBUG(str, "; RY: ");
-    VEMAR_DEBUG(int, g_packet.car.ry);
-    VEMAR_DEBUG(str, "; RB: ");
-    VEMAR_DEBUG(bool, g_packet.car.rb);
-    VEMAR_DEBUG(str, "\r\nPotentiometer: ");
-    VEMAR_DEBUG(uint, g_packet.car.pot);
-    VEMAR_DEBUG(str, "\r\n--------\r\n");
+    VEMAR_DEBUGF("-- from controller\r\n"
+                 "LX: %d; LY: %d; LB: %u\r\n"
+                 "RX: %d; RY: %d; RB: %u\r\n"
+                 "Potentiometer: %u\r\n--------\r\n",
+                 g_packet.car.lx, g_packet.car.ly, g_packet.car.lb,
+                 g_packet.car.rx, g_packet.car.ry, g_packet.car.rb,
+                 g_packet.car.pot);
+    VEMAR_TRACE(packet, g_packet.buffer);
 
 	motor_left_set(g_packet.car.ly);
 	motor_right_set(g_packet.car.ry);
+    VEMAR_TRACE(motor, g_packet.car.ly, g_packet.car.ry);
+}
+
+void CAR_failsafe(void)
+{
+    VEMAR_DEBUG(str, "link lost, motors stopped\r\n");
+
+    motor_left_set(0);
+    motor_right_set(0);
+    VEMAR_TRACE(motor, 0, 0);
+
+    // the controller falls back on the same profile once the link is lost
+    RADIO_set_link(RADIO_LINK_FALLBACK);
 }
 
 void CAR_read_atmosphere(void)
@@ -114,15 +250,10 @@ void CAR_read_atmosphere(void)
 
     if (RADIO_write(g_packet.buffer, PACKET_SIZE))
     {
-        VEMAR_DEBUG(str, "ID: ");
-        VEMAR_DEBUG(int, g_packet.header.id);
-        VEMAR_DEBUG(str, "; n: ");
-        VEMAR_DEBUG(int, g_packet.atmosphere.pressure);
-        VEMAR_DEBUG(str, "; t: ");
-        VEMAR_DEBUG(int, g_packet.atmosphere.temperature);
-        VEMAR_DEBUG(str, "; h: ");
-        VEMAR_DEBUG(int, g_packet.atmosphere.humidity);
-        VEMAR_DEBUG(str, "\r\n----------\r\n");
+        VEMAR_DEBUGF("ID: %d; n: %d; t: %d; h: %d\r\n----------\r\n",
+                     g_packet.header.id, g_packet.atmosphere.pressure,
+                     g_packet.atmosphere.temperature,
+                     g_packet.atmosphere.humidity);
 
         t = (t + 12) % 1000;
         h = (h * 2 + 1) % 1000;
@@ -132,10 +263,19 @@ void CAR_read_atmosphere(void)
 
 void CAR_read_gas(void)
 {
-    uint8_t buffer[I2C_BUFFER_SIZE] = {0};
-    if (i2c_read_packet(GAS_ADDRESS, buffer))
+    const uint8_t *buffer = g_gas_buffer;
+    int8_t error = g_gas_read.status;
+
+    if (I2C_PENDING == error)
+    {
+        i2c_abort();
+        error = I2C_ERR_TIMEOUT;
+    } // a whole sensor period: the module holds the bus
+    if (error)
     {
         VEMAR_DEBUG(str, "I2C error\r\n");
+        VEMAR_TRACE(i2c_error, GAS_ADDRESS, error);
+        memset(g_gas_buffer, 0, sizeof(g_gas_buffer));
         // return;
     }
     g_packet.header.id = PACKET_ID_GAS;
@@ -151,44 +291,30 @@ void CAR_read_gas(void)
     {
         VEMAR_DEBUG(str, "gas transmission failed\r\n");
     }
-
-#ifdef VEMAR_DEBUG_ENABLED
     else
     {
         if (BIT_is_set(g_packet.gas.status, STATUS_CO2_PREHEATING))
         {
-            SERIAL_println(str, "[CO2 sensor preheating - < 60s uptime]");
+            VEMAR_DEBUG(str, "[CO2 sensor preheating - < 60s uptime]\r\n");
         }
-        SERIAL_print(str, "CO2: ");
-        SERIAL_print(uint, g_packet.gas.co2);
-        SERIAL_println(str, (g_packet.gas.status & STATUS_CO2_VALID)
-                                ? " ppm (CRC ok)"
-                                : " ppm (CRC pending)");
-        SERIAL_print(str, "CO2 status byte: 0x");
-        SERIAL_println(hex, g_packet.gas.status, 2);
-        SERIAL_print(str, "CO2 UART rx_seen=");
-        SERIAL_print(bool, g_packet.gas.status &STATUS_CO2_RX_SEEN);
-        SERIAL_print(str, ", frame_seen=");
-        SERIAL_print(bool, g_packet.gas.status &STATUS_CO2_FRAME_SEEN);
-        SERIAL_print(str, ", uart_err=");
-        SERIAL_print(bool, g_packet.gas.status &STATUS_CO2_UART_ERR);
-        SERIAL_print(str, ", rx_edge=");
-        SERIAL_print(bool, g_packet.gas.status &STATUS_CO2_RX_EDGE);
-        SERIAL_print(str, ", cmd_send=");
-        SERIAL_println(bool, g_packet.gas.status &STATUS_CO2_CMD_SENT);
-        SERIAL_print(str, "Temp(CO2 sensor): ");
-        SERIAL_println(int, g_packet.gas.temp);
-        SERIAL_print(str, "CO:  ");
-        SERIAL_println(uint, g_packet.gas.co);
-        SERIAL_print(str, "NH3: ");
-        SERIAL_println(uint, g_packet.gas.nh3);
-        SERIAL_print(str, "NO2: ");
-        SERIAL_println(uint, g_packet.gas.no2);
-        SERIAL_print(str, "O2:  ");
-        SERIAL_println(uint, g_packet.gas.o2);
-        SERIAL_println(str, "---");
+        VEMAR_DEBUGF("CO2: %u ppm (CRC %S)\r\n"
+                     "CO2 status byte: 0x%02X\r\n",
+                     g_packet.gas.co2,
+                     (g_packet.gas.status & STATUS_CO2_VALID) ? PSTR("ok")
+                                                              : PSTR("pending"),
+                     g_packet.gas.status);
+        VEMAR_DEBUGF("CO2 UART rx_seen=%u, frame_seen=%u, uart_err=%u, "
+                     "rx_edge=%u, cmd_send=%u\r\n",
+                     !!(g_packet.gas.status & STATUS_CO2_RX_SEEN),
+                     !!(g_packet.gas.status & STATUS_CO2_FRAME_SEEN),
+                     !!(g_packet.gas.status & STATUS_CO2_UART_ERR),
+                     !!(g_packet.gas.status & STATUS_CO2_RX_EDGE),
+                     !!(g_packet.gas.status & STATUS_CO2_CMD_SENT));
+        VEMAR_DEBUGF("Temp(CO2 sensor): %d\r\n"
+                     "CO:  %u\r\nNH3: %u\r\nNO2: %u\r\nO2:  %u\r\n---\r\n",
+                     g_packet.gas.temp, g_packet.gas.co, g_packet.gas.nh3,
+                     g_packet.gas.no2, g_packet.gas.o2);
     }
-#endif
 }
 
 
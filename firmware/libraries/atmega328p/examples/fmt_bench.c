@@ -0,0 +1,112 @@
+//------------------------------------------------------------------------------
+// fmt_bench.c
+//
+// Compare the cycle count of the number formatting functions with the former
+// division-based conversions
+//
+// Requirements:
+// - Use `screen` to read the results, in CPU cycles per conversion
+//------------------------------------------------------------------------------
+
+#include "serial.h"
+#include "timer.h"
+#include "util.h"
+#include "fmt.h"
+
+#define BASE_STRING "0123456789ABCDEF"
+
+char buffer[FMT_BUFFER_SIZE];
+length_t pos;
+
+const unsigned long samples[] = {0UL, 7UL, 1234UL, 65535UL, 4294967295UL};
+
+// former recursive SERIAL_print_base, writing into the buffer
+void base_recursive(unsigned long nbr, byte_t radix, byte_t len)
+{
+    if ((0 == nbr) && (1 == len))
+    {
+        buffer[pos++] = BASE_STRING[0];
+        return;
+    }
+    byte_t digit = (nbr % radix);
+    nbr /= radix;
+    if (1 < len)
+    {
+        base_recursive(nbr, radix, len - 1);
+    }
+    else if (0 < nbr)
+    {
+        base_recursive(nbr, radix, len);
+    }
+    buffer[pos++] = BASE_STRING[digit];
+}
+
+// former UTIL_itoa loop, one 16-bit division and modulo per digit
+void itoa_divide(int n)
+{
+    pos = 0;
+    if (0 > n)
+    {
+        n = -n;
+    }
+    do
+    {
+        buffer[pos++] = (char)(n % 10) + '0';
+        n /= 10;
+    } while (0 != n);
+}
+
+void report(const char *name, unsigned long value, uint16_t before,
+            uint16_t after)
+{
+    SERIAL_print(str, name);
+    SERIAL_print(ulong, value);
+    SERIAL_print(str, ": ");
+    SERIAL_println(uint, after - before);
+}
+
+void setup(void)
+{
+    SERIAL_init();
+    TIMER1_init(TIMER1_NORMA, TIMER1_PS1); // count CPU cycles
+}
+
+void loop(void)
+{
+    uint16_t start;
+    uint16_t stop;
+
+    for (byte_t i = 0; i < sizeof(samples) / sizeof(samples[0]); ++i)
+    {
+        unsigned long n = samples[i];
+
+        start = TCNT1;
+        pos = 0;
+        base_recursive(n, 10, 1);
+        stop = TCNT1;
+        report("recursive u32 ", n, start, stop);
+
+        start = TCNT1;
+        FMT_u32(buffer, n);
+        stop = TCNT1;
+        report("FMT_u32       ", n, start, stop);
+
+        start = TCNT1;
+        itoa_divide((int)(n & 0x7FFF));
+        stop = TCNT1;
+        report("divide i16    ", n & 0x7FFF, start, stop);
+
+        start = TCNT1;
+        FMT_i16(buffer, (int16_t)(n & 0x7FFF));
+        stop = TCNT1;
+        report("FMT_i16       ", n & 0x7FFF, start, stop);
+
+        start = TCNT1;
+        FMT_fixed(buffer, (int32_t)n, 2);
+        stop = TCNT1;
+        report("FMT_fixed     ", n, start, stop);
+    }
+    SERIAL_println(str, "--------");
+    UART_drain();
+    delay(5000);
+}
@@ -0,0 +1,415 @@
+//------------------------------------------------------------------------------
+// bench.c
+//
+// Microbenchmarks of the library logic, built for the host
+//
+// Usage: libvemar_bench [name...]
+//
+// Columns:
+// - ns/op: host time, only meaningful between two runs on the same machine
+// - io/op: register accesses, the same on the target
+// - bus/op: bytes on the SPI or UART bus
+// - check: hash of the results, changes when the behaviour does
+//------------------------------------------------------------------------------
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include <avr/pgmspace.h>
+#include <host_io.h>
+#include <util/packet.h>
+
+#include "bme.h"
+#include "fmt.h"
+#include "i2c.h"
+#include "sd.h"
+#include "sdcard.h"
+#include "serial.h"
+#include "util.h"
+
+#define BENCH_FNV_OFFSET 2166136261UL
+#define BENCH_FNV_PRIME 16777619UL
+
+#define BENCH_SD_CS BIT(PB1) /**< Chip Select of the card, on PORTB */
+
+typedef struct
+{
+    const char *name;
+    int (*setup)(void);        /**< Returns `0` if the benchmark cannot run */
+    void (*run)(uint32_t i);  /**< One operation */
+    uint32_t ops;
+} bench_t;
+
+static uint32_t g_check;
+static uint32_t g_bus;
+
+static const int16_t g_values[] = {0, 7, -42, 1234, -32768, 32767, 100, -9};
+
+#define BENCH_VALUES (sizeof(g_values) / sizeof(g_values[0]))
+
+//------------------------------------------------------------------------------
+// Helpers
+//------------------------------------------------------------------------------
+static void _BENCH_fold(const void *data, size_t len)
+{
+    const uint8_t *p = data;
+
+    for (size_t i = 0; i < len; ++i)
+    {
+        g_check = (g_check ^ p[i]) * BENCH_FNV_PRIME;
+    }
+}
+
+static void _BENCH_fold_str(const char *str)
+{
+    _BENCH_fold(str, strlen(str));
+}
+
+static void _BENCH_uart(uint8_t data)
+{
+    ++g_bus;
+    _BENCH_fold(&data, 1);
+}
+
+static uint8_t _BENCH_spi(uint8_t data)
+{
+    ++g_bus;
+    return (SDCARD_exchange(data));
+}
+
+static uint64_t _BENCH_now_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec);
+}
+
+static int _BENCH_no_setup(void)
+{
+    return (1);
+}
+
+//------------------------------------------------------------------------------
+// Number formatting
+//------------------------------------------------------------------------------
+static void _BENCH_itoa(uint32_t i)
+{
+    _BENCH_fold_str(UTIL_itoa(g_values[i % BENCH_VALUES], 6));
+}
+
+static void _BENCH_itoa_decimal(uint32_t i)
+{
+    _BENCH_fold_str(UTIL_itoa_decimal(g_values[i % BENCH_VALUES], 7));
+}
+
+static void _BENCH_fmt_u32(uint32_t i)
+{
+    char buf[FMT_BUFFER_SIZE];
+
+    _BENCH_fold(buf, FMT_u32(buf, i * 2654435761UL));
+}
+
+static void _BENCH_fmt_fixed(uint32_t i)
+{
+    char buf[FMT_BUFFER_SIZE];
+
+    _BENCH_fold(buf, FMT_fixed(buf, (int32_t)g_values[i % BENCH_VALUES] * 37,
+                               2));
+}
+
+//------------------------------------------------------------------------------
+// Serial output, through the UART registers
+//------------------------------------------------------------------------------
+static int _BENCH_serial_setup(void)
+{
+    HOST_uart_hook(_BENCH_uart);
+    SERIAL_init();
+    return (1);
+}
+
+static void _BENCH_serial_ulong(uint32_t i)
+{
+    SERIAL_println(ulong, i * 2654435761UL);
+}
+
+static void _BENCH_serial_printf(uint32_t i)
+{
+    int16_t value = g_values[i % BENCH_VALUES];
+
+    SERIAL_printf_P(PSTR("t=%d h=%05u p=%lu\r\n"), value, (uint16_t)i,
+                    (uint32_t)i * 7UL);
+}
+
+//------------------------------------------------------------------------------
+// Packet encoding, as the car forwards the gas module
+//------------------------------------------------------------------------------
+static void _BENCH_packet_gas(uint32_t i)
+{
+    uint8_t buffer[GAS_SIZE];
+    packet_t packet;
+
+    for (uint8_t k = 0; k < GAS_SIZE; ++k)
+    {
+        buffer[k] = (uint8_t)(i + k * 31);
+    }
+    memset(&packet, 0, sizeof(packet));
+    packet.header.id = PACKET_ID_GAS;
+    packet.gas.co2 = (uint16_t)((buffer[IDX_CO2] << 8) | buffer[IDX_CO2 + 1]);
+    packet.gas.co = (uint16_t)((buffer[IDX_CO] << 8) | buffer[IDX_CO + 1]);
+    packet.gas.nh3 = (uint16_t)((buffer[IDX_NH3] << 8) | buffer[IDX_NH3 + 1]);
+    packet.gas.no2 = (uint16_t)((buffer[IDX_NO2] << 8) | buffer[IDX_NO2 + 1]);
+    packet.gas.o2 = (uint16_t)((buffer[IDX_O2] << 8) | buffer[IDX_O2 + 1]);
+    packet.gas.temp = (int8_t)((int8_t)buffer[IDX_TEMP] - CO2_TEMP_OFFSET);
+    packet.gas.status = buffer[IDX_STATUS];
+    _BENCH_fold(packet.buffer, PACKET_SIZE);
+}
+
+//------------------------------------------------------------------------------
+// Gas module packet on the TWI bus, blocking and queued
+//------------------------------------------------------------------------------
+static uint8_t g_gas_frame[2 + GAS_SIZE] = {0x00, GAS_SIZE};
+static uint8_t g_gas_index;
+static uint8_t g_gas_buffer[I2C_BUFFER_SIZE];
+static i2c_xfer_t g_gas_xfer = {
+    .addr = GAS_ADDRESS,
+    .rx = g_gas_buffer,
+    .rx_len = sizeof(g_gas_buffer),
+    .flags = I2C_XFER_PACKET,
+};
+
+static int _BENCH_gas_start(uint8_t addr_rw)
+{
+    g_gas_index = 0;
+    return (GAS_ADDRESS == (addr_rw >> 1));
+}
+
+static uint8_t _BENCH_gas_read(int ack)
+{
+    (void)ack;
+    ++g_bus;
+    return ((sizeof(g_gas_frame) > g_gas_index) ? g_gas_frame[g_gas_index++]
+                                                : 0xFF);
+}
+
+static const host_twi_t g_gas_twi = {
+    .start = _BENCH_gas_start,
+    .read = _BENCH_gas_read,
+};
+
+static int _BENCH_i2c_setup(void)
+{
+    for (uint8_t k = 2; k < sizeof(g_gas_frame); ++k)
+    {
+        g_gas_frame[k] = (uint8_t)(k * 37);
+    }
+    HOST_twi_hook(&g_gas_twi);
+    i2c_init();
+    sei(); // for the queued transfers
+    return (1);
+}
+
+static void _BENCH_i2c_read(uint32_t i)
+{
+    int8_t err;
+
+    (void)i;
+    err = i2c_read_packet(GAS_ADDRESS, g_gas_buffer);
+    _BENCH_fold(&err, 1);
+    _BENCH_fold(g_gas_buffer, GAS_SIZE);
+}
+
+static void _BENCH_i2c_queued(uint32_t i)
+{
+    (void)i;
+    i2c_submit(&g_gas_xfer);
+    while (I2C_PENDING == g_gas_xfer.status)
+    {
+        (void)PINB;
+    } // the main loop would run its tasks meanwhile
+    _BENCH_fold((const void *)&g_gas_xfer.status, 1);
+    _BENCH_fold(g_gas_buffer, g_gas_xfer.count);
+}
+
+//------------------------------------------------------------------------------
+// BME280 compensation, calibration and readings of the datasheet example
+//------------------------------------------------------------------------------
+static struct bme_calib g_calib = {
+    .dig_T1 = 27504,
+    .dig_T2 = 26435,
+    .dig_T3 = -1000,
+    .dig_P1 = 36477,
+    .dig_P2 = -10685,
+    .dig_P3 = 3024,
+    .dig_P4 = 2855,
+    .dig_P5 = 140,
+    .dig_P6 = -7,
+    .dig_P7 = 15500,
+    .dig_P8 = -14600,
+    .dig_P9 = 6000,
+    .dig_H1 = 75,
+    .dig_H2 = 362,
+    .dig_H3 = 0,
+    .dig_H4 = 324,
+    .dig_H5 = 50,
+    .dig_H6 = 30,
+};
+
+static void _BENCH_bme280(uint32_t i)
+{
+    int32_t t = BME280_compensate_T_int32(519888 + (int32_t)(i & 0xFF) * 16,
+                                          &g_calib);
+    uint32_t p = BME280_compensate_P_int64(415148 + (int32_t)(i & 0x3F),
+                                           &g_calib);
+    uint32_t h = bme280_compensate_H_int32(30000 + (int32_t)(i & 0x7F),
+                                           &g_calib);
+
+    _BENCH_fold(&t, sizeof(t));
+    _BENCH_fold(&p, sizeof(p));
+    _BENCH_fold(&h, sizeof(h));
+}
+
+//------------------------------------------------------------------------------
+// FAT16 on the SD card, through the SPI registers
+//------------------------------------------------------------------------------
+static void _BENCH_sd_result(uint8_t err)
+{
+    _BENCH_fold(&err, 1);
+}
+
+static int _BENCH_sd_init(void)
+{
+    if (!SDCARD_init(&PORTB, BENCH_SD_CS))
+    {
+        return (0);
+    }
+    HOST_spi_hook(_BENCH_spi);
+    return (SD_OK == SD_init(&DDRB, &PORTB, BENCH_SD_CS));
+}
+
+static int _BENCH_sd_setup(void)
+{
+    return (_BENCH_sd_init() && (SD_OK == SD_json_create("BENCH")));
+}
+
+static int _BENCH_sd_closed(void)
+{
+    if (!_BENCH_sd_setup())
+    {
+        return (0);
+    }
+    for (uint16_t i = 0; i < 500; ++i)
+    {
+        SD_json_append("temp", "32.07");
+    } // a few clusters to walk through
+    return (SD_OK == SD_json_close());
+}
+
+static void _BENCH_sd_boot(uint32_t i)
+{
+    (void)i;
+    _BENCH_sd_result(SD_init(&DDRB, &PORTB, BENCH_SD_CS));
+}
+
+static void _BENCH_sd_append(uint32_t i)
+{
+    char value[FMT_BUFFER_SIZE];
+
+    value[FMT_fixed(value, (int32_t)i, 2)] = '\0';
+    _BENCH_sd_result(SD_json_append("temp", value));
+}
+
+static void _BENCH_sd_open(uint32_t i)
+{
+    (void)i;
+    _BENCH_sd_result(SD_json_open("BENCH"));
+}
+
+//------------------------------------------------------------------------------
+// Benchmarks
+//------------------------------------------------------------------------------
+static const bench_t g_benches[] = {
+    {"itoa", _BENCH_no_setup, _BENCH_itoa, 1000000},
+    {"itoa_decimal", _BENCH_no_setup, _BENCH_itoa_decimal, 1000000},
+    {"fmt_u32", _BENCH_no_setup, _BENCH_fmt_u32, 1000000},
+    {"fmt_fixed", _BENCH_no_setup, _BENCH_fmt_fixed, 1000000},
+    {"serial_ulong", _BENCH_serial_setup, _BENCH_serial_ulong, 100000},
+    {"serial_printf", _BENCH_serial_setup, _BENCH_serial_printf, 100000},
+    {"packet_gas", _BENCH_no_setup, _BENCH_packet_gas, 1000000},
+    {"bme280", _BENCH_no_setup, _BENCH_bme280, 1000000},
+    {"i2c_read", _BENCH_i2c_setup, _BENCH_i2c_read, 100000},
+    {"i2c_queued", _BENCH_i2c_setup, _BENCH_i2c_queued, 100000},
+    {"sd_init", _BENCH_sd_init, _BENCH_sd_boot, 1000},
+    {"sd_append", _BENCH_sd_setup, _BENCH_sd_append, 2000},
+    {"sd_open", _BENCH_sd_closed, _BENCH_sd_open, 200},
+};
+
+#define BENCH_COUNT (sizeof(g_benches) / sizeof(g_benches[0]))
+
+static int _BENCH_selected(const char *name, int argc, char **argv)
+{
+    if (1 >= argc)
+    {
+        return (1);
+    }
+    for (int i = 1; i < argc; ++i)
+    {
+        if (0 == strcmp(name, argv[i]))
+        {
+            return (1);
+        }
+    }
+    return (0);
+}
+
+static int _BENCH_run(const bench_t *bench)
+{
+    uint64_t start;
+    uint64_t elapsed;
+    uint32_t io;
+
+    HOST_io_reset();
+    HOST_spi_hook(NULL);
+    HOST_uart_hook(NULL);
+    HOST_twi_hook(NULL);
+    if (!bench->setup())
+    {
+        printf("%-14s setup failed\n", bench->name);
+        return (0);
+    }
+    HOST_io_sync();
+    g_check = BENCH_FNV_OFFSET;
+    g_bus = 0;
+    io = HOST_io_count();
+    start = _BENCH_now_ns();
+    for (uint32_t i = 0; i < bench->ops; ++i)
+    {
+        bench->run(i);
+    }
+    HOST_io_sync();
+    elapsed = _BENCH_now_ns() - start;
+    io = HOST_io_count() - io;
+    printf("%-14s %8lu %10.1f %10.1f %10.1f   %08lx\n", bench->name,
+           (unsigned long)bench->ops, (double)elapsed / bench->ops,
+           (double)io / bench->ops, (double)g_bus / bench->ops,
+           (unsigned long)g_check);
+    return (1);
+}
+
+int main(int argc, char **argv)
+{
+    int status = 0;
+
+    printf("%-14s %8s %10s %10s %10s   %s\n", "bench", "ops", "ns/op", "io/op",
+           "bus/op", "check");
+    for (size_t i = 0; i < BENCH_COUNT; ++i)
+    {
+        if (_BENCH_selected(g_benches[i].name, argc, argv) &&
+            !_BENCH_run(&g_benches[i]))
+        {
+            status = 1;
+        }
+    }
+    return (status);
+}
@@ -0,0 +1,276 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include "sdcard.h"
+
+#define _SDCARD_SECTOR 512
+#define _SDCARD_RESERVED 1
+#define _SDCARD_FATS 2
+#define _SDCARD_FAT_SECTORS 32 /**< 8192 FAT16 entries */
+#define _SDCARD_ROOT_ENTRIES 512
+
+#define _SDCARD_R1_IDLE 0x01
+#define _SDCARD_R1_ILLEGAL 0x04
+#define _SDCARD_R1_PARAMETER 0x40
+
+#define _SDCARD_TOKEN 0xFE
+#define _SDCARD_DATA_ACCEPTED 0xE5
+
+typedef enum
+{
+    SDCARD_COMMAND,    /**< Waiting for a command */
+    SDCARD_WRITE_TOKEN, /**< Waiting for the data token of `CMD24` */
+    SDCARD_WRITE_DATA   /**< Receiving the block and its CRC */
+} sdcard_state_t;
+
+static struct
+{
+    uint8_t *disk;
+    volatile uint8_t *cs_port;
+    uint8_t cs_mask;
+    sdcard_state_t state;
+    uint8_t idle;
+    uint8_t app; // CMD55 received
+    uint8_t cmd[6];
+    uint8_t cmd_len;
+    uint8_t out[_SDCARD_SECTOR + 8];
+    uint16_t out_len;
+    uint16_t out_pos;
+    uint32_t lba;
+    uint8_t block[_SDCARD_SECTOR + 2]; // block and CRC of a write
+    uint16_t block_len;
+    uint32_t blocks;
+} g_sdcard;
+
+//------------------------------------------------------------------------------
+// _SDCARD_put16
+//------------------------------------------------------------------------------
+static void _SDCARD_put16(uint8_t *p, uint16_t value)
+{
+    p[0] = (uint8_t)(value & 0xFF);
+    p[1] = (uint8_t)(value >> 8);
+}
+
+//------------------------------------------------------------------------------
+// _SDCARD_format
+//------------------------------------------------------------------------------
+
+/**
+ * @brief FAT16 volume without partition table, empty root directory
+ */
+static void _SDCARD_format(uint8_t *disk)
+{
+    uint8_t *boot = disk;
+
+    memset(disk, 0, SDCARD_SECTORS * _SDCARD_SECTOR);
+    boot[0] = 0xEB;
+    boot[1] = 0x3C;
+    boot[2] = 0x90;
+    memcpy(boot + 0x03, "VEMAR   ", 8);
+    _SDCARD_put16(boot + 0x0B, _SDCARD_SECTOR);
+    boot[0x0D] = SDCARD_SPC;
+    _SDCARD_put16(boot + 0x0E, _SDCARD_RESERVED);
+    boot[0x10] = _SDCARD_FATS;
+    _SDCARD_put16(boot + 0x11, _SDCARD_ROOT_ENTRIES);
+    _SDCARD_put16(boot + 0x13, (uint16_t)SDCARD_SECTORS);
+    boot[0x15] = 0xF8; // fixed disk
+    _SDCARD_put16(boot + 0x16, _SDCARD_FAT_SECTORS);
+    memcpy(boot + 0x36, "FAT16   ", 8);
+    boot[510] = 0x55;
+    boot[511] = 0xAA;
+
+    for (uint8_t i = 0; i < _SDCARD_FATS; ++i)
+    {
+        uint8_t *fat = disk + (_SDCARD_RESERVED + i * _SDCARD_FAT_SECTORS) *
+                                  _SDCARD_SECTOR;
+        _SDCARD_put16(fat, 0xFFF8); // media descriptor
+        _SDCARD_put16(fat + 2, 0xFFFF);
+    }
+}
+
+//------------------------------------------------------------------------------
+// _SDCARD_reply
+//------------------------------------------------------------------------------
+static void _SDCARD_reply(uint8_t data)
+{
+    g_sdcard.out[g_sdcard.out_len++] = data;
+}
+
+//------------------------------------------------------------------------------
+// _SDCARD_command
+//------------------------------------------------------------------------------
+static void _SDCARD_command(void)
+{
+    uint8_t index = g_sdcard.cmd[0] & 0x3F;
+    uint32_t arg = ((uint32_t)g_sdcard.cmd[1] << 24) |
+                   ((uint32_t)g_sdcard.cmd[2] << 16) |
+                   ((uint32_t)g_sdcard.cmd[3] << 8) | g_sdcard.cmd[4];
+    uint8_t app = g_sdcard.app;
+
+    g_sdcard.app = 0;
+    g_sdcard.out_len = 0;
+    g_sdcard.out_pos = 0;
+    _SDCARD_reply(0xFF); // one byte of response time
+    switch (index)
+    {
+    case 0:
+        g_sdcard.idle = 1;
+        _SDCARD_reply(_SDCARD_R1_IDLE);
+        break;
+    case 8:
+        _SDCARD_reply(g_sdcard.idle);
+        _SDCARD_reply(0x00);
+        _SDCARD_reply(0x00);
+        _SDCARD_reply((uint8_t)((arg >> 8) & 0x0F)); // voltage accepted
+        _SDCARD_reply((uint8_t)(arg & 0xFF));        // check pattern
+        break;
+    case 16:
+        _SDCARD_reply(g_sdcard.idle);
+        break;
+    case 17:
+        if (SDCARD_SECTORS <= arg)
+        {
+            _SDCARD_reply(_SDCARD_R1_PARAMETER);
+            break;
+        }
+        _SDCARD_reply(0x00);
+        _SDCARD_reply(0xFF);
+        _SDCARD_reply(_SDCARD_TOKEN);
+        memcpy(g_sdcard.out + g_sdcard.out_len,
+               g_sdcard.disk + arg * _SDCARD_SECTOR, _SDCARD_SECTOR);
+        g_sdcard.out_len += _SDCARD_SECTOR;
+        _SDCARD_reply(0xFF); // CRC, not checked in SPI mode
+        _SDCARD_reply(0xFF);
+        ++g_sdcard.blocks;
+        break;
+    case 24:
+        if (SDCARD_SECTORS <= arg)
+        {
+            _SDCARD_reply(_SDCARD_R1_PARAMETER);
+            break;
+        }
+        _SDCARD_reply(0x00);
+        g_sdcard.lba = arg;
+        g_sdcard.state = SDCARD_WRITE_TOKEN;
+        break;
+    case 41:
+        if (!app)
+        {
+            _SDCARD_reply(_SDCARD_R1_ILLEGAL);
+            break;
+        }
+        g_sdcard.idle = 0; // ready at the first request
+        _SDCARD_reply(0x00);
+        break;
+    case 55:
+        g_sdcard.app = 1;
+        _SDCARD_reply(g_sdcard.idle);
+        break;
+    case 58:
+        _SDCARD_reply(g_sdcard.idle);
+        _SDCARD_reply(0xC0); // powered up, block addressed (SDHC)
+        _SDCARD_reply(0xFF);
+        _SDCARD_reply(0x80);
+        _SDCARD_reply(0x00);
+        break;
+    default:
+        _SDCARD_reply(g_sdcard.idle | _SDCARD_R1_ILLEGAL);
+        break;
+    }
+}
+
+//------------------------------------------------------------------------------
+// SDCARD_init
+//------------------------------------------------------------------------------
+int SDCARD_init(volatile uint8_t *cs_port, uint8_t cs_mask)
+{
+    if (NULL == g_sdcard.disk)
+    {
+        g_sdcard.disk = malloc(SDCARD_SECTORS * _SDCARD_SECTOR);
+        if (NULL == g_sdcard.disk)
+        {
+            return (0);
+        }
+    }
+    _SDCARD_format(g_sdcard.disk);
+    g_sdcard.cs_port = cs_port;
+    g_sdcard.cs_mask = cs_mask;
+    g_sdcard.state = SDCARD_COMMAND;
+    g_sdcard.idle = 0;
+    g_sdcard.app = 0;
+    g_sdcard.cmd_len = 0;
+    g_sdcard.out_len = g_sdcard.out_pos = 0;
+    g_sdcard.blocks = 0;
+    return (1);
+}
+
+//------------------------------------------------------------------------------
+// SDCARD_exchange
+//------------------------------------------------------------------------------
+uint8_t SDCARD_exchange(uint8_t data)
+{
+    if (*g_sdcard.cs_port & g_sdcard.cs_mask)
+    {
+        g_sdcard.cmd_len = 0;
+        g_sdcard.out_len = g_sdcard.out_pos = 0;
+        g_sdcard.state = SDCARD_COMMAND;
+        return (0xFF);
+    } // not selected: MISO released
+
+    if (g_sdcard.out_pos < g_sdcard.out_len)
+    {
+        return (g_sdcard.out[g_sdcard.out_pos++]);
+    }
+    switch (g_sdcard.state)
+    {
+    case SDCARD_WRITE_TOKEN:
+        if (_SDCARD_TOKEN == data)
+        {
+            g_sdcard.block_len = 0;
+            g_sdcard.state = SDCARD_WRITE_DATA;
+        }
+        break;
+    case SDCARD_WRITE_DATA:
+        g_sdcard.block[g_sdcard.block_len++] = data;
+        if (sizeof(g_sdcard.block) == g_sdcard.block_len)
+        {
+            memcpy(g_sdcard.disk + g_sdcard.lba * _SDCARD_SECTOR,
+                   g_sdcard.block, _SDCARD_SECTOR);
+            ++g_sdcard.blocks;
+            g_sdcard.out_len = g_sdcard.out_pos = 0;
+            _SDCARD_reply(_SDCARD_DATA_ACCEPTED);
+            _SDCARD_reply(0x00); // busy while programming
+            g_sdcard.state = SDCARD_COMMAND;
+        }
+        break;
+    case SDCARD_COMMAND:
+        if ((0 == g_sdcard.cmd_len) && (0x40 != (data & 0xC0)))
+        {
+            break;
+        } // start bit and transmission bit
+        g_sdcard.cmd[g_sdcard.cmd_len++] = data;
+        if (sizeof(g_sdcard.cmd) == g_sdcard.cmd_len)
+        {
+            g_sdcard.cmd_len = 0;
+            _SDCARD_command();
+        }
+        break;
+    }
+    return (0xFF);
+}
+
+//------------------------------------------------------------------------------
+// SDCARD_sector
+//------------------------------------------------------------------------------
+const uint8_t *SDCARD_sector(uint32_t lba)
+{
+    return (g_sdcard.disk + lba * _SDCARD_SECTOR);
+}
+
+//------------------------------------------------------------------------------
+// SDCARD_blocks
+//------------------------------------------------------------------------------
+uint32_t SDCARD_blocks(void)
+{
+    return (g_sdcard.blocks);
+}
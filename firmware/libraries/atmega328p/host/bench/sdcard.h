@@ -0,0 +1,41 @@
+/**
+ * @file sdcard.h
+ * @brief SD card in SPI mode on the host bus, backed by a FAT16 RAM disk
+ * @details
+ * Answers the commands used by `libraries/sd`: `CMD0`, `CMD8`, `CMD16`,
+ * `CMD17`, `CMD24`, `CMD55`, `ACMD41` and `CMD58`. The card is an SDHC one,
+ * addressed by block, and never busy for more than one byte.
+ */
+
+#ifndef VEMAR_HOST_SDCARD_H
+#define VEMAR_HOST_SDCARD_H
+
+#include <stdint.h>
+
+#define SDCARD_SECTORS 32768UL /**< 16 MiB, smallest size formatted as FAT16 */
+#define SDCARD_SPC 4           /**< Sectors per cluster */
+
+/**
+ * @brief Format the RAM disk and reset the card
+ * @param cs_port PORT register of the Chip Select pin
+ * @param cs_mask Bit of the Chip Select pin
+ * @return `0` if the disk cannot be allocated
+ */
+int SDCARD_init(volatile uint8_t *cs_port, uint8_t cs_mask);
+
+/**
+ * @brief SPI hook of the card, see `HOST_spi_hook`
+ */
+uint8_t SDCARD_exchange(uint8_t data);
+
+/**
+ * @brief Sector of the RAM disk
+ */
+const uint8_t *SDCARD_sector(uint32_t lba);
+
+/**
+ * @brief Number of blocks read and written since the last `SDCARD_init`
+ */
+uint32_t SDCARD_blocks(void);
+
+#endif // VEMAR_HOST_SDCARD_H
@@ -0,0 +1,47 @@
+/**
+ * @file eeprom.h
+ * @brief Host stand-in for `<avr/eeprom.h>`
+ * @details `EEMEM` variables live in data memory, zeroed at start instead of
+ * erased, and the accessors copy from and to them.
+ */
+
+#ifndef VEMAR_HOST_AVR_EEPROM_H
+#define VEMAR_HOST_AVR_EEPROM_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#define EEMEM
+
+static inline uint8_t eeprom_read_byte(const uint8_t *addr)
+{
+    return (*addr);
+}
+
+static inline void eeprom_write_byte(uint8_t *addr, uint8_t value)
+{
+    *addr = value;
+}
+
+static inline void eeprom_update_byte(uint8_t *addr, uint8_t value)
+{
+    *addr = value;
+}
+
+static inline void eeprom_read_block(void *dst, const void *src, size_t len)
+{
+    memcpy(dst, src, len);
+}
+
+static inline void eeprom_write_block(const void *src, void *dst, size_t len)
+{
+    memcpy(dst, src, len);
+}
+
+static inline void eeprom_update_block(const void *src, void *dst, size_t len)
+{
+    memcpy(dst, src, len);
+}
+
+#endif // VEMAR_HOST_AVR_EEPROM_H
@@ -0,0 +1,26 @@
+/**
+ * @file interrupt.h
+ * @brief Host stand-in for `<avr/interrupt.h>`
+ * @details An interrupt handler is a plain function named after its vector:
+ * the host tools call `TIMER2_COMPA_vect()` to raise the interrupt. `sei` and
+ * `cli` only move the I bit of `SREG`.
+ */
+
+#ifndef VEMAR_HOST_AVR_INTERRUPT_H
+#define VEMAR_HOST_AVR_INTERRUPT_H
+
+#include <avr/io.h>
+
+#define ISR(vector, ...) \
+    void vector(void);   \
+    void vector(void)
+#define EMPTY_INTERRUPT(vector) \
+    void vector(void);          \
+    void vector(void) {}
+#define ISR_BLOCK
+#define ISR_NOBLOCK
+
+#define sei() (SREG |= _BV(SREG_I))
+#define cli() (SREG &= (uint8_t)~_BV(SREG_I))
+
+#endif // VEMAR_HOST_AVR_INTERRUPT_H
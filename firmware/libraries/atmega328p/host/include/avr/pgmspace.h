@@ -0,0 +1,26 @@
+/**
+ * @file pgmspace.h
+ * @brief Host stand-in for `<avr/pgmspace.h>`: program memory is data memory
+ */
+
+#ifndef VEMAR_HOST_AVR_PGMSPACE_H
+#define VEMAR_HOST_AVR_PGMSPACE_H
+
+#include <stdint.h>
+#include <string.h>
+
+#define PROGMEM
+#define PGM_P const char *
+#define PSTR(s) (s)
+
+#define pgm_read_byte(addr) (*(const uint8_t *)(addr))
+#define pgm_read_word(addr) (*(const uint16_t *)(addr))
+#define pgm_read_dword(addr) (*(const uint32_t *)(addr))
+#define pgm_read_ptr(addr) (*(void *const *)(addr))
+
+#define memcpy_P memcpy
+#define strcpy_P strcpy
+#define strlen_P strlen
+#define strcmp_P strcmp
+
+#endif // VEMAR_HOST_AVR_PGMSPACE_H
@@ -0,0 +1,34 @@
+/**
+ * @file sfr_defs.h
+ * @brief Host stand-in for `<avr/sfr_defs.h>`: registers as `HOST_io` bytes
+ * @details Each access goes through `HOST_reg`, see `host_io.h`.
+ */
+
+#ifndef VEMAR_HOST_AVR_SFR_DEFS_H
+#define VEMAR_HOST_AVR_SFR_DEFS_H
+
+#include <stdint.h>
+
+#include <host_io.h>
+
+#define __SFR_OFFSET 0x20 /**< I/O space starts after the 32 registers */
+
+#define _SFR_MEM8(addr) (*HOST_reg(addr))
+#define _SFR_MEM16(addr) (*(volatile uint16_t *)HOST_reg(addr))
+#define _SFR_IO8(addr) _SFR_MEM8((addr) + __SFR_OFFSET)
+#define _SFR_IO16(addr) _SFR_MEM16((addr) + __SFR_OFFSET)
+#define _SFR_IO_ADDR(sfr) ((uint8_t)(&(sfr) - HOST_io) - __SFR_OFFSET)
+
+#define _BV(bit) (1 << (bit))
+#define bit_is_set(sfr, bit) ((sfr) & _BV(bit))
+#define bit_is_clear(sfr, bit) (!((sfr) & _BV(bit)))
+#define loop_until_bit_is_set(sfr, bit) \
+    do                                  \
+    {                                   \
+    } while (bit_is_clear(sfr, bit))
+#define loop_until_bit_is_clear(sfr, bit) \
+    do                                    \
+    {                                     \
+    } while (bit_is_set(sfr, bit))
+
+#endif // VEMAR_HOST_AVR_SFR_DEFS_H
@@ -0,0 +1,20 @@
+/**
+ * @file sleep.h
+ * @brief Host stand-in for `<avr/sleep.h>`: the host never sleeps
+ */
+
+#ifndef VEMAR_HOST_AVR_SLEEP_H
+#define VEMAR_HOST_AVR_SLEEP_H
+
+#define SLEEP_MODE_IDLE 0x00
+#define SLEEP_MODE_ADC 0x02
+#define SLEEP_MODE_PWR_DOWN 0x04
+#define SLEEP_MODE_PWR_SAVE 0x06
+
+#define set_sleep_mode(mode) ((void)(mode))
+#define sleep_enable() ((void)0)
+#define sleep_disable() ((void)0)
+#define sleep_cpu() ((void)0)
+#define sleep_mode() ((void)0)
+
+#endif // VEMAR_HOST_AVR_SLEEP_H
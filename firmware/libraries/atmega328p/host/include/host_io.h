@@ -0,0 +1,103 @@
+/**
+ * @file host_io.h
+ * @brief Peripheral hooks of the host register file
+ * @details
+ * Every register access of the library built for the host goes through
+ * `HOST_reg`. A write cannot be told from a read when it happens, so an
+ * access takes effect when the next one starts, or on `HOST_io_sync`.
+ *
+ * The SPI, UART, ADC and TWI registers behave as on the target, with the
+ * other end of the bus left to the host program:
+ * - SPI: a byte written to `SPDR` is exchanged when `SPSR` is polled, the
+ * reply is what `SPDR` reads next
+ * - UART: the transmitter is ready unless stalled by `HOST_uart_stall`,
+ * every byte written to `UDR0` is handed over at once, `HOST_uart_receive`
+ * feeds the receiver
+ * - ADC: a conversion completes as soon as `ADSC` is set, free running and
+ * auto trigger are not modelled
+ * - TWI: master mode only, each operation completes when `TWINT` is written
+ *
+ * Enabled interrupts of these peripherals are raised between two accesses
+ * while the I bit of `SREG` is set, at most one at a time. Timer and pin
+ * change interrupts are left to the host program, which calls the vectors.
+ */
+
+#ifndef VEMAR_HOST_IO_H
+#define VEMAR_HOST_IO_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief SPI slave: returns the byte shifted in for the byte shifted out
+ */
+typedef uint8_t (*host_spi_hook_t)(uint8_t data);
+
+/**
+ * @brief UART receiver of the host: gets every byte transmitted
+ */
+typedef void (*host_uart_hook_t)(uint8_t data);
+
+/**
+ * @brief Analog input: returns the 10-bit result of a conversion
+ */
+typedef uint16_t (*host_adc_hook_t)(uint8_t channel);
+
+/**
+ * @brief TWI slaves of the bus, any member may be `NULL`
+ */
+typedef struct
+{
+    int (*start)(uint8_t addr_rw); /**< Address byte, non-zero to ACK */
+    int (*write)(uint8_t data);    /**< Byte from the master, non-zero to ACK */
+    uint8_t (*read)(int ack);      /**< Byte to the master, `ack` from it */
+    void (*stop)(void);            /**< STOP condition */
+} host_twi_t;
+
+/**
+ * @brief Access a register, used by `_SFR_MEM8` and `_SFR_MEM16`
+ * @param addr Data space address
+ * @return Register in `HOST_io`
+ */
+volatile uint8_t *HOST_reg(uint16_t addr);
+
+/**
+ * @brief Apply the last access, before reading the results of the hooks
+ */
+void HOST_io_sync(void);
+
+/**
+ * @brief Clear the registers and the peripheral states, hooks are kept
+ */
+void HOST_io_reset(void);
+
+/**
+ * @brief Number of register accesses since the last reset
+ */
+uint32_t HOST_io_count(void);
+
+void HOST_spi_hook(host_spi_hook_t hook);
+void HOST_uart_hook(host_uart_hook_t hook);
+void HOST_adc_hook(host_adc_hook_t hook);
+void HOST_twi_hook(const host_twi_t *twi);
+
+/**
+ * @brief Hold the UART transmitter busy, `UDRE0` and `TXC0` read as `0`
+ * @param stall Non-zero to stall, `0` to let it send again
+ */
+void HOST_uart_stall(int stall);
+
+/**
+ * @brief Queue a byte for the UART receiver
+ * @return `0` if the queue is full
+ */
+int HOST_uart_receive(uint8_t data);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // VEMAR_HOST_IO_H
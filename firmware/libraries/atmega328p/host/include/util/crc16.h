@@ -0,0 +1,29 @@
+/**
+ * @file crc16.h
+ * @brief Host stand-in for `<util/crc16.h>`, same results as avr-libc
+ */
+
+#ifndef VEMAR_HOST_UTIL_CRC16_H
+#define VEMAR_HOST_UTIL_CRC16_H
+
+#include <stdint.h>
+
+static inline uint16_t _crc16_update(uint16_t crc, uint8_t data)
+{
+    crc ^= data;
+    for (uint8_t i = 0; i < 8; ++i)
+    {
+        crc = (crc & 1) ? (uint16_t)((crc >> 1) ^ 0xA001) : (uint16_t)(crc >> 1);
+    }
+    return (crc);
+}
+
+static inline uint16_t _crc_ccitt_update(uint16_t crc, uint8_t data)
+{
+    data ^= (uint8_t)(crc & 0xFF);
+    data ^= (uint8_t)(data << 4);
+    return ((uint16_t)((((uint16_t)data << 8) | (crc >> 8)) ^
+                       (uint8_t)(data >> 4) ^ ((uint16_t)data << 3)));
+}
+
+#endif // VEMAR_HOST_UTIL_CRC16_H
@@ -0,0 +1,13 @@
+/**
+ * @file delay.h
+ * @brief Host stand-in for `<util/delay.h>`: busy waits return at once
+ * @details Host time only moves when the host tool raises the tick interrupt.
+ */
+
+#ifndef VEMAR_HOST_UTIL_DELAY_H
+#define VEMAR_HOST_UTIL_DELAY_H
+
+#define _delay_ms(ms) ((void)(ms))
+#define _delay_us(us) ((void)(us))
+
+#endif // VEMAR_HOST_UTIL_DELAY_H
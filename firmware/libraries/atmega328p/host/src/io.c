@@ -0,0 +1,533 @@
+#include <stddef.h>
+
+#include <avr/io.h>
+#include <util/twi.h>
+
+#include <host_io.h>
+
+#define _HOST_NONE 0xFFFF /**< No access to apply */
+
+#define _HOST_IO(addr) ((addr) + __SFR_OFFSET)
+
+#define _HOST_SPSR _HOST_IO(0x2D)
+#define _HOST_SPDR _HOST_IO(0x2E)
+#define _HOST_SPCR _HOST_IO(0x2C)
+#define _HOST_SREG _HOST_IO(0x3F)
+#define _HOST_ADCL 0x78
+#define _HOST_ADCH 0x79
+#define _HOST_ADCSRA 0x7A
+#define _HOST_ADMUX 0x7C
+#define _HOST_TWSR 0xB9
+#define _HOST_TWDR 0xBB
+#define _HOST_TWCR 0xBC
+#define _HOST_UCSR0A 0xC0
+#define _HOST_UCSR0B 0xC1
+#define _HOST_UDR0 0xC6
+
+#define _HOST_UART_RX_SIZE 256
+
+volatile uint8_t HOST_io[HOST_IO_SIZE] __attribute__((aligned(2)));
+
+// vectors of the modelled peripherals, when the program defines them
+void SPI_STC_vect(void) __attribute__((weak));
+void USART_RX_vect(void) __attribute__((weak));
+void USART_UDRE_vect(void) __attribute__((weak));
+void ADC_vect(void) __attribute__((weak));
+void TWI_vect(void) __attribute__((weak));
+
+/**
+ * @brief Access waiting to be applied
+ */
+typedef struct
+{
+    uint16_t addr;  /**< Data space address, `_HOST_NONE` if none */
+    uint8_t before; /**< Value when the access started */
+    uint8_t flag;   /**< Peripheral state when the access started */
+} host_access_t;
+
+static host_access_t g_host_last = {_HOST_NONE, 0, 0};
+static uint32_t g_host_count;
+static uint8_t g_host_depth; // interrupt handler running
+
+static struct
+{
+    host_spi_hook_t hook;
+    uint8_t flag;    // SPIF
+    uint8_t pending; // byte written to SPDR, not exchanged yet
+    uint8_t maybe;   // SPDR accessed after a transfer, unchanged
+    uint8_t polls;   // SPSR reads in a row since then
+} g_host_spi;
+
+static struct
+{
+    host_uart_hook_t hook;
+    uint8_t rx[_HOST_UART_RX_SIZE];
+    uint16_t head;
+    uint16_t tail;
+    uint8_t stall; // transmitter busy: UDRE0 and TXC0 stay clear
+} g_host_uart;
+
+static struct
+{
+    host_adc_hook_t hook;
+    uint8_t flag; // ADIF
+} g_host_adc;
+
+static struct
+{
+    const host_twi_t *hook;
+    uint8_t flag;    // TWINT
+    uint8_t status;  // TWSR status bits
+    uint8_t owner;   // bus held since the last START
+    uint8_t reading; // SLA+R acknowledged
+    uint8_t done;    // the last access completed an operation
+} g_host_twi = {.status = TW_NO_INFO};
+
+//------------------------------------------------------------------------------
+// SPI
+//------------------------------------------------------------------------------
+
+static void _HOST_spi_exchange(void)
+{
+    uint8_t data = HOST_io[_HOST_SPDR];
+
+    HOST_io[_HOST_SPDR] = (NULL != g_host_spi.hook) ? g_host_spi.hook(data)
+                                                    : 0xFF;
+    g_host_spi.flag = 1;
+    g_host_spi.pending = 0;
+    g_host_spi.maybe = 0;
+    g_host_spi.polls = 0;
+}
+
+static uint8_t _HOST_spi_before(uint16_t addr)
+{
+    uint8_t flag = g_host_spi.flag;
+
+    if (_HOST_SPSR == addr)
+    {
+        if (!g_host_spi.flag && g_host_spi.pending)
+        {
+            _HOST_spi_exchange();
+        }
+        HOST_io[_HOST_SPSR] = (HOST_io[_HOST_SPSR] & (uint8_t)~_BV(SPIF)) |
+                              (g_host_spi.flag ? _BV(SPIF) : 0);
+    }
+    else if (_HOST_SPDR == addr)
+    {
+        g_host_spi.flag = 0; // cleared by the access following the poll
+    }
+    return (flag);
+}
+
+static void _HOST_spi_after(const host_access_t *access, uint8_t now)
+{
+    if (_HOST_SPDR == access->addr)
+    {
+        // with SPIF clear, SPDR is only accessed to start a transfer; after
+        // a transfer the reply is read, or the next byte is written
+        if (!access->flag || (now != access->before))
+        {
+            g_host_spi.pending = 1;
+            g_host_spi.maybe = 0;
+        }
+        else
+        {
+            g_host_spi.maybe = 1;
+            g_host_spi.polls = 0;
+        }
+    }
+    else if (_HOST_SPSR == access->addr)
+    {
+        if (now != access->before)
+        {
+            HOST_io[_HOST_SPSR] = (now & (uint8_t)~(_BV(SPIF) | _BV(WCOL))) |
+                                  (g_host_spi.flag ? _BV(SPIF) : 0);
+        } // SPIF and WCOL are read only
+        else if (g_host_spi.maybe && (2 <= ++g_host_spi.polls))
+        {
+            _HOST_spi_exchange();
+        } // polled twice: the byte written was the reply itself
+    }
+    else if (0 == g_host_depth)
+    {
+        g_host_spi.polls = 0;
+    } // the accesses of an interrupt do not break a poll
+}
+
+//------------------------------------------------------------------------------
+// UART
+//------------------------------------------------------------------------------
+
+static uint8_t _HOST_uart_rx_ready(void)
+{
+    return (g_host_uart.head != g_host_uart.tail);
+}
+
+static uint8_t _HOST_uart_before(uint16_t addr)
+{
+    uint8_t ready = _HOST_uart_rx_ready();
+
+    if (_HOST_UCSR0A == addr)
+    {
+        HOST_io[addr] =
+            (HOST_io[addr] & (uint8_t)~(_BV(RXC0) | _BV(UDRE0) | _BV(TXC0))) |
+            (g_host_uart.stall ? 0 : (_BV(UDRE0) | _BV(TXC0))) |
+            (ready ? _BV(RXC0) : 0);
+    }
+    else if ((_HOST_UDR0 == addr) && ready)
+    {
+        HOST_io[addr] = g_host_uart.rx[g_host_uart.tail];
+    }
+    return (ready);
+}
+
+static void _HOST_uart_after(const host_access_t *access, uint8_t now)
+{
+    if ((_HOST_UCSR0A == access->addr) && (now != access->before))
+    {
+        HOST_io[_HOST_UCSR0A] =
+            (now & (uint8_t)~(_BV(RXC0) | _BV(UDRE0) | _BV(TXC0))) |
+            (access->before & (_BV(RXC0) | _BV(UDRE0) | _BV(TXC0)));
+    } // the status flags are read only, TXC0 set unless stalled
+    else if (_HOST_UDR0 == access->addr)
+    {
+        if (access->flag && (now == access->before))
+        {
+            g_host_uart.tail = (g_host_uart.tail + 1) % _HOST_UART_RX_SIZE;
+        } // received byte read
+        else if (NULL != g_host_uart.hook)
+        {
+            g_host_uart.hook(now);
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+// ADC
+//------------------------------------------------------------------------------
+
+static void _HOST_adc_before(uint16_t addr)
+{
+    if (_HOST_ADCSRA == addr)
+    {
+        HOST_io[addr] = (HOST_io[addr] & (uint8_t)~_BV(ADIF)) |
+                        (g_host_adc.flag ? _BV(ADIF) : 0);
+    }
+}
+
+static void _HOST_adc_after(const host_access_t *access, uint8_t now)
+{
+    uint16_t result;
+
+    if (_HOST_ADCSRA != access->addr)
+    {
+        return;
+    }
+    if ((now != access->before) && (now & _BV(ADIF)))
+    {
+        g_host_adc.flag = 0; // cleared by writing one
+    }
+    if ((now & _BV(ADSC)) && (now & _BV(ADEN)))
+    {
+        result = (NULL != g_host_adc.hook)
+                     ? g_host_adc.hook(HOST_io[_HOST_ADMUX] & 0x0F)
+                     : 0;
+        result &= 0x03FF;
+        if (HOST_io[_HOST_ADMUX] & _BV(ADLAR))
+        {
+            result <<= 6;
+        }
+        HOST_io[_HOST_ADCL] = (uint8_t)(result & 0xFF);
+        HOST_io[_HOST_ADCH] = (uint8_t)(result >> 8);
+        g_host_adc.flag = 1;
+        now &= (uint8_t)~_BV(ADSC);
+    }
+    HOST_io[_HOST_ADCSRA] =
+        (now & (uint8_t)~_BV(ADIF)) | (g_host_adc.flag ? _BV(ADIF) : 0);
+}
+
+//------------------------------------------------------------------------------
+// TWI
+//------------------------------------------------------------------------------
+
+static void _HOST_twi_operation(uint8_t control)
+{
+    const host_twi_t *twi = g_host_twi.hook;
+    uint8_t data = HOST_io[_HOST_TWDR];
+    int ack;
+
+    g_host_twi.flag = 1;
+    g_host_twi.done = 1;
+    if (control & _BV(TWSTO))
+    {
+        if (g_host_twi.owner && (NULL != twi) && (NULL != twi->stop))
+        {
+            twi->stop();
+        }
+        g_host_twi.owner = 0;
+        g_host_twi.reading = 0;
+        g_host_twi.status = TW_NO_INFO;
+        g_host_twi.flag = 0; // TWINT is not set after a STOP
+        g_host_twi.done = 0;
+        if (!(control & _BV(TWSTA)))
+        {
+            return;
+        } // with both, a START follows the STOP as on the hardware
+        g_host_twi.flag = 1;
+        g_host_twi.done = 1;
+    }
+    if (control & _BV(TWSTA))
+    {
+        g_host_twi.status = g_host_twi.owner ? TW_REP_START : TW_START;
+        g_host_twi.owner = 1;
+        g_host_twi.reading = 0;
+    }
+    else if (!g_host_twi.owner)
+    {
+        g_host_twi.flag = 0; // slave mode: no master on the host side
+        g_host_twi.done = 0;
+    }
+    else if ((TW_START == g_host_twi.status) ||
+             (TW_REP_START == g_host_twi.status))
+    {
+        ack = (NULL != twi) && (NULL != twi->start) && twi->start(data);
+        if (data & TW_READ)
+        {
+            g_host_twi.status = ack ? TW_MR_SLA_ACK : TW_MR_SLA_NACK;
+            g_host_twi.reading = (uint8_t)ack;
+        }
+        else
+        {
+            g_host_twi.status = ack ? TW_MT_SLA_ACK : TW_MT_SLA_NACK;
+        }
+    }
+    else if (g_host_twi.reading)
+    {
+        ack = (control & _BV(TWEA)) ? 1 : 0;
+        HOST_io[_HOST_TWDR] =
+            ((NULL != twi) && (NULL != twi->read)) ? twi->read(ack) : 0xFF;
+        g_host_twi.status = ack ? TW_MR_DATA_ACK : TW_MR_DATA_NACK;
+    }
+    else
+    {
+        ack = (NULL != twi) && (NULL != twi->write) && twi->write(data);
+        g_host_twi.status = ack ? TW_MT_DATA_ACK : TW_MT_DATA_NACK;
+    }
+}
+
+static void _HOST_twi_before(uint16_t addr)
+{
+    if (_HOST_TWCR == addr)
+    {
+        HOST_io[addr] = (HOST_io[addr] & (uint8_t)~_BV(TWINT)) |
+                        (g_host_twi.flag ? _BV(TWINT) : 0);
+    }
+    else if (_HOST_TWSR == addr)
+    {
+        HOST_io[addr] = (HOST_io[addr] & ~TW_STATUS_MASK) | g_host_twi.status;
+    }
+}
+
+static void _HOST_twi_after(const host_access_t *access, uint8_t now)
+{
+    uint8_t done = g_host_twi.done;
+
+    g_host_twi.done = 0;
+    if (_HOST_TWSR == access->addr)
+    {
+        HOST_io[_HOST_TWSR] = (now & ~TW_STATUS_MASK) | g_host_twi.status;
+    }
+    else if (_HOST_TWCR == access->addr)
+    {
+        // a write of TWINT starts an operation, unless the access is the
+        // poll right after the previous one completed
+        if ((now & _BV(TWINT)) && (now & _BV(TWEN)) &&
+            ((now != access->before) || !done))
+        {
+            _HOST_twi_operation(now);
+        }
+        HOST_io[_HOST_TWCR] =
+            (now & (uint8_t)~(_BV(TWINT) | _BV(TWSTO))) |
+            (g_host_twi.flag ? _BV(TWINT) : 0);
+    }
+}
+
+//------------------------------------------------------------------------------
+// Register Accesses
+//------------------------------------------------------------------------------
+
+static void _HOST_apply(void)
+{
+    host_access_t access;
+    uint8_t now;
+
+    while (_HOST_NONE != g_host_last.addr)
+    {
+        access = g_host_last;
+        g_host_last.addr = _HOST_NONE; // the hooks may access registers
+        now = HOST_io[access.addr];
+        _HOST_spi_after(&access, now);
+        _HOST_uart_after(&access, now);
+        _HOST_adc_after(&access, now);
+        _HOST_twi_after(&access, now);
+    }
+}
+
+static void _HOST_raise(void (*vector)(void))
+{
+    HOST_io[_HOST_SREG] &= (uint8_t)~_BV(SREG_I);
+    ++g_host_depth;
+    vector();
+    _HOST_apply();
+    --g_host_depth;
+    HOST_io[_HOST_SREG] |= _BV(SREG_I);
+}
+
+/**
+ * @brief Raise the first pending interrupt, in vector order
+ */
+static void _HOST_interrupt(void)
+{
+    if ((0 != g_host_depth) || !(HOST_io[_HOST_SREG] & _BV(SREG_I)))
+    {
+        return;
+    }
+    if ((NULL != SPI_STC_vect) && g_host_spi.flag &&
+        (HOST_io[_HOST_SPCR] & _BV(SPIE)))
+    {
+        g_host_spi.flag = 0;
+        _HOST_raise(SPI_STC_vect);
+    }
+    else if ((NULL != USART_RX_vect) && _HOST_uart_rx_ready() &&
+             (HOST_io[_HOST_UCSR0B] & _BV(RXCIE0)))
+    {
+        _HOST_raise(USART_RX_vect);
+    }
+    else if ((NULL != USART_UDRE_vect) && !g_host_uart.stall &&
+             (HOST_io[_HOST_UCSR0B] & _BV(UDRIE0)))
+    {
+        _HOST_raise(USART_UDRE_vect);
+    }
+    else if ((NULL != ADC_vect) && g_host_adc.flag &&
+             (HOST_io[_HOST_ADCSRA] & _BV(ADIE)))
+    {
+        g_host_adc.flag = 0;
+        _HOST_raise(ADC_vect);
+    }
+    else if ((NULL != TWI_vect) && g_host_twi.flag &&
+             (HOST_io[_HOST_TWCR] & _BV(TWIE)))
+    {
+        _HOST_raise(TWI_vect);
+    }
+}
+
+//------------------------------------------------------------------------------
+// HOST_reg
+//------------------------------------------------------------------------------
+volatile uint8_t *HOST_reg(uint16_t addr)
+{
+    uint8_t flag = 0;
+
+    ++g_host_count;
+    _HOST_apply();
+    _HOST_interrupt();
+    if ((_HOST_SPSR == addr) || (_HOST_SPDR == addr))
+    {
+        flag = _HOST_spi_before(addr);
+    }
+    else if ((_HOST_UCSR0A == addr) || (_HOST_UDR0 == addr))
+    {
+        flag = _HOST_uart_before(addr);
+    }
+    else if (_HOST_ADCSRA == addr)
+    {
+        _HOST_adc_before(addr);
+    }
+    else if ((_HOST_TWCR == addr) || (_HOST_TWSR == addr))
+    {
+        _HOST_twi_before(addr);
+    }
+    _HOST_apply(); // accesses of the hooks
+    g_host_last.addr = addr;
+    g_host_last.before = HOST_io[addr];
+    g_host_last.flag = flag;
+    return (&HOST_io[addr]);
+}
+
+//------------------------------------------------------------------------------
+// HOST_io_sync
+//------------------------------------------------------------------------------
+void HOST_io_sync(void)
+{
+    _HOST_apply();
+}
+
+//------------------------------------------------------------------------------
+// HOST_io_reset
+//------------------------------------------------------------------------------
+void HOST_io_reset(void)
+{
+    _HOST_apply();
+    for (uint16_t i = 0; i < HOST_IO_SIZE; ++i)
+    {
+        HOST_io[i] = 0;
+    }
+    g_host_count = 0;
+    g_host_spi.flag = g_host_spi.pending = g_host_spi.maybe = 0;
+    g_host_spi.polls = 0;
+    g_host_uart.head = g_host_uart.tail = 0;
+    g_host_uart.stall = 0;
+    g_host_adc.flag = 0;
+    g_host_twi.flag = g_host_twi.owner = g_host_twi.reading = 0;
+    g_host_twi.done = 0;
+    g_host_twi.status = TW_NO_INFO;
+}
+
+//------------------------------------------------------------------------------
+// HOST_io_count
+//------------------------------------------------------------------------------
+uint32_t HOST_io_count(void)
+{
+    return (g_host_count);
+}
+
+//------------------------------------------------------------------------------
+// Hooks
+//------------------------------------------------------------------------------
+void HOST_spi_hook(host_spi_hook_t hook)
+{
+    g_host_spi.hook = hook;
+}
+
+void HOST_uart_hook(host_uart_hook_t hook)
+{
+    g_host_uart.hook = hook;
+}
+
+void HOST_adc_hook(host_adc_hook_t hook)
+{
+    g_host_adc.hook = hook;
+}
+
+void HOST_twi_hook(const host_twi_t *twi)
+{
+    g_host_twi.hook = twi;
+}
+
+void HOST_uart_stall(int stall)
+{
+    g_host_uart.stall = (0 != stall);
+}
+
+int HOST_uart_receive(uint8_t data)
+{
+    uint16_t next = (g_host_uart.head + 1) % _HOST_UART_RX_SIZE;
+
+    if (next == g_host_uart.tail)
+    {
+        return (0);
+    }
+    g_host_uart.rx[g_host_uart.head] = data;
+    g_host_uart.head = next;
+    return (1);
+}
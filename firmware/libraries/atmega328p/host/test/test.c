@@ -0,0 +1,874 @@
+//------------------------------------------------------------------------------
+// test.c
+//
+// Unit tests of the library drivers, built for the host and run against the
+// register file of `host/src/io.c`
+//
+// Usage: libvemar_test [name...]
+//
+// Every test starts from cleared registers. A failed check prints its line
+// and the test goes on, the exit status is `1` if any check failed.
+//------------------------------------------------------------------------------
+
+#include <stdio.h>
+#include <string.h>
+
+#include <avr/interrupt.h>
+#include <avr/pgmspace.h>
+#include <host_io.h>
+#include <util/packet.h>
+
+#include "adc.h"
+#include "bme.h"
+#include "fmt.h"
+#include "gpio.h"
+#include "i2c.h"
+#include "sd.h"
+#include "sdcard.h"
+#include "serial.h"
+#include "spi.h"
+#include "uart.h"
+#include "util.h"
+#include "config.h"
+
+#define TEST_BUS_SIZE 256
+#define TEST_PUMP 1024 /**< Register accesses before giving up on an ISR */
+#define TEST_SD_CS BIT(PB1) /**< Chip Select of the card, on PORTB */
+
+/**
+ * @brief Check a condition, report it with its line if it does not hold
+ */
+#define TEST_CHECK(cond) _TEST_check((cond), #cond, __LINE__)
+
+typedef struct
+{
+    const char *name;
+    void (*run)(void);
+} test_t;
+
+static const char *g_test;
+static int g_failed;
+
+static uint8_t g_bus[TEST_BUS_SIZE]; /**< Bytes sent by the driver under test */
+static size_t g_bus_len;
+
+static volatile pin_t g_runtime_pin; /**< Not a constant to the compiler */
+
+//------------------------------------------------------------------------------
+// Helpers
+//------------------------------------------------------------------------------
+/**
+ * @brief Array length, for the tables of known results
+ */
+#define TEST_LEN(array) (sizeof(array) / sizeof((array)[0]))
+
+static void _TEST_check(int ok, const char *cond, int line)
+{
+    if (!ok)
+    {
+        printf("%s:%d: %s: %s\n", __FILE__, line, g_test, cond);
+        g_failed = 1;
+    }
+}
+
+static void _TEST_uart(uint8_t data)
+{
+    if (TEST_BUS_SIZE > g_bus_len)
+    {
+        g_bus[g_bus_len] = data;
+    }
+    ++g_bus_len;
+}
+
+static uint8_t _TEST_spi(uint8_t data)
+{
+    _TEST_uart(data);
+    return ((uint8_t)~data);
+}
+
+/**
+ * @brief Compare the bytes sent since the last call with a string
+ */
+static int _TEST_bus_is(const char *expected)
+{
+    size_t len = strlen(expected);
+    int same;
+
+    HOST_io_sync();
+    same = (len == g_bus_len) && (0 == memcmp(g_bus, expected, len));
+
+    g_bus_len = 0;
+    return (same);
+}
+
+/**
+ * @brief Access a register until `done` holds, to let the model raise the
+ * pending interrupts one by one
+ */
+static void _TEST_pump(int (*done)(void))
+{
+    for (int i = 0; (i < TEST_PUMP) && !done(); ++i)
+    {
+        (void)SREG;
+    }
+}
+
+//------------------------------------------------------------------------------
+// GPIO
+//------------------------------------------------------------------------------
+static void _TEST_gpio_constant(void)
+{
+    PORTB = 0x81;
+    PIN_mode(PIN_PB1, PIN_OUTPUT);
+    TEST_CHECK(BIT(PB1) == DDRB);
+    PIN_write(PIN_PB1, PIN_HIGH);
+    TEST_CHECK((0x81 | BIT(PB1)) == PORTB);
+    PIN_write(PIN_PB1, PIN_LOW);
+    TEST_CHECK(0x81 == PORTB);
+    PIN_mode(PIN_PB1, PIN_INPUT);
+    TEST_CHECK(0x00 == DDRB);
+
+    PINC = BIT(PC2);
+    TEST_CHECK(PIN_HIGH == PIN_read(PIN_PC2));
+    TEST_CHECK(PIN_LOW == PIN_read(PIN_PC3));
+
+    PIN_toggle(PIN_PB5);
+    TEST_CHECK(BIT(PB5) == PINB); // writing 1 to PINx toggles PORTx
+}
+
+static void _TEST_gpio_runtime(void)
+{
+    PORTD = 0x81;
+    g_runtime_pin = PIN_PD5;
+    PIN_mode(g_runtime_pin, PIN_OUTPUT);
+    TEST_CHECK(BIT(PD5) == DDRD);
+    PIN_write(g_runtime_pin, PIN_HIGH);
+    TEST_CHECK((0x81 | BIT(PD5)) == PORTD);
+    PIN_write(g_runtime_pin, PIN_LOW);
+    TEST_CHECK(0x81 == PORTD);
+
+    PIND = BIT(PD5);
+    TEST_CHECK(PIN_HIGH == PIN_read(g_runtime_pin));
+    g_runtime_pin = PIN_PD6;
+    TEST_CHECK(PIN_LOW == PIN_read(g_runtime_pin));
+}
+
+static void _TEST_gpio_led(void)
+{
+    led_t led;
+
+    PORTB = BIT(PB0);
+    led = LED_new(PIN_PB0);
+    TEST_CHECK(BIT(PB0) == DDRB);
+    TEST_CHECK(0x00 == PORTB); // switched off
+    LED_on(led);
+    TEST_CHECK(BIT(PB0) == PORTB);
+    PINB = BIT(PB0); // the model does not loop PORTx back to PINx
+    TEST_CHECK(LED_is_on(led));
+    LED_off(led);
+    TEST_CHECK(0x00 == PORTB);
+}
+
+//------------------------------------------------------------------------------
+// UART rings
+//------------------------------------------------------------------------------
+static int _TEST_uart_rx_done(void)
+{
+    return (!BIT_is_set(UCSR0A, BIT(RXC0)));
+}
+
+static int _TEST_uart_tx_done(void)
+{
+    return (UART_TX_BUFFER_SIZE - 1 == UART_tx_free());
+}
+
+static void _TEST_uart_rx(void)
+{
+    byte_t data = 0;
+
+    UART_init(UART_8N1, UART_RX);
+    sei();
+    for (uint8_t i = 0; i < 5; ++i)
+    {
+        HOST_uart_receive(0x30 + i);
+    }
+    _TEST_pump(_TEST_uart_rx_done);
+    TEST_CHECK(5 == UART_available());
+    for (uint8_t i = 0; i < 5; ++i)
+    {
+        TEST_CHECK(UART_read(&data) && (0x30 + i == data));
+    }
+    TEST_CHECK(!UART_read(&data));
+    TEST_CHECK(0 == UART_available());
+    TEST_CHECK(0 == UART_dropped());
+}
+
+static void _TEST_uart_rx_overflow(void)
+{
+    byte_t data = 0;
+
+    UART_init(UART_8N1, UART_RX);
+    sei();
+    for (uint8_t i = 0; i < UART_RX_BUFFER_SIZE + 8; ++i)
+    {
+        HOST_uart_receive(i);
+    }
+    _TEST_pump(_TEST_uart_rx_done);
+    TEST_CHECK(UART_RX_BUFFER_SIZE - 1 == UART_available());
+    TEST_CHECK(9 == UART_dropped()); // the newest bytes are lost
+    TEST_CHECK(UART_read(&data) && (0 == data));
+}
+
+static void _TEST_uart_tx_direct(void)
+{
+    UART_init(UART_8N1, UART_TX);
+    UART_transmit('A');
+    HOST_io_sync();
+    TEST_CHECK((1 == g_bus_len) && ('A' == g_bus[0]));
+    TEST_CHECK(UART_TX_BUFFER_SIZE - 1 == UART_tx_free());
+}
+
+static void _TEST_uart_tx_ring(void)
+{
+    byte_t src[100];
+    length_t sent;
+
+    for (uint8_t i = 0; i < sizeof(src); ++i)
+    {
+        src[i] = i;
+    }
+    UART_init(UART_8N1, UART_TX);
+    UART_set_overflow(UART_DROP);
+    sei();
+    HOST_uart_stall(1);
+    sent = UART_write(src, sizeof(src));
+    TEST_CHECK(UART_TX_BUFFER_SIZE - 1 == sent);
+    TEST_CHECK(sizeof(src) - sent == UART_dropped());
+    TEST_CHECK(0 == UART_tx_free());
+    HOST_io_sync();
+    TEST_CHECK(0 == g_bus_len);
+
+    HOST_uart_stall(0); // the buffer drains from USART_UDRE_vect
+    _TEST_pump(_TEST_uart_tx_done);
+    UART_drain();
+    TEST_CHECK(sent == g_bus_len);
+    TEST_CHECK(0 == memcmp(src, g_bus, sent));
+    TEST_CHECK(!BIT_is_set(UCSR0B, BIT(UDRIE0)));
+}
+
+static void _TEST_uart_tx_polled(void)
+{
+    byte_t src[UART_TX_BUFFER_SIZE + 4];
+
+    for (uint8_t i = 0; i < sizeof(src); ++i)
+    {
+        src[i] = 0xFF - i;
+    }
+    UART_init(UART_8N1, UART_TX);
+    UART_set_overflow(UART_BLOCK);
+    HOST_uart_stall(1);
+    UART_transmit(src[0]); // buffered, interrupts are disabled
+    HOST_uart_stall(0);
+    TEST_CHECK(sizeof(src) == UART_write(src + 1, sizeof(src) - 1) + 1);
+    UART_drain();
+    TEST_CHECK(sizeof(src) == g_bus_len);
+    TEST_CHECK(0 == memcmp(src, g_bus, sizeof(src)));
+    TEST_CHECK(0 == UART_dropped());
+    UART_set_overflow(UART_DROP);
+}
+
+static void _TEST_uart_tx_polled_drop(void)
+{
+    byte_t src[UART_TX_BUFFER_SIZE + 4];
+
+    for (uint8_t i = 0; i < sizeof(src); ++i)
+    {
+        src[i] = 0x80 + i;
+    }
+    UART_init(UART_8N1, UART_TX);
+    UART_set_overflow(UART_DROP);
+    HOST_uart_stall(1);
+    UART_transmit(src[0]); // buffered, interrupts are disabled
+    HOST_uart_stall(0);
+    TEST_CHECK(sizeof(src) == UART_write(src + 1, sizeof(src) - 1) + 1);
+    UART_drain();
+    TEST_CHECK(sizeof(src) == g_bus_len); // boot output is not dropped
+    TEST_CHECK(0 == memcmp(src, g_bus, sizeof(src)));
+    TEST_CHECK(0 == UART_dropped());
+}
+
+//------------------------------------------------------------------------------
+// SPI arbiter
+//------------------------------------------------------------------------------
+static void _TEST_spi_devices(void)
+{
+    spi_device_t a = SPI_device_new(PIN_PB1, SPI_MSB, SPI_MODE0, SPI_PS2);
+    spi_device_t b = SPI_device_new(PIN_PD7, SPI_LSB, SPI_MODE3, SPI_PS16);
+
+    TEST_CHECK(a.spcr == SPCR); // the first device initializes the bus
+    TEST_CHECK(BIT_is_set(SPSR, BIT(SPI2X)));
+    TEST_CHECK(BIT_is_set(DDRB, BIT(PB1)) && BIT_is_set(PORTB, BIT(PB1)));
+    TEST_CHECK(BIT_is_set(DDRD, BIT(PD7)) && BIT_is_set(PORTD, BIT(PD7)));
+
+    SPI_begin(&b);
+    TEST_CHECK(b.spcr == SPCR);
+    TEST_CHECK(!BIT_is_set(SPSR, BIT(SPI2X)));
+    TEST_CHECK(!BIT_is_set(PORTD, BIT(PD7)));
+    TEST_CHECK(BIT_is_set(PORTB, BIT(PB1)));
+    SPI_end(&b);
+    TEST_CHECK(BIT_is_set(PORTD, BIT(PD7)));
+
+    SPI_begin(&a);
+    TEST_CHECK(a.spcr == SPCR);
+    TEST_CHECK(BIT_is_set(SPSR, BIT(SPI2X)));
+    TEST_CHECK(!BIT_is_set(PORTB, BIT(PB1)));
+    SPI_end(&a);
+}
+
+static void _TEST_spi_foreign(void)
+{
+    spi_device_t a = SPI_device_new(PIN_PB1, SPI_MSB, SPI_MODE0, SPI_PS4);
+
+    SPCR = BIT(SPE) | BIT(MSTR) | SPI_MODE2; // a driver of its own
+    SPSR = BIT(SPI2X);
+    SPI_acquire(&a);
+    TEST_CHECK(a.spcr == SPCR);
+    TEST_CHECK(!BIT_is_set(SPSR, BIT(SPI2X)));
+    TEST_CHECK(BIT_is_set(PORTB, BIT(PB1))); // left to the driver
+}
+
+static void _TEST_spi_transfer(void)
+{
+    static const byte_t src[] = {0x01, 0x80, 0x5A, 0xA5};
+    spi_device_t a = SPI_device_new(PIN_PB1, SPI_MSB, SPI_MODE0, SPI_PS2);
+    byte_t dst[3];
+
+    HOST_spi_hook(_TEST_spi);
+    SPI_begin(&a);
+    SPI_write(src, sizeof(src));
+    SPI_fill16(0x1234, 2);
+    TEST_CHECK(0x00 == SPI_receive()); // the slave inverts the dummy byte
+    SPI_read(dst, sizeof(dst));
+    SPI_end(&a);
+    HOST_io_sync();
+    HOST_spi_hook(NULL);
+
+    TEST_CHECK(sizeof(src) + 4 + 1 + sizeof(dst) == g_bus_len);
+    TEST_CHECK(0 == memcmp(src, g_bus, sizeof(src)));
+    TEST_CHECK((0x12 == g_bus[4]) && (0x34 == g_bus[5]));
+    TEST_CHECK((0x12 == g_bus[6]) && (0x34 == g_bus[7]));
+    TEST_CHECK(0xFF == g_bus[8]);
+    for (size_t i = 0; i < sizeof(dst); ++i)
+    {
+        TEST_CHECK(0x00 == dst[i]);
+    }
+}
+
+//------------------------------------------------------------------------------
+// TWI queue
+//------------------------------------------------------------------------------
+#define TEST_TWI_ADDR 0x42
+
+static const uint8_t g_twi_frame[] = {0x00, 0x03, 0x11, 0x22, 0x33};
+static uint8_t g_twi_index;
+static uint8_t g_twi_starts;
+static uint8_t g_twi_rx[8];
+static uint8_t g_twi_done;
+
+static int _TEST_twi_start(uint8_t addr_rw)
+{
+    ++g_twi_starts;
+    g_twi_index = 0;
+    return (TEST_TWI_ADDR == (addr_rw >> 1));
+}
+
+static uint8_t _TEST_twi_read(int ack)
+{
+    (void)ack;
+    return ((sizeof(g_twi_frame) > g_twi_index) ? g_twi_frame[g_twi_index++]
+                                                : 0xFF);
+}
+
+static const host_twi_t g_twi = {
+    .start = _TEST_twi_start,
+    .read = _TEST_twi_read,
+};
+
+static void _TEST_twi_again(i2c_xfer_t *xfer)
+{
+    TEST_CHECK((0 == xfer->status) && (3 == xfer->count));
+    TEST_CHECK(0 == memcmp(g_twi_rx, g_twi_frame + 2, 3));
+    if (2 > ++g_twi_done)
+    {
+        TEST_CHECK(i2c_submit(xfer));
+    } // the queue is empty, the callback starts the next transfer
+}
+
+static int _TEST_twi_idle(void)
+{
+    return (!i2c_busy());
+}
+
+static void _TEST_i2c_resubmit(void)
+{
+    i2c_xfer_t xfer = {
+        .addr = TEST_TWI_ADDR,
+        .rx = g_twi_rx,
+        .rx_len = sizeof(g_twi_rx),
+        .flags = I2C_XFER_PACKET,
+        .done = _TEST_twi_again,
+    };
+
+    g_twi_starts = 0;
+    g_twi_done = 0;
+    HOST_twi_hook(&g_twi);
+    i2c_init();
+    sei();
+    TEST_CHECK(i2c_submit(&xfer));
+    _TEST_pump(_TEST_twi_idle);
+    TEST_CHECK(2 == g_twi_done);
+    TEST_CHECK(2 == g_twi_starts); // one START per transfer
+    TEST_CHECK(0 == xfer.status);
+    HOST_twi_hook(NULL);
+}
+
+//------------------------------------------------------------------------------
+// Number formatting
+//------------------------------------------------------------------------------
+static void _TEST_fmt_int(void)
+{
+    static const struct
+    {
+        int32_t n;
+        const char *text;
+    } i16[] = {
+        {0, "0"}, {7, "7"}, {-42, "-42"}, {32767, "32767"},
+        {-32768, "-32768"},
+    }, i32[] = {
+        {100000, "100000"}, {-100000, "-100000"},
+        {2147483647L, "2147483647"}, {-2147483647L - 1, "-2147483648"},
+    };
+    static const struct
+    {
+        uint32_t n;
+        const char *text;
+    } u32[] = {
+        {0, "0"}, {65535, "65535"}, {65536, "65536"},
+        {4294967295UL, "4294967295"},
+    };
+    char buf[FMT_BUFFER_SIZE];
+
+    for (size_t i = 0; i < TEST_LEN(i16); ++i)
+    {
+        TEST_CHECK(strlen(i16[i].text) == FMT_i16(buf, (int16_t)i16[i].n));
+        TEST_CHECK(0 == strcmp(i16[i].text, buf));
+    }
+    for (size_t i = 0; i < TEST_LEN(i32); ++i)
+    {
+        TEST_CHECK(strlen(i32[i].text) == FMT_i32(buf, i32[i].n));
+        TEST_CHECK(0 == strcmp(i32[i].text, buf));
+    }
+    for (size_t i = 0; i < TEST_LEN(u32); ++i)
+    {
+        TEST_CHECK(strlen(u32[i].text) == FMT_u32(buf, u32[i].n));
+        TEST_CHECK(0 == strcmp(u32[i].text, buf));
+    }
+    TEST_CHECK((5 == FMT_u16(buf, 65535)) && (0 == strcmp("65535", buf)));
+}
+
+static void _TEST_fmt_fixed(void)
+{
+    static const struct
+    {
+        int32_t n;
+        byte_t decimals;
+        const char *text;
+    } fixed[] = {
+        {-5, 1, "-0.5"},     {1234, 2, "12.34"},
+        {7, 3, "0.007"},     {100, 2, "1.00"},
+        {-1234, 0, "-1234"}, {0, 2, "0.00"},
+        {-2147483647L - 1, 9, "-2.147483648"},
+    };
+    static const struct
+    {
+        uint32_t n;
+        length_t digits;
+        const char *text;
+    } hex[] = {
+        {0, 1, "0"}, {0xAB, 1, "AB"}, {0xAB, 4, "00AB"},
+        {0xDEADBEEFUL, 1, "DEADBEEF"},
+    };
+    char buf[FMT_BUFFER_SIZE];
+
+    for (size_t i = 0; i < TEST_LEN(fixed); ++i)
+    {
+        TEST_CHECK(strlen(fixed[i].text) ==
+                   FMT_fixed(buf, fixed[i].n, fixed[i].decimals));
+        TEST_CHECK(0 == strcmp(fixed[i].text, buf));
+    }
+    for (size_t i = 0; i < TEST_LEN(hex); ++i)
+    {
+        TEST_CHECK(strlen(hex[i].text) ==
+                   FMT_hex(buf, hex[i].n, hex[i].digits));
+        TEST_CHECK(0 == strcmp(hex[i].text, buf));
+    }
+}
+
+static void _TEST_util_itoa(void)
+{
+    static const struct
+    {
+        int n;
+        length_t width;
+        const char *itoa;
+        const char *decimal;
+    } table[] = {
+        {0, 0, "0", "0.0"},
+        {6, 0, "6", "0.6"},
+        {10, 4, "  10", " 1.0"},
+        {-42, 6, "   -42", "  -4.2"},
+        {-9, 5, "   -9", " -0.9"},
+        {1234, 2, "1234", "123.4"},
+        {-32768, 7, " -32768", "-3276.8"},
+    };
+
+    for (size_t i = 0; i < TEST_LEN(table); ++i)
+    {
+        TEST_CHECK(0 == strcmp(table[i].itoa,
+                               UTIL_itoa(table[i].n, table[i].width)));
+        TEST_CHECK(0 == strcmp(table[i].decimal,
+                               UTIL_itoa_decimal(table[i].n, table[i].width)));
+    }
+}
+
+//------------------------------------------------------------------------------
+// Serial output
+//------------------------------------------------------------------------------
+static void _TEST_serial_printf(void)
+{
+    SERIAL_init(); // polled, the interrupts are disabled
+    SERIAL_printf_P(PSTR("%d|%i"), -42, 7);
+    TEST_CHECK(_TEST_bus_is("-42|7"));
+    SERIAL_printf_P(PSTR("%5d|%-3d"), -42, 5); // no left justification
+    TEST_CHECK(_TEST_bus_is("  -42|-3d"));
+    SERIAL_printf_P(PSTR("%05d|%05d|%02d"), -42, 42, -123);
+    TEST_CHECK(_TEST_bus_is("-0042|00042|-123"));
+    SERIAL_printf_P(PSTR("%u|%05u|%3u"), 65535U, 42U, 12345U);
+    TEST_CHECK(_TEST_bus_is("65535|00042|12345"));
+    SERIAL_printf_P(PSTR("%d|%d"), 32767, -32768);
+    TEST_CHECK(_TEST_bus_is("32767|-32768"));
+    SERIAL_printf_P(PSTR("%ld|%8ld|%lu"), (int32_t)-100000,
+                    (int32_t)-100000, (uint32_t)4294967295UL);
+    TEST_CHECK(_TEST_bus_is("-100000| -100000|4294967295"));
+    SERIAL_printf_P(PSTR("%x|%04X|%08lx"), 0xABU, 0xABU, (uint32_t)0xBEEFUL);
+    TEST_CHECK(_TEST_bus_is("AB|00AB|0000BEEF"));
+    SERIAL_printf_P(PSTR("%c%s%S|100%%"), 'a', "bc", PSTR("de"));
+    TEST_CHECK(_TEST_bus_is("abcde|100%"));
+    SERIAL_printf_P(PSTR("end %"));
+    TEST_CHECK(_TEST_bus_is("end "));
+}
+
+//------------------------------------------------------------------------------
+// Gas packet, encoded as the car forwards the module reading
+//------------------------------------------------------------------------------
+static void _TEST_gas_encode(const uint8_t *buffer, packet_t *packet)
+{
+    memset(packet, 0, sizeof(*packet));
+    packet->header.id = PACKET_ID_GAS;
+    packet->gas.co2 = (uint16_t)((buffer[IDX_CO2] << 8) | buffer[IDX_CO2 + 1]);
+    packet->gas.co = (uint16_t)((buffer[IDX_CO] << 8) | buffer[IDX_CO + 1]);
+    packet->gas.nh3 = (uint16_t)((buffer[IDX_NH3] << 8) | buffer[IDX_NH3 + 1]);
+    packet->gas.no2 = (uint16_t)((buffer[IDX_NO2] << 8) | buffer[IDX_NO2 + 1]);
+    packet->gas.o2 = (uint16_t)((buffer[IDX_O2] << 8) | buffer[IDX_O2 + 1]);
+    packet->gas.temp = (int8_t)((int8_t)buffer[IDX_TEMP] - CO2_TEMP_OFFSET);
+    packet->gas.status = buffer[IDX_STATUS];
+}
+
+static void _TEST_packet_gas(void)
+{
+    static const struct
+    {
+        uint8_t frame[GAS_SIZE];  /**< Big endian, from the module */
+        uint8_t packet[16];       /**< Little endian, to the radio */
+    } table[] = {
+        {
+            {0x00, 0x0C, 0x01, 0x90, 0x00, 0x05, 0x00, 0x12, 0x00, 0x03,
+             0x52, 0x08, 0x41, 0x0D},
+            {PACKET_ID_GAS, 0x00, 0x00, 0x90, 0x01, 0x05, 0x00, 0x12, 0x00,
+             0x03, 0x00, 0x08, 0x52, 0x15, 0x0D, 0x00},
+        }, // 400 ppm CO2, 21 degrees
+        {
+            {0x00, 0x0C, 0xFF, 0xFF, 0x12, 0x34, 0x00, 0x00, 0x80, 0x00,
+             0x00, 0x01, 0x20, 0x02},
+            {PACKET_ID_GAS, 0x00, 0x00, 0xFF, 0xFF, 0x34, 0x12, 0x00, 0x00,
+             0x00, 0x80, 0x01, 0x00, 0xF4, 0x02, 0x00},
+        }, // -12 degrees, still preheating
+    };
+    static const uint8_t zero[PACKET_SIZE] = {0};
+    packet_t packet;
+
+    TEST_CHECK(PACKET_SIZE == sizeof(packet_t)); // packed as on the target
+    for (size_t i = 0; i < TEST_LEN(table); ++i)
+    {
+        _TEST_gas_encode(table[i].frame, &packet);
+        TEST_CHECK(0 == memcmp(table[i].packet, packet.buffer,
+                               sizeof(table[i].packet)));
+        TEST_CHECK(0 == memcmp(zero, packet.buffer + sizeof(table[i].packet),
+                               PACKET_SIZE - sizeof(table[i].packet)));
+    }
+}
+
+//------------------------------------------------------------------------------
+// BME280 compensation
+//------------------------------------------------------------------------------
+static void _TEST_bme280(void)
+{
+    struct bme_calib calib = {
+        .dig_T1 = 27504,
+        .dig_T2 = 26435,
+        .dig_T3 = -1000,
+        .dig_P1 = 36477,
+        .dig_P2 = -10685,
+        .dig_P3 = 3024,
+        .dig_P4 = 2855,
+        .dig_P5 = 140,
+        .dig_P6 = -7,
+        .dig_P7 = 15500,
+        .dig_P8 = -14600,
+        .dig_P9 = 6000,
+        .dig_H1 = 75,
+        .dig_H2 = 362,
+        .dig_H3 = 0,
+        .dig_H4 = 324,
+        .dig_H5 = 50,
+        .dig_H6 = 30,
+    }; // calibration of the datasheet example, humidity made up
+    static const struct
+    {
+        int32_t adc;
+        int32_t t_fine;
+        int32_t t; /**< 0.01 degree */
+    } temperature[] = {
+        {519888, 128422, 2508}, // datasheet: 25.08 degrees
+        {400000, -64736, -1264},
+        {600000, 256562, 5011},
+    };
+    static const struct
+    {
+        int32_t adc;
+        uint32_t h; /**< 1/1024 %RH */
+    } humidity[] = {
+        {0, 0}, {25000, 23681}, {30000, 52306}, {35000, 80697},
+    }; // Bosch reference formula, at t_fine 128422
+
+    for (size_t i = 0; i < TEST_LEN(temperature); ++i)
+    {
+        TEST_CHECK(temperature[i].t ==
+                   BME280_compensate_T_int32(temperature[i].adc, &calib));
+        TEST_CHECK(temperature[i].t_fine == calib.t_fine);
+    }
+
+    BME280_compensate_T_int32(519888, &calib);
+    // datasheet: 100653.27 Pa from the floating point formula, the 64-bit
+    // integer one gives 25767233 / 256 = 100653.25 Pa
+    TEST_CHECK(25767233UL == BME280_compensate_P_int64(415148, &calib));
+    for (size_t i = 0; i < TEST_LEN(humidity); ++i)
+    {
+        TEST_CHECK(humidity[i].h ==
+                   bme280_compensate_H_int32(humidity[i].adc, &calib));
+    }
+}
+
+//------------------------------------------------------------------------------
+// JSON log on the FAT16 RAM disk of `host/bench/sdcard.c`
+//------------------------------------------------------------------------------
+
+/**
+ * @brief Read a file of the root directory of the RAM disk
+ * @return Size of the file, `-1` if it is not found or larger than `size`
+ */
+static long _TEST_sd_file(const char *name83, char *dst, size_t size)
+{
+    const uint8_t *boot = SDCARD_sector(0);
+    uint16_t reserved = (uint16_t)(boot[0x0E] | (boot[0x0F] << 8));
+    uint16_t entries = (uint16_t)(boot[0x11] | (boot[0x12] << 8));
+    uint16_t fat_sectors = (uint16_t)(boot[0x16] | (boot[0x17] << 8));
+    uint32_t root = reserved + (uint32_t)boot[0x10] * fat_sectors;
+    uint32_t data = root + (entries * 32UL + 511) / 512;
+
+    for (uint16_t e = 0; e < entries; ++e)
+    {
+        const uint8_t *ent = SDCARD_sector(root + e / 16) + (e % 16) * 32;
+        uint16_t cluster;
+        uint32_t len;
+
+        if (0 != memcmp(ent, name83, 11))
+        {
+            continue;
+        }
+        cluster = (uint16_t)(ent[0x1A] | (ent[0x1B] << 8));
+        len = (uint32_t)ent[0x1C] | ((uint32_t)ent[0x1D] << 8) |
+              ((uint32_t)ent[0x1E] << 16) | ((uint32_t)ent[0x1F] << 24);
+        if ((size < len) || (512 < len))
+        {
+            return (-1);
+        } // the first sector is enough here
+        memcpy(dst, SDCARD_sector(data + (cluster - 2UL) * boot[0x0D]), len);
+        return ((long)len);
+    }
+    return (-1);
+}
+
+static void _TEST_sd_json(void)
+{
+    static const char first[] = "[\n{\"temp\": 32.07},\n{\"hum\": 65.30},\n]";
+    static const char second[] =
+        "[\n{\"temp\": 32.07},\n{\"hum\": 65.30},\n{\"temp\": -0.5},\n]";
+    char file[512];
+
+    if (!SDCARD_init(&PORTB, TEST_SD_CS))
+    {
+        TEST_CHECK(!"RAM disk");
+        return;
+    }
+    HOST_spi_hook(SDCARD_exchange);
+    TEST_CHECK(SD_OK == SD_init(&DDRB, &PORTB, TEST_SD_CS));
+    TEST_CHECK(SD_ERR_NOTFOUND == SD_json_open("log"));
+
+    TEST_CHECK(SD_OK == SD_json_create("log"));
+    TEST_CHECK(SD_OK == SD_json_append("temp", "32.07"));
+    TEST_CHECK(SD_OK == SD_json_append("hum", "65.30"));
+    TEST_CHECK(SD_OK == SD_json_close());
+    TEST_CHECK((long)strlen(first) ==
+               _TEST_sd_file("LOG     TXT", file, sizeof(file)));
+    TEST_CHECK(0 == memcmp(first, file, strlen(first)));
+
+    TEST_CHECK(SD_OK == SD_json_open("LOG")); // after the closing "\n]"
+    TEST_CHECK(SD_OK == SD_json_append("temp", "-0.5"));
+    TEST_CHECK(SD_OK == SD_json_close());
+    TEST_CHECK((long)strlen(second) ==
+               _TEST_sd_file("LOG     TXT", file, sizeof(file)));
+    TEST_CHECK(0 == memcmp(second, file, strlen(second)));
+    HOST_spi_hook(NULL);
+}
+
+//------------------------------------------------------------------------------
+// ADC
+//------------------------------------------------------------------------------
+static unsigned g_adc_conversions;
+
+static uint16_t _TEST_adc(uint8_t channel)
+{
+    ++g_adc_conversions;
+    return ((uint16_t)(100 + channel));
+}
+
+static int _TEST_adc_scanned(void)
+{
+    return (2 <= ADC_scan_count());
+}
+
+static void _TEST_adc_scan_stop(void)
+{
+    static const adc_ch_t channels[] = {ADC_CH0, ADC_CH1};
+    uint16_t samples[2] = {0};
+    unsigned conversions;
+
+    HOST_adc_hook(_TEST_adc);
+    ADC_init(ADC_AVCC, ADC_10BIT, ADC_PS128);
+    ADC_enable_channel(ADC_CH0);
+    ADC_enable_channel(ADC_CH1);
+    ADC_scan_oversample(2); // stopped between two passes of a sample
+    sei();
+    ADC_scan_start(channels, 2);
+    _TEST_pump(_TEST_adc_scanned);
+    ADC_scan_stop();
+    TEST_CHECK(BIT_is_clear(ADCSRA, BIT(ADIE)));
+    TEST_CHECK(BIT_is_clear(ADCSRA, BIT(ADSC)));
+    TEST_CHECK(BIT_is_clear(ADCSRA, BIT(ADIF)));
+    TEST_CHECK(ADC_scan_read(samples));
+    TEST_CHECK((100 == samples[0]) && (101 == samples[1]));
+
+    conversions = g_adc_conversions;
+    if (BIT_is_clear(ADCSRA, BIT(ADIE))) // or the ISR takes the result
+    {
+        TEST_CHECK(101 == ADC_read(ADC_CH1));
+    }
+    TEST_CHECK(conversions + 1 == g_adc_conversions); // nothing restarted
+
+    ADC_enable_interrupt(); // the scan handler would disable it again
+    ADC_start();
+    (void)SREG;
+    TEST_CHECK(BIT_is_clear(ADCSRA, BIT(ADIF))); // taken by the ISR
+    TEST_CHECK(BIT_is_set(ADCSRA, BIT(ADIE)));
+    cli();
+    ADC_disable_interrupt();
+    ADC_scan_oversample(0);
+    HOST_adc_hook(NULL);
+}
+
+//------------------------------------------------------------------------------
+// Tests
+//------------------------------------------------------------------------------
+static const test_t g_tests[] = {
+    {"gpio_constant", _TEST_gpio_constant},
+    {"gpio_runtime", _TEST_gpio_runtime},
+    {"gpio_led", _TEST_gpio_led},
+    {"uart_rx", _TEST_uart_rx},
+    {"uart_rx_overflow", _TEST_uart_rx_overflow},
+    {"uart_tx_direct", _TEST_uart_tx_direct},
+    {"uart_tx_ring", _TEST_uart_tx_ring},
+    {"uart_tx_polled", _TEST_uart_tx_polled},
+    {"uart_tx_polled_drop", _TEST_uart_tx_polled_drop},
+    {"spi_devices", _TEST_spi_devices},
+    {"spi_foreign", _TEST_spi_foreign},
+    {"spi_transfer", _TEST_spi_transfer},
+    {"i2c_resubmit", _TEST_i2c_resubmit},
+    {"adc_scan_stop", _TEST_adc_scan_stop},
+    {"fmt_int", _TEST_fmt_int},
+    {"fmt_fixed", _TEST_fmt_fixed},
+    {"util_itoa", _TEST_util_itoa},
+    {"serial_printf", _TEST_serial_printf},
+    {"packet_gas", _TEST_packet_gas},
+    {"bme280", _TEST_bme280},
+    {"sd_json", _TEST_sd_json},
+};
+
+#define TEST_COUNT (sizeof(g_tests) / sizeof(g_tests[0]))
+
+static int _TEST_selected(const char *name, int argc, char **argv)
+{
+    if (argc < 2)
+    {
+        return (1);
+    }
+    for (int i = 1; i < argc; ++i)
+    {
+        if (0 == strcmp(name, argv[i]))
+        {
+            return (1);
+        }
+    }
+    return (0);
+}
+
+int main(int argc, char **argv)
+{
+    size_t run = 0;
+
+    HOST_uart_hook(_TEST_uart);
+    for (size_t i = 0; i < TEST_COUNT; ++i)
+    {
+        if (!_TEST_selected(g_tests[i].name, argc, argv))
+        {
+            continue;
+        }
+        g_test = g_tests[i].name;
+        g_bus_len = 0;
+        HOST_io_reset();
+        g_tests[i].run();
+        ++run;
+    }
+    printf("%zu tests, %s\n", run, g_failed ? "FAILED" : "passed");
+    return (g_failed);
+}
@@ -14,6 +14,9 @@
 
 #define ADC_VALUE_MAX 0x3F /**< Maximum value of ADC 10-bit result */
 
+#define ADC_SCAN_MAX 8 /**< Maximum number of channels in a scan */
+#define ADC_SCAN_OVERSAMPLE_MAX 6 /**< 64 conversions per sample */
+
 //------------------------------------------------------------------------------
 // Enumerations
 //------------------------------------------------------------------------------
@@ -340,6 +343,57 @@ inline void ADC_disable_interrupt(void)
  */
 void ADC_attach_interrupt(void (*on_complete)(uint16_t));
 
+//------------------------------------------------------------------------------
+// Scan Sequencer
+//------------------------------------------------------------------------------
+
+/**
+ * @brief Convert a list of channels continuously in the background
+ * @param channels Channels to convert, in order
+ * @param count Number of channels, at most `ADC_SCAN_MAX`
+ * @note The ADC must be initialized and the channels enabled. The scan owns
+ * the ADC interrupt: `ADC_read` and `ADC_attach_interrupt` must not be used
+ * until `ADC_scan_stop` is called. Requires the global interrupts.
+ * @see ADC_scan_read
+ * @ingroup adc_advanced
+ */
+void ADC_scan_start(const adc_ch_t *channels, length_t count);
+
+/**
+ * @brief Average several consecutive conversions of each channel
+ * @param shift log2 of the number of conversions per sample, 0 to disable,
+ * at most `ADC_SCAN_OVERSAMPLE_MAX`
+ * @note Call before `ADC_scan_start`. The scan rate is divided by `2^shift`.
+ * @ingroup adc_advanced
+ */
+void ADC_scan_oversample(byte_t shift);
+
+/**
+ * @brief Stop the background scan
+ * @details Waits for the conversion in progress, then disables the ADC
+ * interrupt and detaches the scan handler: `ADC_read` can be used again.
+ * The last complete set stays readable with `ADC_scan_read`.
+ * @ingroup adc_advanced
+ */
+void ADC_scan_stop(void);
+
+/**
+ * @brief Copy the latest complete set of samples
+ * @param samples Buffer of at least `count` values, in the order of the
+ * channels given to `ADC_scan_start`
+ * @return `TRUE` if a complete set was copied, `FALSE` if the first scan has
+ * not finished yet
+ * @ingroup adc_advanced
+ */
+bool_t ADC_scan_read(uint16_t *samples);
+
+/**
+ * @brief Return the number of complete scans, wraps around
+ * @return Scan counter, changes every time a new set is published
+ * @ingroup adc_advanced
+ */
+byte_t ADC_scan_count(void);
+
 #endif // VEMAR_ADC_H
 
 /**
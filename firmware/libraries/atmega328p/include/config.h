@@ -51,9 +51,58 @@
 
 #endif
 
+/**
+ * @brief Size of the UART transmit ring buffer (power of 2, up to 256)
+ */
+#ifndef UART_TX_BUFFER_SIZE
+#define UART_TX_BUFFER_SIZE 64
+#endif // UART_TX_BUFFER_SIZE
+
+/**
+ * @brief Size of the UART receive ring buffer (power of 2, up to 256)
+ */
+#ifndef UART_RX_BUFFER_SIZE
+#define UART_RX_BUFFER_SIZE 32
+#endif // UART_RX_BUFFER_SIZE
+
 /**
  * @brief Debounce time in milliseconds
  */
 #define DEBOUNCE_TIME 10
 
+/**
+ * @brief Maximum number of functions attached to the system tick
+ */
+#ifndef TIMER_TICK_HOOK_MAX
+#define TIMER_TICK_HOOK_MAX 4
+#endif // TIMER_TICK_HOOK_MAX
+
+/**
+ * @brief Maximum number of tasks of the scheduler
+ */
+#ifndef SCHED_TASK_MAX
+#define SCHED_TASK_MAX 8
+#endif // SCHED_TASK_MAX
+
+/**
+ * @brief Sampling period of the button debouncing service in milliseconds
+ */
+#ifndef BUTTON_SAMPLE_PERIOD
+#define BUTTON_SAMPLE_PERIOD 2
+#endif // BUTTON_SAMPLE_PERIOD
+
+/**
+ * @brief Maximum number of buttons registered to the debouncing service
+ */
+#ifndef BUTTON_MAX
+#define BUTTON_MAX 8
+#endif // BUTTON_MAX
+
+/**
+ * @brief Size of the deferred event queue (power of 2, up to 256)
+ */
+#ifndef EVENT_QUEUE_SIZE
+#define EVENT_QUEUE_SIZE 8
+#endif // EVENT_QUEUE_SIZE
+
 #endif // VEMAR_CONFIG_H
@@ -0,0 +1,73 @@
+#ifndef VEMAR_EVENT_H
+#define VEMAR_EVENT_H
+
+#include "common.h"
+
+/**
+ * @brief Event, its meaning is defined by the board
+ */
+typedef byte_t event_t;
+
+/**
+ * @brief Queue an event
+ * @param ev Event to queue
+ * @return `TRUE` if queued, `FALSE` if the queue is full and the event dropped
+ * @note Producer side: call it from interrupt handlers only, or with the
+ * interrupts disabled
+ */
+bool_t EVENT_post(event_t ev);
+
+/**
+ * @brief Take the oldest queued event
+ * @param ev Event taken
+ * @return `TRUE` if an event was taken, `FALSE` if the queue is empty
+ * @note Consumer side: call it from the main loop only
+ */
+bool_t EVENT_get(event_t *ev);
+
+/**
+ * @brief Check whether events are waiting
+ * @return `TRUE` if the queue is not empty
+ */
+bool_t EVENT_pending(void);
+
+/**
+ * @brief Get the number of events dropped since the start
+ * @return Dropped events, saturates at 255
+ */
+byte_t EVENT_dropped(void);
+
+#endif // VEMAR_EVENT_H
+
+/**
+ * @file event.h
+ * @brief Deferred event queue, from interrupt handlers to the main loop
+ * @author Christian Hugon <chriss.hugon@gmail.com>
+ * @version 1.0.0
+ * @details
+ * An interrupt handler has to return fast: drawing or talking to a device on
+ * the shared SPI bus from there blocks every other interrupt and may land in
+ * the middle of a transaction of the main loop. Handlers only post an event,
+ * the main loop takes it at a safe point and does the work.
+ *
+ * The queue is a single-producer single-consumer ring and takes no lock.
+ * Interrupt handlers do not nest, so all of them together are the producer,
+ * and the main loop is the consumer. Each side writes only its own index, a
+ * single byte that the other side reads atomically.
+ * ```
+ * ISR(PCINT1_vect)
+ * {
+ *      EVENT_post(EVENT_BUTTON);
+ * }
+ *
+ * void loop(void)
+ * {
+ *      event_t ev;
+ *
+ *      while (EVENT_get(&ev))
+ *      {
+ *          handle(ev);
+ *      }
+ * }
+ * ```
+ */
@@ -0,0 +1,87 @@
+#ifndef VEMAR_FMT_H
+#define VEMAR_FMT_H
+
+#include "typedef.h"
+
+/**
+ * @brief Size of a buffer large enough for any conversion of this module,
+ * sign, 10 digits, decimal point and null-terminator
+ */
+#define FMT_BUFFER_SIZE 13
+
+/**
+ * @brief Convert an unsigned 16-bit number to decimal
+ * @param buf Buffer of at least 6 bytes
+ * @param n Number to convert
+ * @return Length of the null-terminated string
+ */
+length_t FMT_u16(char *buf, uint16_t n);
+
+/**
+ * @brief Convert a signed 16-bit number to decimal
+ * @param buf Buffer of at least 7 bytes
+ * @param n Number to convert
+ * @return Length of the null-terminated string
+ */
+length_t FMT_i16(char *buf, int16_t n);
+
+/**
+ * @brief Convert an unsigned 32-bit number to decimal
+ * @param buf Buffer of at least 11 bytes
+ * @param n Number to convert
+ * @return Length of the null-terminated string
+ */
+length_t FMT_u32(char *buf, uint32_t n);
+
+/**
+ * @brief Convert a signed 32-bit number to decimal
+ * @param buf Buffer of at least 12 bytes
+ * @param n Number to convert
+ * @return Length of the null-terminated string
+ */
+length_t FMT_i32(char *buf, int32_t n);
+
+/**
+ * @brief Convert a fixed-point number to decimal
+ * @param buf Buffer of `FMT_BUFFER_SIZE` bytes
+ * @param n Number to convert, scaled by `10^decimals`
+ * @param decimals Number of digits after the decimal point (0 to 9)
+ * @return Length of the null-terminated string
+ * @details
+ * For instance: `FMT_fixed(buf, -5, 1)` gives "-0.5", `FMT_fixed(buf, 1234, 2)`
+ * gives "12.34"
+ */
+length_t FMT_fixed(char *buf, int32_t n, byte_t decimals);
+
+/**
+ * @brief Convert a number to uppercase hexadecimal
+ * @param buf Buffer of at least 9 bytes
+ * @param n Number to convert
+ * @param digits Minimum number of digits, padded with `'0'` (1 to 8)
+ * @return Length of the null-terminated string
+ */
+length_t FMT_hex(char *buf, uint32_t n, length_t digits);
+
+/**
+ * @brief Right justify a string in place
+ * @param buf Buffer of at least `width + 1` bytes holding the string
+ * @param len Length of the string
+ * @param width Minimum width, the string is padded with `' '` on the left
+ * @return Length of the justified string
+ */
+length_t FMT_justify(char *buf, length_t len, length_t width);
+
+#endif // VEMAR_FMT_H
+
+/**
+ * @file fmt.h
+ * @brief Number formatting
+ * @author Christian Hugon <chriss.hugon@gmail.com>
+ * @version 1.0.0
+ * @details
+ * The AVR has no hardware divider: a 32-bit division by 10 calls
+ * `__udivmodsi4`, which loops over every bit. Decimal conversions here divide
+ * by 10 with a reciprocal multiplication (16-bit) or shifts and adds (32-bit)
+ * and write into a buffer owned by the caller, so they can be used from an
+ * interrupt.
+ */
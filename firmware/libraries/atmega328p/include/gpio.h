@@ -79,8 +79,9 @@ typedef struct
  */
 typedef struct
 {
-    pin_t pin;    /**< Pin of the Button */
-    byte_t flags; /**< Button flags */
+    pin_t pin;                /**< Pin of the Button */
+    byte_t flags;             /**< Button flags */
+    volatile byte_t debounce; /**< Debouncing service state */
 } button_t;
 
 /**
@@ -95,6 +96,57 @@ typedef struct
 // PIN configuration functions
 //------------------------------------------------------------------------------
 
+/**
+ * @brief Input register (`PINx`) of a pin
+ */
+#define _PIN_REG_PIN(pin) (_SFR_IO8(0x03 + (((pin) & 0xF0) >> 4)))
+
+/**
+ * @brief Data direction register (`DDRx`) of a pin
+ */
+#define _PIN_REG_DDR(pin) (_SFR_IO8(0x04 + (((pin) & 0xF0) >> 4)))
+
+/**
+ * @brief Output register (`PORTx`) of a pin
+ */
+#define _PIN_REG_PORT(pin) (_SFR_IO8(0x05 + (((pin) & 0xF0) >> 4)))
+
+/**
+ * @brief Bit of a pin in its registers
+ */
+#define _PIN_MASK(pin) ((byte_t)(1 << ((pin) & 0x0F)))
+
+/**
+ * @brief Check whether a pin is known at compile time
+ * @details The registers of a constant pin are constant I/O addresses, an
+ * access compiles to a single `sbi`, `cbi`, `sbis` or `sbic` instruction
+ */
+#define _PIN_IS_CONSTANT(pin) __builtin_constant_p(pin)
+
+/**
+ * @brief Read the state of a pin known at run time only
+ * @see PIN_read
+ */
+pin_state_t _PIN_read(pin_t pin);
+
+/**
+ * @brief Write the state of a pin known at run time only
+ * @see PIN_write
+ */
+void _PIN_write(pin_t pin, pin_state_t state);
+
+/**
+ * @brief Toggle a pin known at run time only
+ * @see PIN_toggle
+ */
+void _PIN_toggle(pin_t pin);
+
+/**
+ * @brief Configure a pin known at run time only
+ * @see PIN_mode
+ */
+void _PIN_mode(pin_t pin, pin_mode_t mode);
+
 /**
  * @brief Read the state from the specified pin
  * @param pin Pin to read
@@ -102,7 +154,15 @@ typedef struct
  * @see pin_t
  * @see pin_state_t
  */
-pin_state_t PIN_read(pin_t pin);
+inline pin_state_t PIN_read(pin_t pin)
+{
+    if (_PIN_IS_CONSTANT(pin))
+    {
+        return (BIT_is_set(_PIN_REG_PIN(pin), _PIN_MASK(pin)) ? PIN_HIGH
+                                                              : PIN_LOW);
+    }
+    return (_PIN_read(pin));
+}
 
 /**
  * @brief Write the state to the specified pin
@@ -111,14 +171,37 @@ pin_state_t PIN_read(pin_t pin);
  * @see pin_t
  * @see pin_state_t
  */
-void PIN_write(pin_t pin, pin_state_t state);
+inline void PIN_write(pin_t pin, pin_state_t state)
+{
+    if (_PIN_IS_CONSTANT(pin))
+    {
+        if (PIN_LOW == state)
+        {
+            BIT_clear(_PIN_REG_PORT(pin), _PIN_MASK(pin));
+        }
+        else
+        {
+            BIT_set(_PIN_REG_PORT(pin), _PIN_MASK(pin));
+        }
+        return;
+    }
+    _PIN_write(pin, state);
+}
 
 /**
  * @brief Toggle the state of the specified pin
  * @param pin Pin to toggle
  * @see pin_t
  */
-void PIN_toggle(pin_t pin);
+inline void PIN_toggle(pin_t pin)
+{
+    if (_PIN_IS_CONSTANT(pin))
+    {
+        _PIN_REG_PIN(pin) = _PIN_MASK(pin); // writing 1 to PINx toggles
+        return;
+    }
+    _PIN_toggle(pin);
+}
 
 /**
  * @brief Configure the specified pin as either input or output
@@ -127,19 +210,40 @@ void PIN_toggle(pin_t pin);
  * @see pin_t
  * @see pin_mode_t
  */
-void PIN_mode(pin_t pin, pin_mode_t mode);
+inline void PIN_mode(pin_t pin, pin_mode_t mode)
+{
+    if (_PIN_IS_CONSTANT(pin))
+    {
+        if (PIN_INPUT == mode)
+        {
+            BIT_clear(_PIN_REG_DDR(pin), _PIN_MASK(pin));
+        }
+        else
+        {
+            BIT_set(_PIN_REG_DDR(pin), _PIN_MASK(pin));
+        }
+        return;
+    }
+    _PIN_mode(pin, mode);
+}
 
 /**
  * @brief Enable internal Pull-up Resistor
  * @param pin Pin whose internal Pull-up Resistor to enable
  */
-void PIN_enable_pullup(pin_t pin);
+inline void PIN_enable_pullup(pin_t pin)
+{
+    PIN_write(pin, PIN_HIGH);
+}
 
 /**
  * @brief Disable internal Pull-up Resistor
  * @param pin Pin whose internal Pull-up Resistor to disable
  */
-void PIN_disable_pullup(pin_t pin);
+inline void PIN_disable_pullup(pin_t pin)
+{
+    PIN_write(pin, PIN_LOW);
+}
 
 //------------------------------------------------------------------------------
 // LED
@@ -213,10 +317,41 @@ button_t BUTTON_new(pin_t pin, button_mode_t mode);
  * @brief Check whether the button is active
  * @param btn Button to check
  * @return `TRUE` if the button is active, otherwise `FALSE`
+ * @note A button registered to the debouncing service returns its latched
+ * event immediately: a press or a release is reported once, a hold as long as
+ * it lasts. An unregistered button is sampled on the spot and waits
+ * `DEBOUNCE_TIME` milliseconds.
  * @see button_t
+ * @see BUTTON_register
  */
 bool_t BUTTON_is_active(button_t *btn);
 
+/**
+ * @brief Add a button to the debouncing service
+ * @param btn Button to register, must stay at the same address
+ * @return `TRUE` if registered, `FALSE` if `BUTTON_MAX` buttons already are
+ * @see BUTTON_service_start
+ */
+bool_t BUTTON_register(button_t *btn);
+
+/**
+ * @brief Sample all registered buttons and update their debounced state
+ * @details Each button runs an integrator counting up while pressed and down
+ * while released, its state changes only when the counter saturates, so it
+ * takes `DEBOUNCE_TIME` milliseconds of stable level to report a press or a
+ * release.
+ * @note Called every `BUTTON_SAMPLE_PERIOD` milliseconds by the service
+ */
+void BUTTON_update(void);
+
+/**
+ * @brief Sample the registered buttons in the background
+ * @return `TRUE` if started, `FALSE` if the system tick has no free hook
+ * @note Runs from the system tick, which must be started with
+ * `TIMER_tick_init_timer0` or `TIMER_tick_init_timer2`
+ */
+bool_t BUTTON_service_start(void);
+
 //------------------------------------------------------------------------------
 // Analog
 //------------------------------------------------------------------------------
@@ -241,5 +376,13 @@ uint16_t ANALOG_read(analog_t analog);
  * @file gpio.h
  * @brief General-Purpose Input/Output
  * @author Christian Hugon <chriss.hugon@gmail.com>
- * @version 1.0.0
+ * @version 1.2.0
+ * @details
+ * The `PIN_` functions are inlined: with a pin known at compile time, such as
+ * a `PIN_PB2` constant, they compile to a single I/O instruction. A pin held
+ * in a variable goes through the run time functions, which compute the
+ * register and the mask on every call.
+ *
+ * Buttons registered with `BUTTON_register` are debounced in the background
+ * once `BUTTON_service_start` is called, `BUTTON_is_active` no longer blocks.
  */
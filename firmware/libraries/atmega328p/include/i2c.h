@@ -13,12 +13,37 @@
 #define I2C_ERR_NACK       (-3)   /* slave sent NACK                    */
 #define I2C_ERR_INVALID_LEN (-4)  /* packet length 0 or > I2C_BUFFER_SIZE */
 #define I2C_ERR_TIMEOUT    (-5)   /* hardware flag never set            */
+#define I2C_PENDING        (1)    /* queued transfer not completed yet  */
 
 /*
  * Utils
  */
-#define TWI_BAUD (((F_CPU / I2C_FREQ) - 10) / 2)
-#define TWBR_VAL (((F_CPU / I2C_FREQ) - 16) / 2)
+#define I2C_FREQ_STANDARD 100000UL
+#define I2C_FREQ_FAST     400000UL
+
+/* f_SCL = F_CPU / (10 + 2 * MBAUD), rise time neglected */
+#define I2C_MBAUD(freq) (((F_CPU / (freq)) - 10) / 2)
+/* f_SCL = F_CPU / (16 + 2 * TWBR), prescaler 1: 72 and 12 at 16 MHz */
+#define I2C_TWBR(freq) (((F_CPU / (freq)) - 16) / 2)
+
+#define TWI_BAUD I2C_MBAUD(I2C_FREQ)
+#define TWBR_VAL I2C_TWBR(I2C_FREQ)
+
+/*
+ * Bus speed per slave, applied at the START of each transaction. I2C_FREQ
+ * is the speed of the slaves without a profile. ATmega328P master only, a
+ * tinyAVR master keeps TWI_BAUD.
+ */
+typedef enum {
+    I2C_STANDARD = 0, /* 100 kHz */
+    I2C_FAST = 1      /* 400 kHz */
+} i2c_speed_t;
+
+#ifndef I2C_PROFILE_MAX
+#define I2C_PROFILE_MAX 4 /* slaves with their own speed */
+#endif
+
+#define I2C_OTHERS 0x80 /* not a 7-bit address: every slave without a profile */
 
 #define I2C_BUFFER_SIZE 64
 
@@ -28,6 +53,33 @@ struct i2cMessage {
     uint16_t current_idx;
 };
 
+/*
+ * Queued transfers, master only, driven by the TWI interrupt
+ */
+#ifndef I2C_QUEUE_SIZE
+#define I2C_QUEUE_SIZE 4 /* power of 2, holds one transfer less */
+#endif
+
+#define I2C_XFER_PACKET 0x01 /* read a 16-bit big-endian length, then data */
+
+typedef struct i2c_xfer i2c_xfer_t;
+
+/* completion, called from the TWI interrupt: keep it short, no bus access */
+typedef void (*i2c_callback_t)(i2c_xfer_t *xfer);
+
+struct i2c_xfer {
+    uint8_t addr;            /* 7-bit slave address */
+    const uint8_t *tx;       /* written first, NULL if tx_len is 0 */
+    uint8_t tx_len;
+    uint8_t *rx;             /* read after a repeated START, or a START */
+    uint8_t rx_len;          /* bytes to read, buffer size with I2C_XFER_PACKET */
+    uint8_t flags;           /* I2C_XFER_* */
+    i2c_callback_t done;     /* NULL to poll status instead */
+    void *arg;               /* free for the callback */
+    volatile int8_t status;  /* I2C_PENDING, then 0 or an I2C_ERR_* code */
+    volatile uint8_t count;  /* bytes stored in rx */
+};
+
 /*
  * Asserts
 */
@@ -48,6 +100,7 @@ extern void i2c_init_slave(uint8_t addr);
 extern void i2c_stop_interface(void);
 extern void i2c_switch_to_master(void);
 extern void i2c_switch_to_slave(void);
+extern bool_t i2c_set_speed(uint8_t addr, i2c_speed_t speed); // FALSE if full
 
 /*
  * Control
@@ -65,6 +118,16 @@ extern int8_t i2c_write_packet(uint8_t addr, uint8_t *data, uint16_t len);
 extern int8_t i2c_read_packet(uint8_t addr, uint8_t *buffer);
 extern int32_t i2c_get_read_len(uint8_t addr);
 
+/*
+ * Queued transfers: the structure and its buffers belong to the bus until
+ * status leaves I2C_PENDING. Do not call the blocking functions above while
+ * a transfer is queued, both drive the same registers. A completion callback
+ * may submit the next transfer, it starts once the callback returns.
+ */
+extern bool_t i2c_submit(i2c_xfer_t *xfer); // FALSE if full or xfer queued
+extern bool_t i2c_busy(void);
+extern void i2c_abort(void); // fail the transfer on the bus with I2C_ERR_TIMEOUT
+
 /*
  * Slave responses
  */
@@ -26,6 +26,12 @@ typedef enum
  * @param cs Chip Select pin
  * @param dc Data/Command pin
  * @param rst Reset pin
+ *
+ * @note The display runs on the hardware SPI, or on USART0 in SPI master
+ * mode when the library is built with `ILI9341_SPI_UART`
+ * @note Building the library with `ILI9341_PIN_CS` and `ILI9341_PIN_DC` set to
+ * the same pins as `cs` and `dc` drives them with single instructions
+ * @see spi_uart.h
  */
 void ILI9341_init(pin_t cs, pin_t dc, pin_t rst);
 
@@ -146,4 +152,13 @@ void ILI9341_draw_char(uint16_t x, uint16_t y, char ch);
  */
 void ILI9341_draw_string(uint16_t x, uint16_t y, const char *str);
 
+/**
+ * @brief Display text stored in program memory on the screen
+ * @param x Position X of the text
+ * @param y Position Y of the text
+ * @param str Text to display (`PSTR` or `PROGMEM`)
+ * @warning The text should only contain printable characters
+ */
+void ILI9341_draw_string_P(uint16_t x, uint16_t y, const char *str);
+
 #endif // VEMAR_ILI9341_H
@@ -4,6 +4,45 @@
 #include "common.h"
 #include "gpio.h"
 
+#define JOYSTICK_RANGE 255 /**< Output of an axis, from `-RANGE` to `RANGE` */
+
+#ifndef JOYSTICK_DEADZONE
+#define JOYSTICK_DEADZONE 12 /**< Dead zone around the centre, in ADC counts */
+#endif
+
+#ifndef JOYSTICK_HYSTERESIS
+#define JOYSTICK_HYSTERESIS 4 /**< Smallest output change reported */
+#endif
+
+#ifndef JOYSTICK_FILTER_SHIFT
+#define JOYSTICK_FILTER_SHIFT 2 /**< IIR filter coefficient, `2^-shift` */
+#endif
+
+#define JOYSTICK_CAL_MAX 4 /**< Maximum number of axes stored in EEPROM */
+
+/**
+ * @brief Calibration of a joystick axis, in ADC counts
+ */
+typedef struct
+{
+    uint16_t min;    /**< Lowest value reached */
+    uint16_t center; /**< Value at rest */
+    uint16_t max;    /**< Highest value reached */
+} joystick_cal_t;
+
+/**
+ * @brief Filter state of a joystick axis
+ */
+typedef struct
+{
+    joystick_cal_t cal; /**< Calibration */
+    uint16_t gain_low;  /**< Scale below the centre, 16.16 fixed-point */
+    uint16_t gain_high; /**< Scale above the centre, 16.16 fixed-point */
+    uint16_t state;     /**< IIR filter output, ADC counts << 6 */
+    int16_t value;      /**< Last reported value */
+    bool_t primed;      /**< The filter holds a sample */
+} joystick_axis_t;
+
 /**
  * @brief Define structure of a Joystick
  */
@@ -53,11 +92,81 @@ inline bool_t JOYSTICK_is_pressed(joystick_t *joystick)
     return (BUTTON_is_active(&(joystick->button)));
 }
 
+//------------------------------------------------------------------------------
+// Axis Pipeline
+//------------------------------------------------------------------------------
+
+/**
+ * @brief Set the calibration of an axis and reset its filter
+ * @param axis Axis to configure
+ * @param cal Calibration of the axis
+ */
+void JOYSTICK_axis_init(joystick_axis_t *axis, const joystick_cal_t *cal);
+
+/**
+ * @brief Filter a new sample of an axis
+ * @param axis Axis to update
+ * @param raw ADC value of the axis
+ * @return Position from `-JOYSTICK_RANGE` to `JOYSTICK_RANGE`, `0` inside
+ * the dead zone
+ * @details
+ * The sample goes through an IIR low-pass filter, is scaled from the
+ * calibrated extents with the dead zone removed, then compared with the last
+ * reported value: changes smaller than `JOYSTICK_HYSTERESIS` are ignored,
+ * except to reach the centre or the ends.
+ */
+int16_t JOYSTICK_axis_update(joystick_axis_t *axis, uint16_t raw);
+
+//------------------------------------------------------------------------------
+// Calibration
+//------------------------------------------------------------------------------
+
+/**
+ * @brief Start the calibration of an axis
+ * @param cal Calibration to initialize
+ * @param center ADC value of the axis at rest
+ */
+void JOYSTICK_cal_begin(joystick_cal_t *cal, uint16_t center);
+
+/**
+ * @brief Extend the calibrated range with a new sample
+ * @param cal Calibration to update
+ * @param raw ADC value of the axis
+ */
+void JOYSTICK_cal_track(joystick_cal_t *cal, uint16_t raw);
+
+/**
+ * @brief Check whether a calibration is usable
+ * @param cal Calibration to check
+ * @return `TRUE` if the centre is inside wide enough extents
+ */
+bool_t JOYSTICK_cal_is_valid(const joystick_cal_t *cal);
+
+/**
+ * @brief Load calibrations from EEPROM
+ * @param cal Calibrations to fill
+ * @param count Number of axes, at most `JOYSTICK_CAL_MAX`
+ * @return `TRUE` if a valid record was found, otherwise `cal` is unchanged
+ */
+bool_t JOYSTICK_cal_load(joystick_cal_t *cal, length_t count);
+
+/**
+ * @brief Store calibrations in EEPROM
+ * @param cal Calibrations to store
+ * @param count Number of axes, at most `JOYSTICK_CAL_MAX`
+ * @note Only the bytes that changed are written
+ */
+void JOYSTICK_cal_save(const joystick_cal_t *cal, length_t count);
+
 #endif // VEMAR_JOYSTICK
 
 /**
  * @file joystick.h
  * @brief Joystick utility functions
  * @author Christian Hugon <chriss.hugon@gmail.com>
- * @version 1.0.0
+ * @version 1.1.0
+ * @details
+ * The axis pipeline takes ADC samples from any source (`ANALOG_read`, or the
+ * background scan with `ADC_scan_read`). Calibrations are kept at the start
+ * of the EEPROM, with a version byte and a CRC.
  */
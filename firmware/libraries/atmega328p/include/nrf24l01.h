@@ -48,8 +48,9 @@ typedef enum nrf24l01_enum_status
  */
 typedef enum nrf24l01_enum_data_rate
 {
-    NRF24L01_1MBPS = 0x00, ///< 1Mbps
-    NRF24L01_2MBPS = 0x08  ///< 2Mbps
+    NRF24L01_1MBPS = 0x00,  ///< 1Mbps
+    NRF24L01_2MBPS = 0x08,  ///< 2Mbps
+    NRF24L01_250KBPS = 0x20 ///< 250kbps (nRF24L01+ only)
 } rf_rate_t;
 
 /**
@@ -67,6 +68,8 @@ typedef enum nrf24l01_enum_power
  * @brief Initialize NRF24L01 chip
  * @param ce Chip Enable pin
  * @param csn Chip Select pin
+ * @note Building the library with `NRF24L01_PIN_CE` and `NRF24L01_PIN_CSN`
+ * set to the same pins as `ce` and `csn` drives them with single instructions
  */
 void NRF24L01_init(pin_t ce, pin_t csn);
 
@@ -150,6 +153,12 @@ bool_t NRF24L01_has_payload(void);
  */
 byte_t NRF24L01_status(void);
 
+/**
+ * @brief Return the number of retransmissions of the last packet
+ * @return Auto-retransmit count (0 to 15), reset when a new packet is sent
+ */
+byte_t NRF24L01_retransmit_count(void);
+
 /**
  * @brief Set the RF channel frequency
  * @param frequency The RF channel frequency (0 to 125),
@@ -209,6 +218,14 @@ void NRF24L01_read_payload(byte_t *buff, length_t len);
  */
 void NRF24L01_write_payload(const byte_t *buff, length_t len);
 
+/**
+ * @brief Reuse the last transmitted payload
+ *
+ * @note The payload is retransmitted on every __CE__ pulse until
+ * `NRF24L01_write_payload` or `NRF24L01_flush_tx` is called
+ */
+void NRF24L01_reuse_payload(void);
+
 /**
  * @brief Flush RX buffer
  */
@@ -0,0 +1,137 @@
+#ifndef VEMAR_PROFILE_H
+#define VEMAR_PROFILE_H
+
+#include "common.h"
+
+/**
+ * @brief Profiled sections, index of the profile table
+ */
+typedef enum
+{
+    PROFILE_CONTROLLER_READ = 0, /**< `CONTROLLER_read` */
+    PROFILE_ILI9341_FILL,        /**< `ILI9341_fill_area` */
+    PROFILE_RADIO_WRITE,         /**< `RADIO_write` */
+    PROFILE_I2C_READ,            /**< `i2c_read_packet` */
+    PROFILE_SD_WRITE,            /**< `file_write` of the SD library */
+    PROFILE_LOOP,                /**< One pass of the main loop */
+    PROFILE_USER0,               /**< Free for temporary probes */
+    PROFILE_USER1,               /**< Free for temporary probes */
+    PROFILE_COUNT                /**< Size of the table */
+} profile_id_t;
+
+/**
+ * @brief Statistics of a profiled section
+ */
+typedef struct
+{
+    uint16_t count; /**< Completed measurements */
+    uint32_t min;   /**< Shortest measurement */
+    uint32_t max;   /**< Longest measurement */
+    uint32_t total; /**< Sum of the measurements */
+} profile_entry_t;
+
+#ifdef VEMAR_PROFILE_ENABLED
+
+#ifdef PROFILE_CLOCK_SIM
+
+/**
+ * @brief Section register written at the start of a section
+ */
+#define PROFILE_SIM_BEGIN GPIOR1
+
+/**
+ * @brief Section register written at the end of a section
+ */
+#define PROFILE_SIM_END GPIOR2
+
+#define PROFILE_BEGIN(id) (PROFILE_SIM_BEGIN = (id))
+#define PROFILE_END(id) (PROFILE_SIM_END = (id))
+
+#else
+
+/**
+ * @brief Start measuring a section
+ * @param id Section, `profile_id_t`
+ */
+#define PROFILE_BEGIN(id) PROFILE_begin(id)
+
+/**
+ * @brief Stop measuring a section and accumulate its duration
+ * @param id Section, `profile_id_t`
+ */
+#define PROFILE_END(id) PROFILE_end(id)
+
+#endif // PROFILE_CLOCK_SIM
+
+/**
+ * @brief Start the profiling clock and clear the table
+ * @note Without `PROFILE_CLOCK_TICK`, Timer1 runs free with no prescaler and
+ * the measurements are CPU cycles, Timer1 is not available for PWM. With
+ * `PROFILE_CLOCK_TICK`, the system tick is used instead and the measurements
+ * are microseconds. With `PROFILE_CLOCK_SIM`, no clock is started: the
+ * simulator of `tools/cycles` times the sections and the table stays empty.
+ */
+void PROFILE_init(void);
+
+/**
+ * @brief Clear the table
+ */
+void PROFILE_reset(void);
+
+void PROFILE_begin(profile_id_t id);
+
+void PROFILE_end(profile_id_t id);
+
+/**
+ * @brief Copy the statistics of a section
+ * @param id Section to read
+ * @param entry Statistics, copied
+ */
+void PROFILE_get(profile_id_t id, profile_entry_t *entry);
+
+/**
+ * @brief Print the table with `SERIAL_printf_P`
+ */
+void PROFILE_report(void);
+
+/**
+ * @brief Emit the table as `TRACE_ID_PROFILE` records
+ */
+void PROFILE_report_trace(void);
+
+#else
+
+#define PROFILE_BEGIN(id)
+#define PROFILE_END(id)
+#define PROFILE_init()
+#define PROFILE_reset()
+#define PROFILE_report()
+#define PROFILE_report_trace()
+
+#endif // VEMAR_PROFILE_ENABLED
+
+#endif // VEMAR_PROFILE_H
+
+/**
+ * @file profile.h
+ * @brief Section profiling
+ * @author Christian Hugon <chriss.hugon@gmail.com>
+ * @version 1.0.0
+ * @details
+ * Define `VEMAR_PROFILE_ENABLED` for the library and the board to measure the
+ * sections delimited by `PROFILE_BEGIN` and `PROFILE_END`, the markers are
+ * compiled out otherwise. The cost of an empty pair of markers is measured by
+ * `PROFILE_init` and subtracted. Sections of the same ID must not nest.
+ *
+ * With `PROFILE_CLOCK_SIM`, for a simulated target, a marker is a single `out`
+ * of the section ID to `PROFILE_SIM_BEGIN` or `PROFILE_SIM_END`, which the
+ * simulator watches to count cycles.
+ * ```
+ * void RADIO_task(void)
+ * {
+ *      PROFILE_BEGIN(PROFILE_RADIO_WRITE);
+ *      RADIO_write(payload, PACKET_SIZE);
+ *      PROFILE_END(PROFILE_RADIO_WRITE);
+ * }
+ * ```
+ */
@@ -7,6 +7,28 @@
 #error "Module 'NRF24L01' not defined"
 #endif
 
+/**
+ * @brief Link profiles, from the most robust to the fastest
+ *
+ * |       Profile        |  Rate   | Power |
+ * | -------------------- | ------- | ----- |
+ * | RADIO_LINK_250KBPS   | 250kbps |  0dBm |
+ * | RADIO_LINK_1MBPS     |   1Mbps |  0dBm |
+ * | RADIO_LINK_2MBPS     |   2Mbps |  0dBm |
+ * | RADIO_LINK_2MBPS_LOW |   2Mbps | -6dBm |
+ */
+typedef enum
+{
+    RADIO_LINK_250KBPS = 0,   /**< Long range */
+    RADIO_LINK_1MBPS = 1,     /**< Default profile */
+    RADIO_LINK_2MBPS = 2,     /**< Clean link, half the airtime */
+    RADIO_LINK_2MBPS_LOW = 3, /**< Clean and close link, lower consumption */
+    RADIO_LINK_COUNT = 4      /**< Number of profiles */
+} radio_link_t;
+
+#define RADIO_LINK_DEFAULT RADIO_LINK_1MBPS    /**< Profile after init */
+#define RADIO_LINK_FALLBACK RADIO_LINK_250KBPS /**< Profile when link is lost */
+
 /**
  * @brief Initialize the radio
  * @param ce Pin of __CE__
@@ -47,6 +69,49 @@ bool_t RADIO_read(byte_t *buffer, length_t len);
  */
 bool_t RADIO_write(const byte_t *buffer, length_t len);
 
+/**
+ * @brief Retransmit the last written payload without uploading it again
+ * @return `TRUE` if the payload has been acknowledged, otherwise `FALSE`
+ *
+ * @note Used as keepalive when the payload has not changed since the last
+ * call of `RADIO_write`
+ * @note Relies on the nRF24L01 keeping the last payload after its ACK: if
+ * nothing goes out, the transmission times out, counts as lost and the
+ * payload has to be written again
+ */
+bool_t RADIO_resend(void);
+
+/**
+ * @brief Check whether the last payload can be retransmitted
+ * @return `TRUE` if `RADIO_resend` is available, otherwise `FALSE`
+ *
+ * @note A failed transmission flushes the TX FIFO, the payload must then be
+ * written again with `RADIO_write`
+ */
+bool_t RADIO_can_resend(void);
+
+/**
+ * @brief Apply a link profile and reset the link statistics
+ * @param link Link profile, ignored if out of range
+ *
+ * @note Both ends must use the same profile, the switch is announced to the
+ * other end before being applied
+ */
+void RADIO_set_link(radio_link_t link);
+
+/**
+ * @brief Return the current link profile
+ */
+radio_link_t RADIO_get_link(void);
+
+/**
+ * @brief Evaluate the link from the retransmit count and the loss measured
+ * on the last transmissions
+ * @return The recommended link profile, the current one until enough
+ * transmissions have been measured
+ */
+radio_link_t RADIO_evaluate_link(void);
+
 /**
  * @brief Display debug information of the radio
  */
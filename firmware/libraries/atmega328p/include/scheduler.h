@@ -0,0 +1,126 @@
+#ifndef VEMAR_SCHEDULER_H
+#define VEMAR_SCHEDULER_H
+
+#include "common.h"
+
+/**
+ * @brief Identifier returned when no task slot is free
+ */
+#define SCHED_INVALID 0xFF
+
+/**
+ * @brief Task priority, a higher priority task always runs first
+ */
+typedef enum
+{
+    SCHED_PRIO_HIGH = 0,   /**< Control: radio, motors */
+    SCHED_PRIO_NORMAL = 1, /**< Sensors, display */
+    SCHED_PRIO_LOW = 2     /**< Telemetry, debug output */
+} sched_prio_t;
+
+/**
+ * @brief Task function, runs to completion
+ */
+typedef void (*sched_fn_t)(void);
+
+/**
+ * @brief Identifier of a task
+ */
+typedef byte_t sched_id_t;
+
+/**
+ * @brief Execution statistics of a task
+ */
+typedef struct
+{
+    uint16_t runs;     /**< Completed runs */
+    uint16_t overruns; /**< Runs that missed their deadline */
+    uint16_t max_us;   /**< Longest execution time, in microseconds */
+    uint16_t max_late; /**< Longest start delay, in milliseconds */
+    uint32_t total_us; /**< Sum of the execution times, in microseconds */
+} sched_stats_t;
+
+/**
+ * @brief Add a periodic task
+ * @param fn Function of the task
+ * @param period Period in milliseconds, the first run is due immediately
+ * @param prio Priority of the task
+ * @return Identifier of the task, `SCHED_INVALID` if `SCHED_TASK_MAX` tasks
+ * already are scheduled
+ * @note The deadline of a periodic task defaults to its period
+ */
+sched_id_t SCHED_every(sched_fn_t fn, uint16_t period, sched_prio_t prio);
+
+/**
+ * @brief Add a one-shot task, removed after it has run
+ * @param fn Function of the task
+ * @param delay Delay before the run, in milliseconds
+ * @param prio Priority of the task
+ * @return Identifier of the task, `SCHED_INVALID` if `SCHED_TASK_MAX` tasks
+ * already are scheduled
+ */
+sched_id_t SCHED_after(sched_fn_t fn, uint16_t delay, sched_prio_t prio);
+
+/**
+ * @brief Set the deadline of a task
+ * @param id Task to configure
+ * @param deadline Milliseconds from the release of the task to the end of its
+ * run, `0` for no deadline
+ */
+void SCHED_set_deadline(sched_id_t id, uint16_t deadline);
+
+/**
+ * @brief Remove a task
+ * @param id Task to remove, its slot can be reused
+ */
+void SCHED_cancel(sched_id_t id);
+
+/**
+ * @brief Run the most urgent task that is due
+ * @return `TRUE` if a task ran, `FALSE` if none was due
+ * @details Among the due tasks, the highest priority runs first, then the
+ * earliest deadline. A periodic task is released again one period after its
+ * previous release; when it falls a whole period behind, the missed releases
+ * are dropped and counted as overruns.
+ * @note Requires the system tick, call it from `loop`
+ */
+bool_t SCHED_dispatch(void);
+
+/**
+ * @brief Get the execution statistics of a task
+ * @param id Task to read
+ * @param stats Statistics, copied
+ */
+void SCHED_get_stats(sched_id_t id, sched_stats_t *stats);
+
+/**
+ * @brief Clear the execution statistics of all tasks
+ */
+void SCHED_reset_stats(void);
+
+#endif // VEMAR_SCHEDULER_H
+
+/**
+ * @file scheduler.h
+ * @brief Cooperative task scheduler
+ * @author Christian Hugon <chriss.hugon@gmail.com>
+ * @version 1.0.0
+ * @details
+ * Tasks run to completion from `loop`, a long task delays the others but is
+ * never interrupted. Keep tasks short and give the control path the highest
+ * priority, so it keeps its rate whatever the telemetry does.
+ * ```
+ * void setup(void)
+ * {
+ *      TIMER_tick_init_timer2();
+ *      sei();
+ *      SCHED_every(control, 10, SCHED_PRIO_HIGH);
+ *      SCHED_every(telemetry, 500, SCHED_PRIO_LOW);
+ * }
+ *
+ * void loop(void)
+ * {
+ *      SCHED_dispatch();
+ * }
+ * ```
+ */
@@ -1,6 +1,8 @@
 #ifndef VEMAR_SERIAL_H
 #define VEMAR_SERIAL_H
 
+#include <avr/pgmspace.h>
+
 #include "common.h"
 #include "uart.h"
 
@@ -26,6 +28,39 @@
 	UART_transmit('\r');              \
 	UART_transmit('\n')
 
+/**
+ * @brief Print specified value, string literals are kept in flash
+ * @param type Type of the value, same as `SERIAL_print`
+ * @note With `str`, the argument has to be a string literal: it is placed in
+ * program memory with `PSTR` instead of being copied to SRAM at startup
+ * @see SERIAL_print
+ */
+#define SERIAL_print_P(type, ...) \
+	_SERIAL_print_P_##type(__VA_ARGS__)
+
+/**
+ * @brief Print specific value followed by newline character, string literals
+ * are kept in flash
+ *
+ * @see SERIAL_print_P
+ */
+#define SERIAL_println_P(type, ...)     \
+	_SERIAL_print_P_##type(__VA_ARGS__); \
+	UART_transmit('\r');                \
+	UART_transmit('\n')
+
+#if !defined(_DOXYGEN_)
+#define _SERIAL_print_P_char SERIAL_print_char
+#define _SERIAL_print_P_int SERIAL_print_int
+#define _SERIAL_print_P_uint SERIAL_print_uint
+#define _SERIAL_print_P_long SERIAL_print_long
+#define _SERIAL_print_P_ulong SERIAL_print_ulong
+#define _SERIAL_print_P_hex SERIAL_print_hex
+#define _SERIAL_print_P_bool SERIAL_print_bool
+#define _SERIAL_print_P_str(_literal) SERIAL_print_str_P(PSTR(_literal))
+#define _SERIAL_print_P_str_P SERIAL_print_str_P
+#endif
+
 /**
  * @brief Convert input to specific type
  * @param type Type of the variable
@@ -40,6 +75,11 @@
 
 /**
  * @brief Initialize the Serial Communication
+ *
+ * @note Output is queued in the UART transmit buffer and sent from its
+ * interrupt, printing does not wait for the line unless the buffer is full.
+ * @see UART_set_overflow
+ * @see UART_drain
  */
 void SERIAL_init(void);
 
@@ -56,6 +96,23 @@ void SERIAL_print_hex(unsigned long n, length_t len);
 void SERIAL_print_str(const char *str);
 void SERIAL_print_bool(bool_t boolean);
 
+/**
+ * @brief Print a null-terminated string stored in program memory
+ * @param str String in program memory (`PSTR` or `PROGMEM`)
+ */
+void SERIAL_print_str_P(const char *str);
+
+/**
+ * @brief Print formatted output, the format string is read from flash
+ * @param fmt Format string in program memory (`PSTR` or `PROGMEM`)
+ * @details
+ * Conversions: `%c`, `%s` (SRAM string), `%S` (flash string), `%d`, `%i`,
+ * `%u`, `%x`, `%X` and `%%`. `l` selects a 32-bit argument (`%ld`, `%lu`,
+ * `%lx`), an optional width pads with spaces, or zeros when it starts with
+ * `0`. For instance: `SERIAL_printf_P(PSTR("LX: %4d\r\n"), lx)`
+ */
+void SERIAL_printf_P(const char *fmt, ...);
+
 /**
  * @brief The `SERIAL_scan_` family of functions allow to retrieve specific
  * typed variable from the terminal
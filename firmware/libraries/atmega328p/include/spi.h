@@ -2,6 +2,7 @@
 #define VEMAR_SPI_H
 
 #include "common.h"
+#include "gpio.h"
 
 //------------------------------------------------------------------------------
 // Enumerations
@@ -48,6 +49,23 @@ typedef enum
     SPI_PS32 = 0x12,  /**< F_osc / 32 */
 } spi_ps_t;
 
+//------------------------------------------------------------------------------
+// Structures
+//------------------------------------------------------------------------------
+
+/**
+ * @brief Define a device sharing the SPI bus
+ * @details
+ * Each device keeps its own clock, mode and data order, which are loaded by
+ * `SPI_begin` when the device takes the bus
+ */
+typedef struct
+{
+    pin_t cs;    /**< Chip Select (LOW to select the device) */
+    byte_t spcr; /**< SPCR value of the device */
+    byte_t spsr; /**< SPSR value of the device (`SPI2X`) */
+} spi_device_t;
+
 /**
  * @brief Initialize SPI as master
  * @param order Data order
@@ -59,6 +77,43 @@ typedef enum
  */
 void SPI_init(spi_order_t order, spi_mode_t mode, spi_ps_t prescaler);
 
+/**
+ * @brief Create a device on the SPI bus, initialize SPI if necessary
+ * @param cs Chip Select pin, set as output and driven HIGH
+ * @param order Data order
+ * @param mode SPI mode
+ * @param prescaler Clock division
+ * @return The SPI device
+ */
+spi_device_t SPI_device_new(pin_t cs,
+                            spi_order_t order,
+                            spi_mode_t mode,
+                            spi_ps_t prescaler);
+
+/**
+ * @brief Load the settings of the device if another one used the bus, without
+ * selecting it
+ * @param device Device taking the bus
+ * @note Lets a driver drive its Chip Select itself, from a compile-time pin
+ */
+void SPI_acquire(const spi_device_t *device);
+
+/**
+ * @brief Begin a transaction: load the settings of the device if another one
+ * used the bus, then select it
+ * @param device Device taking the bus
+ */
+void SPI_begin(const spi_device_t *device);
+
+/**
+ * @brief End a transaction: release the Chip Select of the device
+ * @param device Device releasing the bus
+ */
+inline void SPI_end(const spi_device_t *device)
+{
+    PIN_write(device->cs, PIN_HIGH);
+}
+
 /**
  * @brief Receive one byte of data
  * @return Received byte
@@ -75,15 +130,31 @@ void SPI_transmit(byte_t data);
  * @brief Transmit a serie of data
  * @param src Data buffer to transmit
  * @param len Size of the data buffer to transmit
+ *
+ * @note The next byte is loaded while the current one is shifted out
+ */
+void SPI_write(const byte_t *src, uint16_t len);
+
+/**
+ * @brief Transmit a serie of data stored in program memory
+ * @param src Data buffer to transmit (`PROGMEM`)
+ * @param len Size of the data buffer to transmit
+ */
+void SPI_write_P(const byte_t *src, uint16_t len);
+
+/**
+ * @brief Transmit a 16-bit pattern repeatedly, MSB first
+ * @param pattern 16-bit pattern to transmit
+ * @param count Number of times to transmit the pattern
  */
-void SPI_write(const byte_t *src, length_t len);
+void SPI_fill16(uint16_t pattern, uint16_t count);
 
 /**
  * @brief Receive a serie of data
  * @param data Data buffer to store received data
  * @param len Size of the data to receive
  */
-void SPI_read(byte_t *dst, length_t len);
+void SPI_read(byte_t *dst, uint16_t len);
 
 //------------------------------------------------------------------------------
 // Advanced configuration
@@ -221,4 +292,13 @@ inline bool_t SPI_is_complete(void)
  *      delay(1000);
  * }
  * ```
+ *
+ * When several devices share the bus, each one owns its settings
+ * ```
+ * spi_device_t dev = SPI_device_new(PIN_PB2, SPI_MSB, SPI_MODE0, SPI_PS2);
+ *
+ * SPI_begin(&dev);
+ * SPI_transmit(0x00);
+ * SPI_end(&dev);
+ * ```
  */
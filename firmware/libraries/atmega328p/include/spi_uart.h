@@ -0,0 +1,67 @@
+#ifndef VEMAR_SPI_UART_H
+#define VEMAR_SPI_UART_H
+
+#include "spi.h"
+
+/**
+ * @brief Initialize USART0 as SPI master (MSPIM), transmitter only
+ * @param order Data order
+ * @param mode SPI mode
+ * @param ubrr Clock division, the clock is `F_CPU / (2 * (ubrr + 1))`
+ * @see spi_order_t
+ * @see spi_mode_t
+ *
+ * @note __XCK0__ (PD4) is the clock and __TXD0__ (PD1) the data output,
+ * __RXD0__ (PD0) is left as GPIO. USART0 is no longer available for serial
+ * communication.
+ */
+void SPI_UART_init(spi_order_t order, spi_mode_t mode, uint16_t ubrr);
+
+/**
+ * @brief Transmit one byte of data
+ * @param data Byte to transmit
+ *
+ * @note Returns as soon as the byte is buffered, call `SPI_UART_flush`
+ * before releasing the Chip Select
+ */
+void SPI_UART_transmit(byte_t data);
+
+/**
+ * @brief Transmit a serie of data back-to-back
+ * @param src Data buffer to transmit
+ * @param len Size of the data buffer to transmit
+ */
+void SPI_UART_write(const byte_t *src, uint16_t len);
+
+/**
+ * @brief Transmit a serie of data stored in program memory back-to-back
+ * @param src Data buffer to transmit (`PROGMEM`)
+ * @param len Size of the data buffer to transmit
+ */
+void SPI_UART_write_P(const byte_t *src, uint16_t len);
+
+/**
+ * @brief Transmit a 16-bit pattern repeatedly, MSB first
+ * @param pattern 16-bit pattern to transmit
+ * @param count Number of times to transmit the pattern
+ */
+void SPI_UART_fill16(uint16_t pattern, uint16_t count);
+
+/**
+ * @brief Wait until the last byte has been shifted out
+ */
+void SPI_UART_flush(void);
+
+#endif // VEMAR_SPI_UART_H
+
+/**
+ * @file spi_uart.h
+ * @brief SPI master over USART0 (MSPIM)
+ * @author Christian Hugon <chriss.hugon@gmail.com>
+ * @version 1.0.0
+ * @details
+ * The transmitter of USART0 is double buffered: the next byte is accepted
+ * while the current one is shifted out, so bursts are sent without gap
+ * between bytes. It provides a second SPI bus, which leaves the hardware SPI
+ * to the other devices.
+ */
@@ -0,0 +1,70 @@
+#ifndef VEMAR_SRAM_H
+#define VEMAR_SRAM_H
+
+#include "common.h"
+
+/**
+ * @brief Byte painted over the free SRAM at boot
+ */
+#define SRAM_CANARY 0xC5
+
+/**
+ * @brief Free SRAM below which the stack is reported as close to the data
+ */
+#ifndef SRAM_WARNING_MARGIN
+#define SRAM_WARNING_MARGIN 64
+#endif // SRAM_WARNING_MARGIN
+
+/**
+ * @brief SRAM usage, in bytes
+ */
+typedef struct
+{
+    uint16_t data;           /**< Initialized variables, `.data` */
+    uint16_t bss;            /**< Zeroed variables, `.bss` */
+    uint16_t heap;           /**< Heap allocated by `malloc` */
+    uint16_t stack_free;     /**< Free space between heap and stack, now */
+    uint16_t stack_free_min; /**< Smallest free space since boot */
+} sram_usage_t;
+
+/**
+ * @brief Get the current SRAM usage
+ * @param usage Usage, filled
+ */
+void SRAM_get_usage(sram_usage_t *usage);
+
+/**
+ * @brief Free space between heap and stack, now
+ * @return Free bytes
+ */
+uint16_t SRAM_stack_free(void);
+
+/**
+ * @brief Smallest free space between heap and stack since boot
+ * @return Bytes still holding `SRAM_CANARY` above the heap
+ * @note Scans the painted area, takes about 6 cycles per free byte
+ */
+uint16_t SRAM_stack_free_min(void);
+
+/**
+ * @brief Check that the stack stays clear of the heap and variables
+ * @param margin Smallest acceptable free space, in bytes
+ * @return `TRUE` if the smallest free space since boot is above `margin`
+ * @note Call it periodically, a warning can then be reported before the
+ * stack actually overwrites data
+ */
+bool_t SRAM_check(uint16_t margin);
+
+#endif // VEMAR_SRAM_H
+
+/**
+ * @file sram.h
+ * @brief SRAM and stack usage monitor
+ * @author Christian Hugon <chriss.hugon@gmail.com>
+ * @version 1.0.0
+ * @details
+ * Linking this module paints the SRAM between the end of `.bss` and the top
+ * of the stack with `SRAM_CANARY` before `main`, from the `.init1` section.
+ * Every byte the stack has ever reached is overwritten, so the painted bytes
+ * left give the high-water mark of the stack, interrupts included.
+ */
@@ -1,6 +1,8 @@
 #ifndef VEMAR_TFT_H
 #define VEMAR_TFT_H
 
+#include <avr/pgmspace.h>
+
 #include "ili9341.h"
 
 #if !defined(DEFINE_TFT_ILI9341)
@@ -121,4 +123,15 @@ inline void TFT_print_str(uint16_t x, uint16_t y, const char *str)
 	ILI9341_draw_string(x, y, str);
 }
 
+/**
+ * @brief Display a text stored in program memory
+ * @param x Position X of the text (Top-Left)
+ * @param y Position Y of the text (Top-Left)
+ * @param str Null-terminated string (`PSTR` or `PROGMEM`)
+ */
+inline void TFT_print_str_P(uint16_t x, uint16_t y, const char *str)
+{
+	ILI9341_draw_string_P(x, y, str);
+}
+
 #endif // VEMAR_TFT_H
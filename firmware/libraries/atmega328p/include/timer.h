@@ -44,7 +44,7 @@ typedef enum
 typedef enum
 {
     TIMER0_NORMAL = 0x00, /**< Normal mode */
-    TIMER0_CTC = 0x01,    /**< Clear Timer on Compare Match mode */
+    TIMER0_CTC = 0x02,    /**< Clear Timer on Compare Match mode */
     TIMER0_FPWM = 0x03     /**< Fast Pulse Width Modulation mode */
 } timer0_mode_t;
 
@@ -58,7 +58,7 @@ typedef enum
 typedef enum
 {
     TIMER2_NORMAL = 0x00,
-    TIMER2_CTC = 0x10,
+    TIMER2_CTC = 0x02,
     TIMER2_FPWM = 0x03
 } timer2_mode_t;
 
@@ -83,10 +83,94 @@ void TIMER1_init(timer1_mode_t mode, timer1_ps_t prescaler);
  */
 void TIMER2_init(timer2_mode_t mode, timer2_ps_t prescaler);
 
+//------------------------------------------------------------------------------
+// System Tick
+//------------------------------------------------------------------------------
+
+/**
+ * @brief Function called by the tick interrupt every millisecond
+ */
+typedef void (*timer_hook_t)(void);
+
+/**
+ * @brief Start the system tick on Timer0, alongside its PWM
+ * @details The tick counts the overflows of Timer0 with the prescaler already
+ * configured, so Timer0 keeps generating PWM on OC0A/OC0B (`PWM_init`, car
+ * motors). If Timer0 is stopped, it is started in fast PWM mode with a
+ * prescaler of 64, the configuration used by `PWM_init`.
+ * @note Timer0 must count up to `0xFF` (normal or fast PWM mode) and its
+ * prescaler must not change afterwards. One interrupt every 256 timer cycles:
+ * every 128 us with a prescaler of 8, every 1024 us with 64.
+ * @see TIMER_tick_init_timer2
+ */
+void TIMER_tick_init_timer0(void);
+
+/**
+ * @brief Start the system tick on Timer2, in CTC mode at 1 kHz
+ * @note Timer2 is not available for PWM afterwards
+ * @see TIMER_tick_init_timer0
+ */
+void TIMER_tick_init_timer2(void);
+
+/**
+ * @brief Milliseconds since the tick was started
+ * @return Monotonic time, wraps around after about 49 days
+ * @note Compare times with a subtraction, `TIMER_millis() - start >= timeout`,
+ * which stays correct across the wrap-around
+ * @see TIMER_elapsed
+ */
+uint32_t TIMER_millis(void);
+
+/**
+ * @brief Microseconds since the tick was started
+ * @return Monotonic time, wraps around after about 71 minutes
+ * @note The resolution is one timer count: 4 us on Timer2, 0.5 us on Timer0
+ * with a prescaler of 8
+ */
+uint32_t TIMER_micros(void);
+
+/**
+ * @brief Milliseconds elapsed since a previous `TIMER_millis` value
+ * @param since Start time
+ * @return Elapsed time, correct across the wrap-around
+ */
+inline uint32_t TIMER_elapsed(uint32_t since)
+{
+    return (TIMER_millis() - since);
+}
+
+/**
+ * @brief Call a function every millisecond from the tick interrupt
+ * @param hook Function to call, must be short
+ * @return `TRUE` if attached, `FALSE` if `TIMER_TICK_HOOK_MAX` hooks already
+ * are
+ */
+bool_t TIMER_tick_attach(timer_hook_t hook);
+
+/**
+ * @brief Advance the tick by one interrupt period
+ * @note Called by the tick interrupt only
+ */
+void _TIMER_tick_update(void);
+
+/**
+ * @brief Set the source of the tick
+ * @param source Timer number, `0` or `2`
+ * @param shift Prescaler of the timer, as a power of 2
+ * @param period Timer counts per interrupt
+ * @note Called by `TIMER_tick_init_timer0` and `TIMER_tick_init_timer2` only
+ */
+void _TIMER_tick_setup(byte_t source, byte_t shift, uint16_t period);
+
 #endif // VEMAR_TIMER_H
 
 /**
  * @file timer.h
  * @brief Utility functions for timers
  * @author Christian Hugon <chriss.hugon@gmail.com>
+ * @version 1.1.0
+ * @details
+ * The system tick gives the time in milliseconds and microseconds. It runs
+ * either on Timer0, shared with its PWM, or on a dedicated Timer2: each source
+ * lives in its own file, so only the chosen interrupt is linked.
  */
@@ -0,0 +1,89 @@
+#ifndef VEMAR_TRACE_H
+#define VEMAR_TRACE_H
+
+#include "common.h"
+#include "uart.h"
+#include "../../util/trace.h"
+
+/**
+ * @brief Initialize the trace stream on the UART transmitter
+ *
+ * @note The trace stream and `SERIAL_print` share the UART, only one of them
+ * should be used at a time.
+ */
+void TRACE_init(void);
+
+/**
+ * @brief Emit a record, or drop it whole if the transmit buffer is full
+ * @param id Record ID
+ * @param payload Record payload
+ * @param len Size of the payload, at most `TRACE_PAYLOAD_MAX`
+ *
+ * @note Safe to call from an interrupt: the frame is queued with the
+ * interrupts disabled so records never interleave.
+ */
+void TRACE_record(byte_t id, const byte_t *payload, length_t len);
+
+/**
+ * @brief Trace a received radio packet
+ * @param packet Packet buffer, its first `TRACE_PACKET_BYTES` are recorded
+ */
+void TRACE_packet(const byte_t *packet);
+
+/**
+ * @brief Trace a whole packet received from a module
+ * @param packet Packet buffer of `TRACE_MODULE_BYTES`
+ * @note Fills most of the default UART transmit buffer, emit it from the main
+ * loop rather than from an interrupt
+ */
+void TRACE_module(const byte_t *packet);
+
+/**
+ * @brief Trace a motor command
+ * @param left Left motor command
+ * @param right Right motor command
+ */
+void TRACE_motor(int16_t left, int16_t right);
+
+/**
+ * @brief Trace an I2C error
+ * @param address Slave address
+ * @param error Error code returned by the I2C driver
+ */
+void TRACE_i2c_error(byte_t address, int8_t error);
+
+/**
+ * @brief Trace a timing sample
+ * @param probe Identifier of the measured section
+ * @param value Measured value, in the unit of the probe
+ */
+void TRACE_timing(byte_t probe, uint32_t value);
+
+/**
+ * @brief Trace a low free SRAM warning
+ * @param free_min Smallest free space since boot, in bytes
+ * @param free Free space now, in bytes
+ * @param heap Heap size, in bytes
+ * @see SRAM_check
+ */
+void TRACE_sram(uint16_t free_min, uint16_t free, uint16_t heap);
+
+/**
+ * @brief Return the number of records dropped since initialization
+ * @return Number of dropped records
+ */
+uint16_t TRACE_dropped(void);
+
+#endif // VEMAR_TRACE_H
+
+/**
+ * @file trace.h
+ * @brief Binary trace stream
+ * @author Christian Hugon <chriss.hugon@gmail.com>
+ * @version 1.0.0
+ * @details
+ * Records are typed, protected by a CRC-16/CCITT and COBS-framed, then queued
+ * in the interrupt-driven UART buffer: emitting one costs a few microseconds
+ * and never waits for the line. The wire format is described in
+ * `util/trace.h`, `tools/trace` decodes it on the host.
+ */
@@ -48,6 +48,15 @@ typedef enum
     UART_RX = 0x10  /**< Receiver */
 } uart_mode_t;
 
+/**
+ * @brief Define what happens when the transmit buffer is full
+ */
+typedef enum
+{
+    UART_DROP = 0, /**< Discard the byte and count it, polls with `cli()` */
+    UART_BLOCK = 1 /**< Wait until the buffer has room for the byte */
+} uart_overflow_t;
+
 //------------------------------------------------------------------------------
 // Basic configuration
 //------------------------------------------------------------------------------
@@ -58,21 +67,77 @@ typedef enum
  * @param mode UART operation mode: transmission or reception; can be OR'ed
  * @see uart_fmt_t
  * @see uart_mode_t
+ *
+ * @note The receiver fills its ring buffer from the __USART_RX__ interrupt,
+ * the global interrupts have to be enabled for it to run.
  */
 void UART_init(uart_fmt_t format, uart_mode_t mode);
 
 /**
- * @brief Transmit a byte of data
+ * @brief Queue a byte of data for transmission
  * @param data Byte to transmit
+ *
+ * @note Returns without waiting unless the transmit buffer is full, in
+ * which case the overflow policy applies.
+ * @note Not re-entrant: call it from the main loop only, never from an
+ * interrupt handler, the buffer has a single producer.
+ * @see UART_set_overflow
  */
 void UART_transmit(byte_t data);
 
 /**
- * @brief Receive a byte of data
+ * @brief Queue a serie of data for transmission
+ * @param src Data buffer to transmit
+ * @param len Size of the data buffer to transmit
+ * @return Number of bytes queued, less than `len` only with `UART_DROP` and
+ * the interrupts enabled
+ * @note From the main loop only, as `UART_transmit`
+ */
+length_t UART_write(const byte_t *src, length_t len);
+
+/**
+ * @brief Receive a byte of data, wait until one is available
  * @return Received byte
  */
 byte_t UART_receive(void);
 
+/**
+ * @brief Take a byte from the receive buffer without waiting
+ * @param data Where to store the received byte
+ * @return `TRUE` if a byte was read, `FALSE` if the buffer is empty
+ */
+bool_t UART_read(byte_t *data);
+
+/**
+ * @brief Return the number of bytes waiting in the receive buffer
+ * @return Number of received bytes
+ */
+length_t UART_available(void);
+
+/**
+ * @brief Return the room left in the transmit buffer
+ * @return Number of bytes that can be queued without overflow
+ */
+length_t UART_tx_free(void);
+
+/**
+ * @brief Set the policy applied when the transmit buffer is full
+ * @param policy Overflow policy, `UART_DROP` by default
+ * @see uart_overflow_t
+ */
+void UART_set_overflow(uart_overflow_t policy);
+
+/**
+ * @brief Return the number of bytes lost since initialization
+ * @return Bytes dropped on transmit overflow or receive overflow
+ */
+uint16_t UART_dropped(void);
+
+/**
+ * @brief Wait until every queued byte has been shifted out
+ */
+void UART_drain(void);
+
 //------------------------------------------------------------------------------
 // Advanced configuration
 //------------------------------------------------------------------------------
@@ -203,7 +268,7 @@ inline bool_t UART_is_ready(void)
 }
 
 /**
- * @brief Flush the receiver buffer
+ * @brief Discard every byte waiting in the receive buffer
  */
 void UART_flush(void);
 
@@ -213,7 +278,13 @@ void UART_flush(void);
  * @file uart.h
  * @brief UART utility functions
  * @author Christian Hugon <chriss.hugon@gmail.com>
- * @version 1.0.0
+ * @version 1.1.0
+ * @details
+ * Transmission and reception go through ring buffers serviced by the
+ * __USART_UDRE__ and __USART_RX__ interrupts, sized by
+ * `UART_TX_BUFFER_SIZE` and `UART_RX_BUFFER_SIZE` (see config.h). When the
+ * global interrupts are disabled, the functions fall back on polling the
+ * data register.
  */
 
 /**
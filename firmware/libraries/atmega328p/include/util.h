@@ -11,7 +11,9 @@
  * @details
  * The converted string is right justified, if the width of the number is
  * smaller than the specified width then the character space `' '` will be added
- * @warning Undefined behavior if overflow/undeflow occurs
+ * @warning The returned buffer is shared and overwritten by the next call,
+ * use `FMT_i16` with a local buffer from an interrupt
+ * @see FMT_i16
  */
 char *UTIL_itoa(int n, length_t width);
 
@@ -22,7 +24,9 @@ char *UTIL_itoa(int n, length_t width);
  * @return Null-terminated string as a decimal
  * @details
  * For instance: 10 will become "1.0", 6 will become "0.6"
- * @warning Undefined behavior if overflow/underflow occurs
+ * @warning The returned buffer is shared and overwritten by the next call,
+ * use `FMT_fixed` with a local buffer from an interrupt
+ * @see FMT_fixed
  */
 char *UTIL_itoa_decimal(int n, length_t width);
 
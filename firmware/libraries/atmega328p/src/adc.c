@@ -6,6 +6,71 @@ typedef void (*adc_callback_t)(uint16_t);
 
 static volatile adc_callback_t g_adc_callback;
 
+/**
+ * @brief Background scan state, samples are double buffered: the interrupt
+ * fills one set while the other holds the latest complete one
+ */
+static struct
+{
+    adc_ch_t channels[ADC_SCAN_MAX];  /**< Channels to convert */
+    uint16_t sets[2][ADC_SCAN_MAX];   /**< Sample sets */
+    length_t count;                   /**< Number of channels */
+    byte_t shift;                     /**< log2 of conversions per sample */
+    byte_t pass;                      /**< Conversions accumulated */
+    uint16_t sum;                     /**< Accumulated conversions */
+    volatile length_t index;          /**< Channel being converted */
+    volatile byte_t fill;             /**< Set being filled */
+    volatile byte_t scans;            /**< Complete scans, 0 until the first */
+    volatile bool_t running;          /**< Restart after each conversion */
+} g_adc_scan;
+
+/**
+ * @brief Store a sample and start the conversion of the next channel
+ * @param sample Result of the conversion
+ */
+static void _ADC_scan_next(uint16_t sample)
+{
+    length_t index = g_adc_scan.index;
+
+    g_adc_scan.sum += sample;
+    if (++g_adc_scan.pass < (1U << g_adc_scan.shift))
+    {
+        if (g_adc_scan.running)
+        {
+            ADC_start(); // same channel again
+        }
+        else
+        {
+            ADC_disable_interrupt();
+        }
+        return;
+    }
+    g_adc_scan.sets[g_adc_scan.fill][index] =
+        g_adc_scan.sum >> g_adc_scan.shift;
+    g_adc_scan.sum = 0;
+    g_adc_scan.pass = 0;
+    if (++index == g_adc_scan.count)
+    {
+        index = 0;
+        g_adc_scan.fill ^= 1; // publish the set just completed
+        ++g_adc_scan.scans;
+        if (0 == g_adc_scan.scans)
+        {
+            g_adc_scan.scans = 1; // 0 is kept for "no set yet"
+        }
+    }
+    g_adc_scan.index = index;
+    if (g_adc_scan.running)
+    {
+        ADC_set_channel(g_adc_scan.channels[index]);
+        ADC_start();
+    }
+    else
+    {
+        ADC_disable_interrupt();
+    }
+}
+
 //------------------------------------------------------------------------------
 // ADC_init
 //------------------------------------------------------------------------------
@@ -84,6 +149,91 @@ void ADC_attach_interrupt(void (*on_complete)(uint16_t))
     g_adc_callback = on_complete;
 }
 
+//------------------------------------------------------------------------------
+// ADC_scan_start
+//------------------------------------------------------------------------------
+void ADC_scan_start(const adc_ch_t *channels, length_t count)
+{
+    if ((0 == count) || (ADC_SCAN_MAX < count))
+    {
+        return;
+    }
+    ADC_disable_interrupt();
+    WAIT_UNTIL(BIT_is_clear(ADCSRA, BIT(ADSC))); // let a conversion finish
+    for (length_t i = 0; i < count; ++i)
+    {
+        g_adc_scan.channels[i] = channels[i];
+    }
+    g_adc_scan.count = count;
+    g_adc_scan.index = 0;
+    g_adc_scan.sum = 0;
+    g_adc_scan.pass = 0;
+    g_adc_scan.fill = 0;
+    g_adc_scan.scans = 0;
+    g_adc_scan.running = TRUE;
+
+    ADC_attach_interrupt(_ADC_scan_next);
+    ADC_set_channel(channels[0]);
+    BIT_set(ADCSRA, BIT(ADIF)); // clear a pending completion
+    ADC_enable_interrupt();
+    ADC_start();
+}
+
+//------------------------------------------------------------------------------
+// ADC_scan_oversample
+//------------------------------------------------------------------------------
+void ADC_scan_oversample(byte_t shift)
+{
+    if (ADC_SCAN_OVERSAMPLE_MAX < shift)
+    {
+        shift = ADC_SCAN_OVERSAMPLE_MAX;
+    }
+    g_adc_scan.shift = shift;
+}
+
+//------------------------------------------------------------------------------
+// ADC_scan_stop
+//------------------------------------------------------------------------------
+void ADC_scan_stop(void)
+{
+    g_adc_scan.running = FALSE; // a completion in between does not restart
+    ADC_disable_interrupt();
+    WAIT_UNTIL(BIT_is_clear(ADCSRA, BIT(ADSC))); // let a conversion finish
+    BIT_set(ADCSRA, BIT(ADIF)); // clear its completion
+    ADC_attach_interrupt(NULL);
+}
+
+//------------------------------------------------------------------------------
+// ADC_scan_read
+//------------------------------------------------------------------------------
+bool_t ADC_scan_read(uint16_t *samples)
+{
+    byte_t sreg;
+    const uint16_t *set;
+
+    if (0 == g_adc_scan.scans)
+    {
+        return (FALSE);
+    }
+    sreg = SREG;
+    cli(); // the set cannot be swapped during the copy
+    set = g_adc_scan.sets[g_adc_scan.fill ^ 1];
+    for (length_t i = 0; i < g_adc_scan.count; ++i)
+    {
+        samples[i] = set[i];
+    }
+    SREG = sreg;
+    return (TRUE);
+}
+
+//------------------------------------------------------------------------------
+// ADC_scan_count
+//------------------------------------------------------------------------------
+byte_t ADC_scan_count(void)
+{
+    return (g_adc_scan.scans);
+}
+
 //------------------------------------------------------------------------------
 // ISR
 //------------------------------------------------------------------------------
@@ -0,0 +1,30 @@
+#include "gpio.h"
+#include "timer.h"
+#include "config.h"
+
+static byte_t g_button_elapsed; /**< Milliseconds since the last sample */
+
+//------------------------------------------------------------------------------
+// _BUTTON_tick
+//------------------------------------------------------------------------------
+
+/**
+ * @brief Sample the buttons every `BUTTON_SAMPLE_PERIOD` ticks
+ */
+static void _BUTTON_tick(void)
+{
+    if (BUTTON_SAMPLE_PERIOD <= ++g_button_elapsed)
+    {
+        g_button_elapsed = 0;
+        BUTTON_update();
+    }
+}
+
+//------------------------------------------------------------------------------
+// BUTTON_service_start
+//------------------------------------------------------------------------------
+
+bool_t BUTTON_service_start(void)
+{
+    return (TIMER_tick_attach(_BUTTON_tick));
+}
@@ -0,0 +1,71 @@
+#include "event.h"
+#include "config.h"
+
+#if (EVENT_QUEUE_SIZE & (EVENT_QUEUE_SIZE - 1)) || \
+    (256 < EVENT_QUEUE_SIZE) || (2 > EVENT_QUEUE_SIZE)
+#error "EVENT_QUEUE_SIZE must be a power of 2 between 2 and 256"
+#endif
+
+#define _EVENT_MASK ((byte_t)(EVENT_QUEUE_SIZE - 1))
+
+static event_t g_event_buffer[EVENT_QUEUE_SIZE];
+static volatile byte_t g_event_head; /**< Next slot to write, producer only */
+static volatile byte_t g_event_tail; /**< Next slot to read, consumer only */
+static volatile byte_t g_event_dropped;
+
+//------------------------------------------------------------------------------
+// EVENT_post
+//------------------------------------------------------------------------------
+
+bool_t EVENT_post(event_t ev)
+{
+    byte_t head = g_event_head;
+    byte_t next = (head + 1) & _EVENT_MASK;
+
+    if (next == g_event_tail)
+    {
+        if (0xFF != g_event_dropped)
+        {
+            ++g_event_dropped;
+        }
+        return (FALSE);
+    } // queue full: the newest event is lost
+    g_event_buffer[head] = ev;
+    g_event_head = next; // publish once the slot is written
+    return (TRUE);
+}
+
+//------------------------------------------------------------------------------
+// EVENT_get
+//------------------------------------------------------------------------------
+
+bool_t EVENT_get(event_t *ev)
+{
+    byte_t tail = g_event_tail;
+
+    if (tail == g_event_head)
+    {
+        return (FALSE);
+    }
+    *ev = g_event_buffer[tail];
+    g_event_tail = (tail + 1) & _EVENT_MASK; // release once the slot is read
+    return (TRUE);
+}
+
+//------------------------------------------------------------------------------
+// EVENT_pending
+//------------------------------------------------------------------------------
+
+bool_t EVENT_pending(void)
+{
+    return (g_event_head != g_event_tail);
+}
+
+//------------------------------------------------------------------------------
+// EVENT_dropped
+//------------------------------------------------------------------------------
+
+byte_t EVENT_dropped(void)
+{
+    return (g_event_dropped);
+}
@@ -0,0 +1,218 @@
+#include "fmt.h"
+
+#define _FMT_DIGITS_U32 10 /**< Digits of UINT32_MAX */
+
+//------------------------------------------------------------------------------
+// _FMT_divu10_16
+//------------------------------------------------------------------------------
+
+/**
+ * @brief Divide a 16-bit number by 10
+ * @details
+ * `0xCCCD / 2^19` is 10^-1 rounded up, exact for every 16-bit dividend
+ */
+static inline uint16_t _FMT_divu10_16(uint16_t n)
+{
+    return ((uint16_t)(((uint32_t)n * 0xCCCDUL) >> 19));
+}
+
+//------------------------------------------------------------------------------
+// _FMT_divu10_32
+//------------------------------------------------------------------------------
+
+/**
+ * @brief Divide a 32-bit number by 10
+ * @details
+ * `n * 0.8` is approached with shifts and adds, then divided by 8, the
+ * estimate is at most 1 below the quotient and corrected from the remainder
+ */
+static inline uint32_t _FMT_divu10_32(uint32_t n)
+{
+    uint32_t q = (n >> 1) + (n >> 2);
+    uint32_t r;
+
+    q += (q >> 4);
+    q += (q >> 8);
+    q += (q >> 16);
+    q >>= 3;
+    r = n - (((q << 2) + q) << 1);
+    return (q + (9 < r));
+}
+
+//------------------------------------------------------------------------------
+// _FMT_copy
+//------------------------------------------------------------------------------
+
+/**
+ * @brief Copy the digits generated at the end of a scratch buffer
+ */
+static length_t _FMT_copy(char *buf, const char *digits, const char *end)
+{
+    length_t len = 0;
+
+    while (digits != end)
+    {
+        buf[len++] = *digits++;
+    }
+    buf[len] = '\0';
+    return (len);
+}
+
+//------------------------------------------------------------------------------
+// FMT_u16
+//------------------------------------------------------------------------------
+
+length_t FMT_u16(char *buf, uint16_t n)
+{
+    char tmp[5];
+    char *pos = tmp + sizeof(tmp);
+
+    do
+    {
+        uint16_t q = _FMT_divu10_16(n);
+        *--pos = (char)('0' + (n - q * 10U));
+        n = q;
+    } while (0 != n);
+    return (_FMT_copy(buf, pos, tmp + sizeof(tmp)));
+}
+
+//------------------------------------------------------------------------------
+// FMT_i16
+//------------------------------------------------------------------------------
+
+length_t FMT_i16(char *buf, int16_t n)
+{
+    if (0 > n)
+    {
+        *buf = '-';
+        return (1 + FMT_u16(buf + 1, (uint16_t)(0U - (uint16_t)n)));
+    }
+    return (FMT_u16(buf, (uint16_t)n));
+}
+
+//------------------------------------------------------------------------------
+// FMT_u32
+//------------------------------------------------------------------------------
+
+length_t FMT_u32(char *buf, uint32_t n)
+{
+    char tmp[_FMT_DIGITS_U32];
+    char *pos = tmp + sizeof(tmp);
+
+    while (0xFFFFUL < n)
+    {
+        uint32_t q = _FMT_divu10_32(n);
+        *--pos = (char)('0' + (byte_t)(n - (((q << 2) + q) << 1)));
+        n = q;
+    } // 32-bit steps until the rest fits in 16 bits
+    uint16_t low = (uint16_t)n;
+    do
+    {
+        uint16_t q = _FMT_divu10_16(low);
+        *--pos = (char)('0' + (low - q * 10U));
+        low = q;
+    } while (0 != low);
+    return (_FMT_copy(buf, pos, tmp + sizeof(tmp)));
+}
+
+//------------------------------------------------------------------------------
+// FMT_i32
+//------------------------------------------------------------------------------
+
+length_t FMT_i32(char *buf, int32_t n)
+{
+    if (0 > n)
+    {
+        *buf = '-';
+        return (1 + FMT_u32(buf + 1, 0UL - (uint32_t)n));
+    }
+    return (FMT_u32(buf, (uint32_t)n));
+}
+
+//------------------------------------------------------------------------------
+// FMT_fixed
+//------------------------------------------------------------------------------
+
+length_t FMT_fixed(char *buf, int32_t n, byte_t decimals)
+{
+    char tmp[FMT_BUFFER_SIZE];
+    length_t len = 0;
+    length_t digits;
+
+    if (0 > n)
+    {
+        buf[len++] = '-';
+        digits = FMT_u32(tmp, 0UL - (uint32_t)n);
+    }
+    else
+    {
+        digits = FMT_u32(tmp, (uint32_t)n);
+    }
+    if (0 == decimals)
+    {
+        return (len + _FMT_copy(buf + len, tmp, tmp + digits));
+    }
+    if (9 < decimals)
+    {
+        decimals = 9;
+    }
+    if (digits <= decimals)
+    {
+        buf[len++] = '0';
+        buf[len++] = '.';
+        for (length_t i = digits; i < decimals; ++i)
+        {
+            buf[len++] = '0';
+        }
+        return (len + _FMT_copy(buf + len, tmp, tmp + digits));
+    } // |n| < 1: leading zeros
+    len += _FMT_copy(buf + len, tmp, tmp + digits - decimals);
+    buf[len++] = '.';
+    return (len + _FMT_copy(buf + len, tmp + digits - decimals, tmp + digits));
+}
+
+//------------------------------------------------------------------------------
+// FMT_hex
+//------------------------------------------------------------------------------
+
+length_t FMT_hex(char *buf, uint32_t n, length_t digits)
+{
+    char tmp[8];
+    char *pos = tmp + sizeof(tmp);
+
+    if (sizeof(tmp) < digits)
+    {
+        digits = sizeof(tmp);
+    }
+    do
+    {
+        byte_t nibble = (byte_t)n & 0x0F;
+        *--pos = (char)((10 > nibble) ? ('0' + nibble) : ('A' - 10 + nibble));
+        n >>= 4;
+    } while ((0 != n) || ((tmp + sizeof(tmp)) - pos < digits));
+    return (_FMT_copy(buf, pos, tmp + sizeof(tmp)));
+}
+
+//------------------------------------------------------------------------------
+// FMT_justify
+//------------------------------------------------------------------------------
+
+length_t FMT_justify(char *buf, length_t len, length_t width)
+{
+    length_t shift;
+
+    if (len >= width)
+    {
+        return (len);
+    }
+    shift = width - len;
+    for (length_t i = len + 1; 0 != i; --i)
+    {
+        buf[i - 1 + shift] = buf[i - 1];
+    } // move the string and its null-terminator
+    for (length_t i = 0; i < shift; ++i)
+    {
+        buf[i] = ' ';
+    }
+    return (width);
+}
@@ -1,14 +1,8 @@
+#include <avr/interrupt.h>
+
 #include "gpio.h"
 #include "config.h"
 
-// access corresponding register: PINx, DDRx, PORTx
-#define REG_PIN(pin) (_SFR_IO8(0x03 + ((pin & 0xF0) >> 4)))
-#define REG_DDR(pin) (_SFR_IO8(0x04 + ((pin & 0xF0) >> 4)))
-#define REG_PORT(pin) (_SFR_IO8(0x05 + ((pin & 0xF0) >> 4)))
-
-// shift to corresponding register bit
-#define REG_SHIFT(pin, value) (value << (pin & 0x0F))
-
 // mask for button flags
 #define BUTTON_MASK_STATE 0x03
 #define BUTTON_MASK_TRIGGER 0x1C
@@ -25,38 +19,49 @@
 #define BUTTON_STATE_ONRELEASE 0x02
 #define BUTTON_STATE_ONHOLD 0x03
 
+// debouncing service state
+#define BUTTON_DEBOUNCE_COUNT 0x0F      /**< Integrator */
+#define BUTTON_DEBOUNCE_LEVEL 0x10      /**< Debounced level, set if pressed */
+#define BUTTON_DEBOUNCE_PRESSED 0x20    /**< Press latched */
+#define BUTTON_DEBOUNCE_RELEASED 0x40   /**< Release latched */
+#define BUTTON_DEBOUNCE_REGISTERED 0x80 /**< Sampled by the service */
+
+/**
+ * @brief Samples of stable level before the debounced level changes
+ */
+#define BUTTON_INTEGRATOR_MAX \
+    ((DEBOUNCE_TIME + BUTTON_SAMPLE_PERIOD - 1) / BUTTON_SAMPLE_PERIOD)
+
+#if (BUTTON_INTEGRATOR_MAX > BUTTON_DEBOUNCE_COUNT) || \
+    (1 > BUTTON_INTEGRATOR_MAX)
+#error "DEBOUNCE_TIME must be between 1 and 15 BUTTON_SAMPLE_PERIOD"
+#endif
+
+static button_t *g_button[BUTTON_MAX]; /**< Registered buttons */
+static byte_t g_button_count;
+
 //------------------------------------------------------------------------------
 // Pin
 //------------------------------------------------------------------------------
 
-pin_state_t PIN_read(pin_t pin)
-{
-    return (0 != BIT_read(REG_PIN(pin), REG_SHIFT(pin, 1)));
-}
-
-void PIN_write(pin_t pin, pin_state_t state)
-{
-    BIT_write(REG_PORT(pin), REG_SHIFT(pin, state), REG_SHIFT(pin, 1));
-}
-
-void PIN_toggle(pin_t pin)
+pin_state_t _PIN_read(pin_t pin)
 {
-    BIT_write(REG_PIN(pin), REG_SHIFT(pin, 1), REG_SHIFT(pin, 1));
+    return (0 != BIT_read(_PIN_REG_PIN(pin), _PIN_MASK(pin)));
 }
 
-void PIN_mode(pin_t pin, pin_mode_t mode)
+void _PIN_write(pin_t pin, pin_state_t state)
 {
-    BIT_write(REG_DDR(pin), REG_SHIFT(pin, mode), REG_SHIFT(pin, 1));
+    BIT_write(_PIN_REG_PORT(pin), state ? _PIN_MASK(pin) : 0, _PIN_MASK(pin));
 }
 
-void PIN_enable_pullup(pin_t pin)
+void _PIN_toggle(pin_t pin)
 {
-    BIT_set(REG_PORT(pin), REG_SHIFT(pin, 1));
+    _PIN_REG_PIN(pin) = _PIN_MASK(pin); // writing 1 to PINx toggles
 }
 
-void PIN_disable_pullup(pin_t pin)
+void _PIN_mode(pin_t pin, pin_mode_t mode)
 {
-	BIT_clear(REG_PORT(pin), REG_SHIFT(pin, 1));
+    BIT_write(_PIN_REG_DDR(pin), mode ? _PIN_MASK(pin) : 0, _PIN_MASK(pin));
 }
 
 //------------------------------------------------------------------------------
@@ -88,6 +93,34 @@ button_t BUTTON_new(pin_t pin, button_mode_t trigger)
 
 bool_t BUTTON_is_active(button_t *button)
 {
+    if (button->debounce & BUTTON_DEBOUNCE_REGISTERED)
+    {
+        byte_t sreg = SREG;
+        byte_t event;
+
+        cli(); // the service updates the state from its interrupt
+        switch (button->flags & BUTTON_MASK_TRIGGER)
+        {
+        case BUTTON_ONHOLD:
+            event = BUTTON_DEBOUNCE_LEVEL;
+            break;
+        case BUTTON_ONPRESS:
+            event = BUTTON_DEBOUNCE_PRESSED;
+            break;
+        case BUTTON_ONRELEASE:
+            event = BUTTON_DEBOUNCE_RELEASED;
+            break;
+        default:
+            event = 0;
+            break;
+        }
+        event &= button->debounce;
+        BIT_clear(button->debounce,
+                  event & (BUTTON_DEBOUNCE_PRESSED | BUTTON_DEBOUNCE_RELEASED));
+        SREG = sreg;
+        return (0 != event);
+    } // latched by the debouncing service
+
     byte_t state = ((button->flags << 1) & BUTTON_MASK_STATE) |
                    (PIN_LOW == PIN_read(button->pin));
 
@@ -108,6 +141,61 @@ bool_t BUTTON_is_active(button_t *button)
     return (FALSE);
 }
 
+bool_t BUTTON_register(button_t *button)
+{
+    byte_t sreg = SREG;
+
+    if (BUTTON_MAX <= g_button_count)
+    {
+        return (FALSE);
+    }
+    button->debounce = BUTTON_DEBOUNCE_REGISTERED;
+    if (PIN_LOW == PIN_read(button->pin))
+    {
+        button->debounce |= BUTTON_DEBOUNCE_LEVEL | BUTTON_INTEGRATOR_MAX;
+    } // already held: no press is reported
+    cli();
+    g_button[g_button_count++] = button;
+    SREG = sreg;
+    return (TRUE);
+}
+
+void BUTTON_update(void)
+{
+    for (byte_t i = 0; i < g_button_count; ++i)
+    {
+        button_t *button = g_button[i];
+        byte_t state = button->debounce;
+        byte_t count = state & BUTTON_DEBOUNCE_COUNT;
+
+        if (PIN_LOW == PIN_read(button->pin))
+        {
+            if (BUTTON_INTEGRATOR_MAX > count)
+            {
+                ++count;
+            }
+            if ((BUTTON_INTEGRATOR_MAX == count) &&
+                !(state & BUTTON_DEBOUNCE_LEVEL))
+            {
+                state |= BUTTON_DEBOUNCE_LEVEL | BUTTON_DEBOUNCE_PRESSED;
+            } // stable low: pressed
+        }
+        else
+        {
+            if (0 < count)
+            {
+                --count;
+            }
+            if ((0 == count) && (state & BUTTON_DEBOUNCE_LEVEL))
+            {
+                state &= ~BUTTON_DEBOUNCE_LEVEL;
+                state |= BUTTON_DEBOUNCE_RELEASED;
+            } // stable high: released
+        }
+        button->debounce = (state & ~BUTTON_DEBOUNCE_COUNT) | count;
+    }
+}
+
 //------------------------------------------------------------------------------
 // Analog
 //------------------------------------------------------------------------------
@@ -128,6 +216,12 @@ uint16_t ANALOG_read(analog_t analog)
 //------------------------------------------------------------------------------
 // Inline functions
 //------------------------------------------------------------------------------
+extern inline pin_state_t PIN_read(pin_t);
+extern inline void PIN_write(pin_t, pin_state_t);
+extern inline void PIN_toggle(pin_t);
+extern inline void PIN_mode(pin_t, pin_mode_t);
+extern inline void PIN_enable_pullup(pin_t);
+extern inline void PIN_disable_pullup(pin_t);
 extern inline bool_t LED_is_on(led_t);
 extern inline void LED_on(led_t);
 extern inline void LED_off(led_t);
@@ -1,4 +1,5 @@
 #include "i2c.h"
+#include "profile.h"
 
 #if defined(__AVR_ATtiny412__) || defined(__AVR_ATtiny1614__)
 static int8_t i2c_wait_bus_idle(void) {
@@ -35,6 +36,58 @@ static int8_t i2c_wait_twint(void) {
 }
 #endif
 
+static const uint8_t g_i2c_rates[] = {
+  [I2C_STANDARD] = I2C_TWBR(I2C_FREQ_STANDARD),
+  [I2C_FAST] = I2C_TWBR(I2C_FREQ_FAST),
+};
+static uint8_t g_i2c_profile_addr[I2C_PROFILE_MAX];
+static uint8_t g_i2c_profile_rate[I2C_PROFILE_MAX];
+static uint8_t g_i2c_profiles;
+static uint8_t g_i2c_rate = TWBR_VAL; // slaves without a profile
+
+// bit rate register of a slave, a higher value is a slower clock
+static uint8_t _i2c_rate(uint8_t addr) {
+  for (uint8_t i = 0; i < g_i2c_profiles; i++) {
+    if (g_i2c_profile_addr[i] == addr) return g_i2c_profile_rate[i];
+  }
+  return g_i2c_rate;
+}
+
+#if defined(__AVR_ATmega328P__)
+// START, and the STOP before it, at the slower of the two speeds: every
+// slave on the bus sees them; the address goes at the speed of the slave
+static uint8_t _i2c_prepare(uint8_t addr) {
+  uint8_t rate = _i2c_rate(addr);
+
+  if (rate > TWBR) TWBR = rate;
+  return rate;
+}
+#endif
+
+bool_t i2c_set_speed(uint8_t addr, i2c_speed_t speed) {
+  uint8_t sreg = SREG;
+  uint8_t i = 0;
+  bool_t set = TRUE;
+
+  cli(); // the TWI interrupt reads the profiles
+  if (I2C_OTHERS == addr) {
+    g_i2c_rate = g_i2c_rates[speed];
+  }
+  else {
+    while ((i < g_i2c_profiles) && (g_i2c_profile_addr[i] != addr)) i++;
+    if (I2C_PROFILE_MAX == i) {
+      set = FALSE; // table full
+    }
+    else {
+      g_i2c_profile_addr[i] = addr;
+      g_i2c_profile_rate[i] = g_i2c_rates[speed];
+      if (i == g_i2c_profiles) g_i2c_profiles++;
+    }
+  }
+  SREG = sreg;
+  return set;
+}
+
 void i2c_init() {
 #if defined(__AVR_ATtiny412__) || defined(__AVR_ATtiny1614__)
   TWI0.MCTRLA |= TWI_ENABLE_bm;        // enable master
@@ -103,6 +156,7 @@ int8_t i2c_start(uint8_t addr_rw, bool_t restart) {
   if (TWI0.MSTATUS & TWI_RXACK_bm) return I2C_ERR_NACK;        // slave NACKed address
 #elif defined(__AVR_ATmega328P__)
   uint8_t expected_addr_ack = (addr_rw & 0x01) ? TW_MR_SLA_ACK : TW_MT_SLA_ACK; // expect SLA+R ACK or SLA+W ACK
+  uint8_t rate = _i2c_prepare(addr_rw >> 1);
 
   TWCR = (1<<TWINT) | (1<<TWSTA) | (1<<TWEN); // send START condition
   if (i2c_wait_twint() != 0) return I2C_ERR_TIMEOUT;
@@ -112,6 +166,7 @@ int8_t i2c_start(uint8_t addr_rw, bool_t restart) {
   else {
     if ((TWSR & 0xF8) != 0x08) return I2C_ERR_ARBLOST; // START not acknowledged
   }
+  TWBR = rate;                         // speed of the slave from the address on
   TWDR = addr_rw;                      // load address + R/W bit into data register
   TWCR = (1<<TWINT) | (1<<TWEN);      // transmit address
   if (i2c_wait_twint() != 0) return I2C_ERR_TIMEOUT;
@@ -180,7 +235,10 @@ int16_t i2c_read_nack(void) {
 
 int8_t i2c_write_packet(uint8_t addr, uint8_t *data, uint16_t len) {
   int8_t start_resp = i2c_start(addr << 1, FALSE); // send START + address (write mode)
-  if (start_resp != 0) return start_resp;
+  if (start_resp != 0) {
+    i2c_stop(); // release the bus, as the reads do
+    return start_resp;
+  }
   for (uint16_t i = 0; i < len; i++) {
     int8_t write_resp = i2c_write(data[i]); // send each byte
     if (write_resp != 0) {
@@ -215,7 +273,7 @@ int32_t i2c_get_read_len(uint8_t addr) {
   return len;
 }
 
-int8_t i2c_read_packet(uint8_t addr, uint8_t *buffer) {
+static int8_t _i2c_read_packet(uint8_t addr, uint8_t *buffer) {
   int8_t start_resp = i2c_start((addr << 1) | 1, FALSE); // send START + address (read mode)
   if (start_resp) {
     i2c_stop();
@@ -259,6 +317,179 @@ int8_t i2c_read_packet(uint8_t addr, uint8_t *buffer) {
   return 0;
 }
 
+int8_t i2c_read_packet(uint8_t addr, uint8_t *buffer) {
+  PROFILE_BEGIN(PROFILE_I2C_READ);
+  int8_t resp = _i2c_read_packet(addr, buffer);
+  PROFILE_END(PROFILE_I2C_READ);
+  return resp;
+}
+
+#if defined(__AVR_ATmega328P__) && defined(I2C_MASTER)
+#if (I2C_QUEUE_SIZE & (I2C_QUEUE_SIZE - 1)) || (2 > I2C_QUEUE_SIZE) || \
+    (128 < I2C_QUEUE_SIZE)
+#error "I2C_QUEUE_SIZE must be a power of 2 between 2 and 128"
+#endif
+
+#define _I2C_MASK ((uint8_t)(I2C_QUEUE_SIZE - 1))
+#define _I2C_GO ((1 << TWINT) | (1 << TWEN) | (1 << TWIE))
+#define _I2C_HEADER 2 // length bytes of a packet
+
+static i2c_xfer_t *volatile g_i2c_queue[I2C_QUEUE_SIZE];
+static volatile uint8_t g_i2c_head;  // next free slot
+static volatile uint8_t g_i2c_tail;  // transfer on the bus
+static uint8_t g_i2c_index;          // bytes written, or length bytes read
+static uint8_t g_i2c_left;           // bytes left to read
+static bool_t g_i2c_reading;         // address sent with TW_READ
+static uint16_t g_i2c_len;           // length of a packet
+static bool_t g_i2c_in_finish;       // in a callback: _i2c_finish starts next
+
+static bool_t _i2c_reads(const i2c_xfer_t *xfer) {
+  return (0 != xfer->rx_len);
+}
+
+// next transfer, or release the bus; STOP and START can go in one write
+static void _i2c_finish(int8_t status, uint8_t control) {
+  i2c_xfer_t *xfer = g_i2c_queue[g_i2c_tail];
+
+  g_i2c_tail = (g_i2c_tail + 1) & _I2C_MASK;
+  xfer->status = status;
+  if (NULL != xfer->done) {
+    g_i2c_in_finish = TRUE;
+    xfer->done(xfer); // may queue the next transfer, started below
+    g_i2c_in_finish = FALSE;
+  }
+  g_i2c_index = 0;
+  g_i2c_reading = FALSE;
+  if (g_i2c_tail != g_i2c_head) {
+    _i2c_prepare(g_i2c_queue[g_i2c_tail]->addr);
+    TWCR = control | (1 << TWSTA) | _I2C_GO;
+  }
+  else {
+    TWCR = control | (1 << TWINT) | (1 << TWEN); // idle: interrupt off
+  }
+}
+
+// ACK every byte but the last one
+static void _i2c_read_next(void) {
+  TWCR = (1 < g_i2c_left ? (1 << TWEA) : 0) | _I2C_GO;
+}
+
+static void _i2c_received(i2c_xfer_t *xfer, bool_t last) {
+  uint8_t data = TWDR;
+
+  if ((xfer->flags & I2C_XFER_PACKET) && (_I2C_HEADER > g_i2c_index)) {
+    g_i2c_len = (g_i2c_len << 8) | data;
+    if (_I2C_HEADER > ++g_i2c_index) {
+      _i2c_read_next();
+    }
+    else if ((0 == g_i2c_len) || (xfer->rx_len < g_i2c_len)) {
+      _i2c_finish(I2C_ERR_INVALID_LEN, 1 << TWSTO);
+    }
+    else {
+      g_i2c_left = (uint8_t)g_i2c_len;
+      _i2c_read_next();
+    }
+    return;
+  }
+  xfer->rx[xfer->count++] = data;
+  if (last || (0 == --g_i2c_left)) {
+    _i2c_finish(0, 1 << TWSTO);
+  }
+  else {
+    _i2c_read_next();
+  }
+}
+
+ISR(TWI_vect) {
+  i2c_xfer_t *xfer = g_i2c_queue[g_i2c_tail];
+
+  switch (TW_STATUS) {
+  case TW_START:
+  case TW_REP_START:
+    // read once every byte is written; write only, or probe the address
+    g_i2c_reading = _i2c_reads(xfer) && (xfer->tx_len == g_i2c_index);
+    TWBR = _i2c_rate(xfer->addr);
+    TWDR = (xfer->addr << 1) | (g_i2c_reading ? TW_READ : TW_WRITE);
+    TWCR = _I2C_GO;
+    break;
+  case TW_MT_SLA_ACK:
+  case TW_MT_DATA_ACK:
+    if (xfer->tx_len > g_i2c_index) {
+      TWDR = xfer->tx[g_i2c_index++];
+      TWCR = _I2C_GO;
+    }
+    else if (_i2c_reads(xfer)) {
+      TWCR = (1 << TWSTA) | _I2C_GO; // repeated START, then read
+    }
+    else {
+      _i2c_finish(0, 1 << TWSTO);
+    }
+    break;
+  case TW_MR_SLA_ACK:
+    g_i2c_index = 0;
+    g_i2c_len = 0;
+    g_i2c_left = (xfer->flags & I2C_XFER_PACKET) ? 0xFF : xfer->rx_len;
+    _i2c_read_next();
+    break;
+  case TW_MR_DATA_ACK:
+    _i2c_received(xfer, FALSE);
+    break;
+  case TW_MR_DATA_NACK:
+    _i2c_received(xfer, TRUE);
+    break;
+  case TW_MT_SLA_NACK:
+  case TW_MR_SLA_NACK:
+  case TW_MT_DATA_NACK:
+    _i2c_finish(I2C_ERR_NACK, 1 << TWSTO);
+    break;
+  case TW_MT_ARB_LOST: // TW_MR_ARB_LOST too
+    _i2c_finish(I2C_ERR_ARBLOST, 0); // not the master anymore: no STOP
+    break;
+  default: // TW_BUS_ERROR
+    _i2c_finish(I2C_ERR_BUSERR, 1 << TWSTO); // STOP only resets the hardware
+    break;
+  }
+}
+
+bool_t i2c_submit(i2c_xfer_t *xfer) {
+  uint8_t sreg = SREG;
+  uint8_t head;
+  bool_t queued = FALSE;
+
+  cli(); // the interrupt moves the tail
+  head = g_i2c_head;
+  if ((I2C_PENDING != xfer->status) &&
+      (((head + 1) & _I2C_MASK) != g_i2c_tail)) {
+    xfer->status = I2C_PENDING;
+    xfer->count = 0;
+    g_i2c_queue[head] = xfer;
+    g_i2c_head = (head + 1) & _I2C_MASK;
+    if ((head == g_i2c_tail) && !g_i2c_in_finish) {
+      _i2c_prepare(xfer->addr);
+      TWCR = (1 << TWSTA) | _I2C_GO; // bus idle: start now
+    }
+    queued = TRUE;
+  }
+  SREG = sreg;
+  return queued;
+}
+
+bool_t i2c_busy(void) {
+  return (g_i2c_head != g_i2c_tail);
+}
+
+void i2c_abort(void) {
+  uint8_t sreg = SREG;
+
+  cli();
+  if (g_i2c_head != g_i2c_tail) {
+    TWCR = 0;                 // drop the bus, a stretched clock included
+    _i2c_finish(I2C_ERR_TIMEOUT, 0);
+  }
+  SREG = sreg;
+}
+#endif
+
 // used in interrupt
 uint8_t i2c_slave_receive(void) {
 #if defined(__AVR_ATtiny412__) || defined(__AVR_ATtiny1614__)
@@ -1,6 +1,45 @@
 #include "ili9341.h"
 #include "spi.h"
 #include "font.h"
+#include "profile.h"
+
+// compile-time pins drive Chip Select and Data/Command with single sbi/cbi
+#ifdef ILI9341_PIN_CS
+#define _ILI9341_cs(state) PIN_write(ILI9341_PIN_CS, state)
+#else
+#define _ILI9341_cs(state) PIN_write(g_ili9341.spi.cs, state)
+#endif
+#ifdef ILI9341_PIN_DC
+#define _ILI9341_dc(state) PIN_write(ILI9341_PIN_DC, state)
+#else
+#define _ILI9341_dc(state) PIN_write(g_ili9341.dc, state)
+#endif
+
+#ifdef ILI9341_SPI_UART
+#include "spi_uart.h"
+
+// display on USART0 in SPI master mode, Chip Select driven by the driver
+#define _ILI9341_begin() _ILI9341_cs(PIN_LOW)
+#define _ILI9341_end()         \
+    do                         \
+    {                          \
+        SPI_UART_flush();      \
+        _ILI9341_cs(PIN_HIGH); \
+    } while (0)
+#define _ILI9341_transmit(data) SPI_UART_transmit(data)
+#define _ILI9341_fill16(pattern, count) SPI_UART_fill16(pattern, count)
+#else
+// display on the shared hardware SPI
+#define _ILI9341_begin()             \
+    do                               \
+    {                                \
+        SPI_acquire(&g_ili9341.spi); \
+        _ILI9341_cs(PIN_LOW);        \
+    } while (0)
+#define _ILI9341_end() _ILI9341_cs(PIN_HIGH)
+#define _ILI9341_transmit(data) SPI_transmit(data)
+#define _ILI9341_fill16(pattern, count) SPI_fill16(pattern, count)
+#endif
 
 #define ILI9341_WIDTH 240  /**< Screen width */
 #define ILI9341_HEIGHT 320 /**< Screen height */
@@ -105,7 +144,7 @@ typedef struct
 {
     uint16_t w;          /**< Width */
     uint16_t h;          /**< Height */
-    pin_t cs;            /**< Chip Select (LOW to start SPI communication) */
+    spi_device_t spi;    /**< SPI device (Chip Select) */
     pin_t dc;            /**< Data/Command (HIGH for data, LOw for command) */
     pin_t rst;           /**< Reset */
     byte_t madctl;       /**< MADCTL register */
@@ -160,17 +199,23 @@ static void ILI9341_define_area(uint16_t x, uint16_t y, uint16_t w, uint16_t h);
 
 void ILI9341_init(pin_t cs, pin_t dc, pin_t rst)
 {
-    g_ili9341.cs = cs;
     g_ili9341.dc = dc;
     g_ili9341.rst = rst;
     g_ili9341.w = ILI9341_WIDTH;
     g_ili9341.h = ILI9341_HEIGHT;
 
-    PIN_mode(g_ili9341.cs, PIN_OUTPUT);
     PIN_mode(g_ili9341.dc, PIN_OUTPUT);
     PIN_mode(g_ili9341.rst, PIN_OUTPUT);
 
-    SPI_init(SPI_MSB, SPI_MODE0, SPI_PS4); // initialize SPI
+    // write cycle of 100ns: F_CPU / 2
+#ifdef ILI9341_SPI_UART
+    g_ili9341.spi.cs = cs;
+    PIN_mode(cs, PIN_OUTPUT);
+    PIN_write(cs, PIN_HIGH);
+    SPI_UART_init(SPI_MSB, SPI_MODE0, 0);
+#else
+    g_ili9341.spi = SPI_device_new(cs, SPI_MSB, SPI_MODE0, SPI_PS2);
+#endif
 
     // hardware reset: RST pin LOW then HIGH
     PIN_write(g_ili9341.rst, PIN_LOW);
@@ -241,35 +286,35 @@ void ILI9341_sleep_out(void)
 
 void ILI9341_set_command(byte_t cmd)
 {
-    PIN_write(g_ili9341.dc, PIN_LOW);
-    PIN_write(g_ili9341.cs, PIN_LOW);
-    SPI_transmit(cmd);
-    PIN_write(g_ili9341.cs, PIN_HIGH);
+    _ILI9341_dc(PIN_LOW);
+    _ILI9341_begin();
+    _ILI9341_transmit(cmd);
+    _ILI9341_end();
 }
 
 //------------------------------------------------------------------------------
 // ILI9341_set_data
 //------------------------------------------------------------------------------
 
- void ILI9341_set_data(byte_t data)
+void ILI9341_set_data(byte_t data)
 {
-    PIN_write(g_ili9341.dc, PIN_HIGH);
-    PIN_write(g_ili9341.cs, PIN_LOW);
-    SPI_transmit(data);
-    PIN_write(g_ili9341.cs, PIN_HIGH);
+    _ILI9341_dc(PIN_HIGH);
+    _ILI9341_begin();
+    _ILI9341_transmit(data);
+    _ILI9341_end();
 }
 
 //------------------------------------------------------------------------------
 // ILI9341_set_data16
 //------------------------------------------------------------------------------
 
- void ILI9341_set_data16(uint16_t data)
+void ILI9341_set_data16(uint16_t data)
 {
-    PIN_write(g_ili9341.dc, PIN_HIGH);
-    PIN_write(g_ili9341.cs, PIN_LOW);
-    SPI_transmit((byte_t)(data >> 8));
-    SPI_transmit((byte_t)(data & 0xFF));
-    PIN_write(g_ili9341.cs, PIN_HIGH);
+    _ILI9341_dc(PIN_HIGH);
+    _ILI9341_begin();
+    _ILI9341_transmit((byte_t)(data >> 8));
+    _ILI9341_transmit((byte_t)(data & 0xFF));
+    _ILI9341_end();
 }
 
 //------------------------------------------------------------------------------
@@ -374,11 +419,20 @@ void ILI9341_fill_screen(color16_t color)
 
 void ILI9341_fill_area(uint16_t x, uint16_t y, uint16_t w, uint16_t h, color16_t color)
 {
+    uint32_t size = ILI9341_UTIL_SIZE(w, h);
+
+    PROFILE_BEGIN(PROFILE_ILI9341_FILL);
     ILI9341_define_area(x, y, w, h);
-    for (uint32_t i = 0; i < ILI9341_UTIL_SIZE(w, h); ++i)
+    _ILI9341_dc(PIN_HIGH);
+    _ILI9341_begin();
+    while (UINT16_MAX < size)
     {
-        ILI9341_set_data16(color);
-    }
+        _ILI9341_fill16(color, UINT16_MAX);
+        size -= UINT16_MAX;
+    } // the full screen exceeds 16-bit counts
+    _ILI9341_fill16(color, (uint16_t)size);
+    _ILI9341_end();
+    PROFILE_END(PROFILE_ILI9341_FILL);
 }
 
 //------------------------------------------------------------------------------
@@ -401,27 +455,30 @@ void ILI9341_draw_char(uint16_t x, uint16_t y, char ch)
                         FONT_WIDTH * g_ili9341.text.size,
                         FONT_HEIGHT * g_ili9341.text.size);
     uint16_t font_idx = (ch - 32) * FONT_WIDTH;
+    byte_t lines[FONT_WIDTH];
+
+    for (uint8_t col = 0; col < FONT_WIDTH; ++col)
+    {
+        lines[col] = pgm_read_byte(&font[font_idx + col]);
+    }
 
+    _ILI9341_dc(PIN_HIGH);
+    _ILI9341_begin();
     for (uint8_t row = 0; row < FONT_HEIGHT; ++row)
     {
         for (uint8_t i = 0; i < g_ili9341.text.size; ++i)
         {
             for (uint8_t col = 0; col < FONT_WIDTH; ++col)
             {
-                byte_t line = (col < FONT_WIDTH)
-                                  ? pgm_read_byte(&font[font_idx + col])
-                                  : 0x00;
-                color16_t color = (BIT_read(line, BIT(row)))
+                color16_t color = (BIT_read(lines[col], BIT(row)))
                                       ? g_ili9341.text.color
                                       : g_ili9341.text.background;
 
-                for (uint8_t j = 0; j < g_ili9341.text.size; ++j)
-                {
-                    ILI9341_set_data16(color);
-                }
+                _ILI9341_fill16(color, g_ili9341.text.size);
             }
         }
     }
+    _ILI9341_end();
 }
 
 //------------------------------------------------------------------------------
@@ -437,3 +494,18 @@ void ILI9341_draw_string(uint16_t x, uint16_t y, const char *str)
         x += (g_ili9341.text.size * FONT_WIDTH) + g_ili9341.text.spacing;
     }
 }
+
+//------------------------------------------------------------------------------
+// ILI9341_draw_string_P
+//------------------------------------------------------------------------------
+
+void ILI9341_draw_string_P(uint16_t x, uint16_t y, const char *str)
+{
+    char ch;
+
+    while ('\0' != (ch = (char)pgm_read_byte(str++)))
+    {
+        ILI9341_draw_char(x, y, ch);
+        x += (g_ili9341.text.size * FONT_WIDTH) + g_ili9341.text.spacing;
+    }
+}
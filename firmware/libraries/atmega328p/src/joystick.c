@@ -1,5 +1,66 @@
+#include <stddef.h>
+#include <avr/eeprom.h>
+#include <util/crc16.h>
+
 #include "joystick.h"
 
+#define _JOYSTICK_Q 6 /**< Fraction bits of the filter state */
+
+#define _JOYSTICK_ROUND ((1 << JOYSTICK_FILTER_SHIFT) >> 1) /**< Rounding */
+
+#define _JOYSTICK_EXTENT_MIN 64 /**< Smallest usable half range, ADC counts */
+
+#define _JOYSTICK_EEPROM_VERSION 0x01 /**< Layout of the EEPROM record */
+
+/**
+ * @brief EEPROM record of the calibrations
+ */
+typedef struct
+{
+    byte_t version;                       /**< `_JOYSTICK_EEPROM_VERSION` */
+    byte_t count;                         /**< Number of axes */
+    joystick_cal_t cal[JOYSTICK_CAL_MAX]; /**< Calibrations */
+    uint16_t crc;                         /**< CRC-16 of the fields above */
+} _joystick_record_t;
+
+static _joystick_record_t EEMEM g_joystick_record;
+
+//------------------------------------------------------------------------------
+// _JOYSTICK_gain
+//------------------------------------------------------------------------------
+
+/**
+ * @brief Scale factor from a filtered distance to the output range, rounded
+ * up so that the end of the extent reaches `JOYSTICK_RANGE`
+ * @param extent Distance from the centre to the end, in ADC counts
+ */
+static uint16_t _JOYSTICK_gain(uint16_t extent)
+{
+    uint16_t span = (extent - JOYSTICK_DEADZONE) << _JOYSTICK_Q;
+
+    return ((uint16_t)((((uint32_t)JOYSTICK_RANGE << 16) + span - 1) / span));
+}
+
+//------------------------------------------------------------------------------
+// _JOYSTICK_crc
+//------------------------------------------------------------------------------
+
+static uint16_t _JOYSTICK_crc(const _joystick_record_t *record)
+{
+    const byte_t *data = (const byte_t *)record;
+    uint16_t crc = 0xFFFF;
+
+    for (length_t i = 0; i < offsetof(_joystick_record_t, crc); ++i)
+    {
+        crc = _crc16_update(crc, data[i]);
+    }
+    return (crc);
+}
+
+//------------------------------------------------------------------------------
+// JOYSTICK_new
+//------------------------------------------------------------------------------
+
 joystick_t JOYSTICK_new(adc_ch_t x, adc_ch_t y, pin_t button)
 {
     joystick_t retval = {
@@ -10,6 +71,169 @@ joystick_t JOYSTICK_new(adc_ch_t x, adc_ch_t y, pin_t button)
     return (retval);
 }
 
+//------------------------------------------------------------------------------
+// JOYSTICK_axis_init
+//------------------------------------------------------------------------------
+
+void JOYSTICK_axis_init(joystick_axis_t *axis, const joystick_cal_t *cal)
+{
+    axis->cal = *cal;
+    axis->gain_low = _JOYSTICK_gain(cal->center - cal->min);
+    axis->gain_high = _JOYSTICK_gain(cal->max - cal->center);
+    axis->state = 0;
+    axis->value = 0;
+    axis->primed = FALSE;
+}
+
+//------------------------------------------------------------------------------
+// JOYSTICK_axis_update
+//------------------------------------------------------------------------------
+
+int16_t JOYSTICK_axis_update(joystick_axis_t *axis, uint16_t raw)
+{
+    uint16_t sample = raw << _JOYSTICK_Q;
+    uint16_t center = axis->cal.center << _JOYSTICK_Q;
+    uint16_t distance;
+    uint16_t gain;
+    int16_t value;
+
+    if (!axis->primed)
+    {
+        axis->state = sample;
+        axis->primed = TRUE;
+    }
+    else
+    {
+        int32_t delta = (int32_t)sample - axis->state;
+        delta = (delta + _JOYSTICK_ROUND) >> JOYSTICK_FILTER_SHIFT;
+        axis->state += (int16_t)delta;
+    } // y += (x - y) / 2^shift, rounded
+
+    if (axis->state >= center)
+    {
+        distance = axis->state - center;
+        gain = axis->gain_high;
+    }
+    else
+    {
+        distance = center - axis->state;
+        gain = axis->gain_low;
+    }
+    if (distance <= (JOYSTICK_DEADZONE << _JOYSTICK_Q))
+    {
+        value = 0;
+    }
+    else
+    {
+        uint32_t scaled = distance - (JOYSTICK_DEADZONE << _JOYSTICK_Q);
+
+        scaled = (scaled * gain) >> 16;
+        value = (JOYSTICK_RANGE < scaled) ? JOYSTICK_RANGE : (int16_t)scaled;
+        if (axis->state < center)
+        {
+            value = -value;
+        }
+    }
+
+    int16_t change = value - axis->value;
+    if ((0 == value) || (JOYSTICK_RANGE == value) ||
+        (-JOYSTICK_RANGE == value) ||
+        (JOYSTICK_HYSTERESIS <= change) || (-JOYSTICK_HYSTERESIS >= change))
+    {
+        axis->value = value;
+    }
+    return (axis->value);
+}
+
+//------------------------------------------------------------------------------
+// JOYSTICK_cal_begin
+//------------------------------------------------------------------------------
+
+void JOYSTICK_cal_begin(joystick_cal_t *cal, uint16_t center)
+{
+    cal->min = center;
+    cal->center = center;
+    cal->max = center;
+}
+
+//------------------------------------------------------------------------------
+// JOYSTICK_cal_track
+//------------------------------------------------------------------------------
+
+void JOYSTICK_cal_track(joystick_cal_t *cal, uint16_t raw)
+{
+    if (raw < cal->min)
+    {
+        cal->min = raw;
+    }
+    if (raw > cal->max)
+    {
+        cal->max = raw;
+    }
+}
+
+//------------------------------------------------------------------------------
+// JOYSTICK_cal_is_valid
+//------------------------------------------------------------------------------
+
+bool_t JOYSTICK_cal_is_valid(const joystick_cal_t *cal)
+{
+    return ((cal->min + _JOYSTICK_EXTENT_MIN <= cal->center) &&
+            (cal->center + _JOYSTICK_EXTENT_MIN <= cal->max) &&
+            (1023U >= cal->max));
+}
+
+//------------------------------------------------------------------------------
+// JOYSTICK_cal_load
+//------------------------------------------------------------------------------
+
+bool_t JOYSTICK_cal_load(joystick_cal_t *cal, length_t count)
+{
+    _joystick_record_t record;
+
+    eeprom_read_block(&record, &g_joystick_record, sizeof(record));
+    if ((_JOYSTICK_EEPROM_VERSION != record.version) ||
+        (count != record.count) || (JOYSTICK_CAL_MAX < count) ||
+        (_JOYSTICK_crc(&record) != record.crc))
+    {
+        return (FALSE);
+    }
+    for (length_t i = 0; i < count; ++i)
+    {
+        if (!JOYSTICK_cal_is_valid(&record.cal[i]))
+        {
+            return (FALSE);
+        }
+    }
+    for (length_t i = 0; i < count; ++i)
+    {
+        cal[i] = record.cal[i];
+    }
+    return (TRUE);
+}
+
+//------------------------------------------------------------------------------
+// JOYSTICK_cal_save
+//------------------------------------------------------------------------------
+
+void JOYSTICK_cal_save(const joystick_cal_t *cal, length_t count)
+{
+    _joystick_record_t record = {0};
+
+    if (JOYSTICK_CAL_MAX < count)
+    {
+        count = JOYSTICK_CAL_MAX;
+    }
+    record.version = _JOYSTICK_EEPROM_VERSION;
+    record.count = count;
+    for (length_t i = 0; i < count; ++i)
+    {
+        record.cal[i] = cal[i];
+    }
+    record.crc = _JOYSTICK_crc(&record);
+    eeprom_update_block(&record, &g_joystick_record, sizeof(record));
+}
+
 //------------------------------------------------------------------------------
 // Inline Functions
 //------------------------------------------------------------------------------
@@ -6,6 +6,13 @@
 #define NRF24L01_DELAY_RX 130      ///< RX Settling for 130us
 #define NRF24L01_DELAY_TX 150      ///< TX Settling for 130us
 
+// a compile-time Chip Enable pin is driven with a single sbi/cbi
+#ifdef NRF24L01_PIN_CE
+#define _NRF24L01_ce(state) PIN_write(NRF24L01_PIN_CE, state)
+#else
+#define _NRF24L01_ce(state) PIN_write(nrf24l01_ce, state)
+#endif
+
 //------------------------------------------------------------------------------
 // NRF24L01 register maps
 //------------------------------------------------------------------------------
@@ -67,8 +74,11 @@
 
 #define LNA_HCURR 0 ///< Setup LNA gain
 #define RF_DR 3     ///< Air Data Rate (0: 1Mbps, 1: 2Mbps)
+#define RF_DR_LOW 5 ///< Air Data Rate 250kbps (nRF24L01+ only)
+
+#define ARC_CNT 0x0F ///< Count retransmitted packets, mask of `OBSERVE_TX`
 
-byte_t nrf24l01_csn;        ///< CSN pin
+spi_device_t nrf24l01_spi;  ///< SPI device (CSN pin)
 byte_t nrf24l01_ce;         ///< CE pin
 byte_t nrf24l01_config;     ///< CONFIG register
 byte_t nrf24l01_addr_rx[5]; ///< RX address
@@ -128,15 +138,13 @@ static void NRF24L01_write_register(byte_t reg, const byte_t *src, length_t len)
 void NRF24L01_init(pin_t ce, pin_t csn)
 {
     nrf24l01_ce = ce;
-    nrf24l01_csn = csn;
 
     // set `ce` low and `csn` high
     PIN_mode(nrf24l01_ce, PIN_OUTPUT);
-    PIN_mode(nrf24l01_csn, PIN_OUTPUT);
     PIN_write(nrf24l01_ce, PIN_LOW);
-    PIN_write(nrf24l01_csn, PIN_HIGH);
 
-    SPI_init(SPI_MSB, SPI_MODE0, SPI_PS4);
+    // SPI clock up to 10MHz: F_CPU / 2
+    nrf24l01_spi = SPI_device_new(csn, SPI_MSB, SPI_MODE0, SPI_PS2);
 
     delay(NRF24L01_DELAY_POWERUP); // wait for NRF24L01 to stablilize
 
@@ -151,7 +159,7 @@ void NRF24L01_init(pin_t ce, pin_t csn)
 
 void NRF24L01_enable(void)
 {
-    PIN_write(nrf24l01_ce, PIN_HIGH);
+    _NRF24L01_ce(PIN_HIGH);
 }
 
 //------------------------------------------------------------------------------
@@ -160,7 +168,7 @@ void NRF24L01_enable(void)
 
 void NRF24L01_disable(void)
 {
-    PIN_write(nrf24l01_ce, PIN_LOW);
+    _NRF24L01_ce(PIN_LOW);
 }
 
 //------------------------------------------------------------------------------
@@ -241,6 +249,15 @@ byte_t NRF24L01_status(void)
     return (NRF24L01_get_register(STATUS));
 }
 
+//------------------------------------------------------------------------------
+// NRF24L01_retransmit_count
+//------------------------------------------------------------------------------
+
+byte_t NRF24L01_retransmit_count(void)
+{
+    return (NRF24L01_get_register(OBSERVE_TX) & ARC_CNT);
+}
+
 //------------------------------------------------------------------------------
 // NRF24L01_clear_status
 //------------------------------------------------------------------------------
@@ -272,6 +289,17 @@ void NRF24L01_flush_tx(void)
     NRF24L01_spi_stop();
 }
 
+//------------------------------------------------------------------------------
+// NRF24L01_reuse_payload
+//------------------------------------------------------------------------------
+
+void NRF24L01_reuse_payload(void)
+{
+    NRF24L01_spi_start();
+    SPI_transmit(REUSE_TX_PL);
+    NRF24L01_spi_stop();
+}
+
 //------------------------------------------------------------------------------
 // NRF24L01_flush_rx
 //------------------------------------------------------------------------------
@@ -290,7 +318,7 @@ void NRF24L01_flush_rx(void)
 bool_t NRF24L01_is_rx_empty(void)
 {
     byte_t fifo = NRF24L01_get_register(FIFO_STATUS);
-    SERIAL_print(str, "FIFO: 0x");
+    SERIAL_print_P(str, "FIFO: 0x");
     SERIAL_println(hex, fifo, 2);
 
     return (BIT_is_set(NRF24L01_get_register(FIFO_STATUS),
@@ -364,7 +392,7 @@ void NRF24L01_write_payload(const byte_t *buff, length_t len)
 static void NRF24L01_print_register(const char *tag, byte_t reg, bool_t hex)
 {
     byte_t value = NRF24L01_get_register(reg);
-    SERIAL_print(str, tag);
+    SERIAL_print_str_P(tag);
     if (hex)
     {
         SERIAL_println(hex, value, 2);
@@ -429,7 +457,12 @@ void NRF24L01_set_address_tx(const byte_t *addr)
 
 void NRF24L01_spi_start(void)
 {
-    PIN_write(nrf24l01_csn, PIN_LOW);
+#ifdef NRF24L01_PIN_CSN
+    SPI_acquire(&nrf24l01_spi);
+    PIN_write(NRF24L01_PIN_CSN, PIN_LOW);
+#else
+    SPI_begin(&nrf24l01_spi);
+#endif
 }
 
 //------------------------------------------------------------------------------
@@ -438,7 +471,11 @@ void NRF24L01_spi_start(void)
 
 void NRF24L01_spi_stop(void)
 {
-    PIN_write(nrf24l01_csn, PIN_HIGH);
+#ifdef NRF24L01_PIN_CSN
+    PIN_write(NRF24L01_PIN_CSN, PIN_HIGH);
+#else
+    SPI_end(&nrf24l01_spi);
+#endif
 }
 
 //------------------------------------------------------------------------------
@@ -498,15 +535,15 @@ byte_t *NRF24L01_copy_address(byte_t *dst, const byte_t *src, length_t len)
 static void NRF24L01_print_status(void)
 {
     byte_t status = NRF24L01_get_register(STATUS);
-    SERIAL_print(str, "STATUS     = 0x");
+    SERIAL_print_P(str, "STATUS     = 0x");
     SERIAL_print(hex, status, 2);
-    SERIAL_print(str, " RX_DR=");
+    SERIAL_print_P(str, " RX_DR=");
     SERIAL_print(uint, (status & NRF24L01_RX_DR) >> 5);
-    SERIAL_print(str, " TX_DS=");
+    SERIAL_print_P(str, " TX_DS=");
     SERIAL_print(uint, (status & NRF24L01_MAX_RT) >> 4);
-    SERIAL_print(str, " RX_PIPE=");
+    SERIAL_print_P(str, " RX_PIPE=");
     SERIAL_print(uint, (status & 0x0E) >> 1);
-    SERIAL_print(str, " TX_FULL=");
+    SERIAL_print_P(str, " TX_FULL=");
     SERIAL_println(uint, status & 0x01);
 }
 
@@ -528,9 +565,9 @@ static void NRF24L01_print_address(pipe_t pipe)
         addr[nrf24l01_aw - 1] = SPI_receive();
     }
     NRF24L01_spi_stop();
-    SERIAL_print(str, "PIPE ");
+    SERIAL_print_P(str, "PIPE ");
     SERIAL_print(uint, pipe);
-    SERIAL_print(str, ": 0x");
+    SERIAL_print_P(str, ": 0x");
     for (length_t i = 0; i < nrf24l01_aw; ++i)
     {
         SERIAL_print(hex, addr[nrf24l01_aw - 1 - i], 2);
@@ -539,7 +576,7 @@ static void NRF24L01_print_address(pipe_t pipe)
             break;
         }
     }
-    SERIAL_println(str, "");
+    SERIAL_println_P(str, "");
 }
 
 //------------------------------------------------------------------------------
@@ -553,12 +590,12 @@ static void NRF24L01_print_address_tx(void)
     SPI_transmit(R_REGISTER | TX_ADDR);
     SPI_read(addr, nrf24l01_aw);
     NRF24L01_spi_stop();
-    SERIAL_print(str, "TX_ADDR    = 0x");
+    SERIAL_print_P(str, "TX_ADDR    = 0x");
     for (length_t i = 0; i < nrf24l01_aw; ++i)
     {
         SERIAL_print(hex, addr[nrf24l01_aw - 1 - i], 2);
     }
-    SERIAL_println(str, "");
+    SERIAL_println_P(str, "");
 }
 
 //------------------------------------------------------------------------------
@@ -568,38 +605,42 @@ static void NRF24L01_print_address_tx(void)
 static void NRF24L01_print_setup(void)
 {
     byte_t setup = NRF24L01_get_register(RF_SETUP);
-    if (BIT_is_set(setup, BIT(RF_DR)))
+    if (BIT_is_set(setup, BIT(RF_DR_LOW)))
+    {
+        SERIAL_println_P(str, "Data Rate  = 250 KBPS");
+    }
+    else if (BIT_is_set(setup, BIT(RF_DR)))
     {
-        SERIAL_println(str, "Data Rate  = 2 MBPS");
+        SERIAL_println_P(str, "Data Rate  = 2 MBPS");
     }
     else
     {
-        SERIAL_println(str, "Data Rate  = 1 MBPS");
+        SERIAL_println_P(str, "Data Rate  = 1 MBPS");
     }
     switch ((setup & 0x06) >> 1)
     {
     case 0x00:
-        SERIAL_println(str, "RF output  = -18dBm");
+        SERIAL_println_P(str, "RF output  = -18dBm");
         break;
     case 0x01:
-        SERIAL_println(str, "RF output  = -12dBm");
+        SERIAL_println_P(str, "RF output  = -12dBm");
         break;
     case 0x02:
-        SERIAL_println(str, "RF output  = -6dBm");
+        SERIAL_println_P(str, "RF output  = -6dBm");
         break;
     case 0x03:
-        SERIAL_println(str, "RF output  = 0dBm");
+        SERIAL_println_P(str, "RF output  = 0dBm");
         break;
     default:
         break;
     }
     if (BIT_is_set(setup, BIT(LNA_HCURR)))
     {
-        SERIAL_println(str, "LNA gain   = enabled");
+        SERIAL_println_P(str, "LNA gain   = enabled");
     }
     else
     {
-        SERIAL_println(str, "LNA gain   = disabled");
+        SERIAL_println_P(str, "LNA gain   = disabled");
     }
 }
 
@@ -615,25 +656,25 @@ void NRF24L01_print(void)
         NRF24L01_print_address(i);
     }
     NRF24L01_print_address_tx();
-    SERIAL_println(str, "Payload width:");
-    NRF24L01_print_register(" - Pipe 0  = ", RX_PW_P0, 0);
-    NRF24L01_print_register(" - Pipe 1  = ", RX_PW_P1, 0);
-    NRF24L01_print_register(" - Pipe 2  = ", RX_PW_P2, 0);
-    NRF24L01_print_register(" - Pipe 3  = ", RX_PW_P3, 0);
-    NRF24L01_print_register(" - Pipe 4  = ", RX_PW_P4, 0);
-    NRF24L01_print_register(" - Pipe 5  = ", RX_PW_P5, 0);
-    NRF24L01_print_register("EN_AA      = 0x", EN_AA, 1);
-    NRF24L01_print_register("EN_RXADDR  = 0x", EN_RXADDR, 1);
-    NRF24L01_print_register("RF_CH      = 0x", RF_CH, 1);
-    NRF24L01_print_register("RF_SETUP   = 0x", RF_SETUP, 1);
-    NRF24L01_print_register("CONFIG     = 0x", CONFIG, 1);
-    NRF24L01_print_register("DYNPD      = 0x", DYNPD, 1);
-    NRF24L01_print_register("FEATURE    = 0x", FEATURE, 1);
+    SERIAL_println_P(str, "Payload width:");
+    NRF24L01_print_register(PSTR(" - Pipe 0  = "), RX_PW_P0, 0);
+    NRF24L01_print_register(PSTR(" - Pipe 1  = "), RX_PW_P1, 0);
+    NRF24L01_print_register(PSTR(" - Pipe 2  = "), RX_PW_P2, 0);
+    NRF24L01_print_register(PSTR(" - Pipe 3  = "), RX_PW_P3, 0);
+    NRF24L01_print_register(PSTR(" - Pipe 4  = "), RX_PW_P4, 0);
+    NRF24L01_print_register(PSTR(" - Pipe 5  = "), RX_PW_P5, 0);
+    NRF24L01_print_register(PSTR("EN_AA      = 0x"), EN_AA, 1);
+    NRF24L01_print_register(PSTR("EN_RXADDR  = 0x"), EN_RXADDR, 1);
+    NRF24L01_print_register(PSTR("RF_CH      = 0x"), RF_CH, 1);
+    NRF24L01_print_register(PSTR("RF_SETUP   = 0x"), RF_SETUP, 1);
+    NRF24L01_print_register(PSTR("CONFIG     = 0x"), CONFIG, 1);
+    NRF24L01_print_register(PSTR("DYNPD      = 0x"), DYNPD, 1);
+    NRF24L01_print_register(PSTR("FEATURE    = 0x"), FEATURE, 1);
     NRF24L01_print_setup();
 
-    NRF24L01_print_register("SETUP_AW   = 0x", SETUP_AW, 1);
-    NRF24L01_print_register("SETUP_RETR = 0x", SETUP_RETR, 1);
-    NRF24L01_print_register("OBSERVE_TX = 0x", OBSERVE_TX, 1);
+    NRF24L01_print_register(PSTR("SETUP_AW   = 0x"), SETUP_AW, 1);
+    NRF24L01_print_register(PSTR("SETUP_RETR = 0x"), SETUP_RETR, 1);
+    NRF24L01_print_register(PSTR("OBSERVE_TX = 0x"), OBSERVE_TX, 1);
 }
 
 //------------------------------------------------------------------------------
@@ -643,19 +684,19 @@ void NRF24L01_print(void)
 void NRF24L01_print_config(void)
 {
     byte_t config = NRF24L01_get_register(CONFIG);
-    SERIAL_println(str, "CONFIG:");
-    SERIAL_print(str, " - MASK_RX_DR  = ");
+    SERIAL_println_P(str, "CONFIG:");
+    SERIAL_print_P(str, " - MASK_RX_DR  = ");
     SERIAL_println(bool, BIT_is_set(config, (1 << 6)));
-    SERIAL_print(str, " - MASK_TX_DS  = ");
+    SERIAL_print_P(str, " - MASK_TX_DS  = ");
     SERIAL_println(bool, BIT_is_set(config, (1 << 5)));
-    SERIAL_print(str, " - MASK_MAX_RT = ");
+    SERIAL_print_P(str, " - MASK_MAX_RT = ");
     SERIAL_println(bool, BIT_is_set(config, (1 << 4)));
-    SERIAL_print(str, " - EN_CRC      = ");
+    SERIAL_print_P(str, " - EN_CRC      = ");
     SERIAL_println(bool, BIT_is_set(config, (1 << 3)));
-    SERIAL_print(str, " - CRC         = ");
+    SERIAL_print_P(str, " - CRC         = ");
     SERIAL_println(uint, (config & 0x04) / 4 + 1);
-    SERIAL_print(str, " - PWR_UP      = ");
+    SERIAL_print_P(str, " - PWR_UP      = ");
     SERIAL_println(bool, BIT_is_set(config, (1 << 1)));
-    SERIAL_print(str, " - PRIM_RX     = ");
+    SERIAL_print_P(str, " - PRIM_RX     = ");
     SERIAL_println(bool, BIT_is_set(config, (1 << 0)));
 }
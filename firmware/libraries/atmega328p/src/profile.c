@@ -0,0 +1,210 @@
+#include "profile.h"
+
+#ifdef VEMAR_PROFILE_ENABLED
+
+#include <avr/interrupt.h>
+
+#include "serial.h"
+#include "trace.h"
+#include "timer.h"
+
+#if defined(PROFILE_CLOCK_TICK) && defined(PROFILE_CLOCK_SIM)
+#error "PROFILE_CLOCK_TICK and PROFILE_CLOCK_SIM are exclusive"
+#endif
+
+#ifdef PROFILE_CLOCK_TICK
+#define _PROFILE_UNIT "us"
+#else
+#define _PROFILE_UNIT "cycles"
+#endif
+
+#if !defined(PROFILE_CLOCK_TICK) && !defined(PROFILE_CLOCK_SIM)
+static volatile uint16_t g_profile_overflows; /**< High word of the clock */
+#endif
+
+static profile_entry_t g_profile[PROFILE_COUNT];
+#ifndef PROFILE_CLOCK_SIM
+static uint32_t g_profile_start[PROFILE_COUNT];
+static uint32_t g_profile_overhead; /**< Cost of an empty section */
+
+//------------------------------------------------------------------------------
+// _PROFILE_now
+//------------------------------------------------------------------------------
+
+/**
+ * @brief Read the profiling clock
+ */
+static uint32_t _PROFILE_now(void)
+{
+#ifdef PROFILE_CLOCK_TICK
+    return (TIMER_micros());
+#else
+    uint16_t high;
+    uint16_t low;
+    byte_t sreg = SREG;
+
+    cli();
+    low = TCNT1;
+    high = g_profile_overflows;
+    if (BIT_is_set(TIFR1, BIT(TOV1)) && (0x8000 > low))
+    {
+        ++high;
+    } // wrapped, the overflow interrupt has not run yet
+    SREG = sreg;
+    return (((uint32_t)high << 16) | low);
+#endif
+}
+#endif // PROFILE_CLOCK_SIM
+
+//------------------------------------------------------------------------------
+// PROFILE_init
+//------------------------------------------------------------------------------
+
+void PROFILE_init(void)
+{
+#ifdef PROFILE_CLOCK_SIM
+    PROFILE_reset(); // no clock, the simulator times the markers
+#else
+#ifndef PROFILE_CLOCK_TICK
+    TCCR1A = 0x00;
+    TCCR1B = (byte_t)(TIMER1_PS1); // normal mode, free-running
+    BIT_set(TIFR1, BIT(TOV1));
+    BIT_set(TIMSK1, BIT(TOIE1));
+#endif
+    g_profile_overhead = 0;
+    PROFILE_begin(PROFILE_USER0);
+    PROFILE_end(PROFILE_USER0);
+    g_profile_overhead = g_profile[PROFILE_USER0].min;
+    PROFILE_reset();
+#endif
+}
+
+//------------------------------------------------------------------------------
+// PROFILE_reset
+//------------------------------------------------------------------------------
+
+void PROFILE_reset(void)
+{
+    for (byte_t id = 0; id < PROFILE_COUNT; ++id)
+    {
+        g_profile[id].count = 0;
+        g_profile[id].min = UINT32_MAX;
+        g_profile[id].max = 0;
+        g_profile[id].total = 0;
+    }
+}
+
+//------------------------------------------------------------------------------
+// PROFILE_begin
+//------------------------------------------------------------------------------
+
+void PROFILE_begin(profile_id_t id)
+{
+#ifdef PROFILE_CLOCK_SIM
+    PROFILE_SIM_BEGIN = id;
+#else
+    g_profile_start[id] = _PROFILE_now();
+#endif
+}
+
+//------------------------------------------------------------------------------
+// PROFILE_end
+//------------------------------------------------------------------------------
+
+void PROFILE_end(profile_id_t id)
+{
+#ifdef PROFILE_CLOCK_SIM
+    PROFILE_SIM_END = id;
+#else
+    uint32_t elapsed = _PROFILE_now() - g_profile_start[id];
+    profile_entry_t *entry = &g_profile[id];
+
+    elapsed = (g_profile_overhead < elapsed) ? elapsed - g_profile_overhead : 0;
+    ++entry->count;
+    entry->total += elapsed;
+    if (entry->min > elapsed)
+    {
+        entry->min = elapsed;
+    }
+    if (entry->max < elapsed)
+    {
+        entry->max = elapsed;
+    }
+#endif
+}
+
+//------------------------------------------------------------------------------
+// PROFILE_get
+//------------------------------------------------------------------------------
+
+void PROFILE_get(profile_id_t id, profile_entry_t *entry)
+{
+    byte_t sreg = SREG;
+
+    cli(); // a section may end in an interrupt
+    *entry = g_profile[id];
+    SREG = sreg;
+}
+
+//------------------------------------------------------------------------------
+// PROFILE_report
+//------------------------------------------------------------------------------
+
+void PROFILE_report(void)
+{
+    profile_entry_t entry;
+
+    SERIAL_printf_P(PSTR("id count min max total (%S)\r\n"),
+                    PSTR(_PROFILE_UNIT));
+    for (byte_t id = 0; id < PROFILE_COUNT; ++id)
+    {
+        PROFILE_get(id, &entry);
+        if (0 != entry.count)
+        {
+            SERIAL_printf_P(PSTR("%u %u %lu %lu %lu\r\n"), id, entry.count,
+                            entry.min, entry.max, entry.total);
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+// PROFILE_report_trace
+//------------------------------------------------------------------------------
+
+void PROFILE_report_trace(void)
+{
+    profile_entry_t entry;
+    byte_t payload[TRACE_PROFILE_SIZE];
+
+    for (byte_t id = 0; id < PROFILE_COUNT; ++id)
+    {
+        PROFILE_get(id, &entry);
+        if (0 == entry.count)
+        {
+            continue;
+        }
+        payload[0] = id;
+        payload[1] = (byte_t)(entry.count & 0xFF);
+        payload[2] = (byte_t)(entry.count >> 8);
+        for (byte_t i = 0; i < 4; ++i)
+        {
+            payload[3 + i] = (byte_t)(entry.min >> (8 * i));
+            payload[7 + i] = (byte_t)(entry.max >> (8 * i));
+            payload[11 + i] = (byte_t)(entry.total >> (8 * i));
+        }
+        TRACE_record(TRACE_ID_PROFILE, payload, sizeof(payload));
+    }
+}
+
+#if !defined(PROFILE_CLOCK_TICK) && !defined(PROFILE_CLOCK_SIM)
+//------------------------------------------------------------------------------
+// ISR
+//------------------------------------------------------------------------------
+
+ISR(TIMER1_OVF_vect)
+{
+    ++g_profile_overflows;
+}
+#endif
+
+#endif // VEMAR_PROFILE_ENABLED
@@ -1,7 +1,20 @@
 #include "radio.h"
+#include "profile.h"
+#include "timer.h"
 
 #define RADIO_DEFAULT_FREQUENCY 42 /**< Default frequency */
 
+#define RADIO_LINK_WINDOW 32U    /**< Transmissions per link evaluation */
+#define RADIO_LINK_LOSS_MAX 3U   /**< Losses per window before stepping down */
+#define RADIO_LINK_RETRY_MAX 64U /**< Retries per window before stepping down */
+#define RADIO_LINK_RETRY_MIN 4U  /**< Retries per window below which to step up */
+
+/**
+ * @brief Milliseconds to wait for TX_DS or MAX_RT, above the 11 attempts of
+ * a full payload at 250 kbps
+ */
+#define RADIO_TX_TIMEOUT 50U
+
 typedef enum
 {
     RADIO_MODE_STANDBY,
@@ -10,6 +23,39 @@ typedef enum
 } radio_mode_t;
 
 radio_mode_t g_mode;
+bool_t g_reuse; /**< Last payload is still available for reuse */
+
+/**
+ * @brief Rate and power of each link profile
+ */
+static const struct
+{
+    rf_rate_t rate;
+    rf_power_t power;
+} g_radio_profile[RADIO_LINK_COUNT] = {
+    {NRF24L01_250KBPS, NRF24L01_0DBM},
+    {NRF24L01_1MBPS, NRF24L01_0DBM},
+    {NRF24L01_2MBPS, NRF24L01_0DBM},
+    {NRF24L01_2MBPS, NRF24L01_N6DBM},
+};
+
+/**
+ * @brief Link profile and statistics of the current window
+ */
+struct
+{
+    radio_link_t link; /**< Current link profile */
+    uint8_t sent;      /**< Transmissions */
+    uint8_t lost;      /**< Transmissions reaching maximum retransmission */
+    uint16_t retries;  /**< Sum of retransmissions */
+} g_link;
+
+/**
+ * @brief Pulse __CE__ and wait for the end of the transmission
+ * @return `TRUE` if the payload has been acknowledged, `FALSE` on maximum
+ * retransmission or after `RADIO_TX_TIMEOUT`
+ */
+static bool_t RADIO_transmit(void);
 
 //------------------------------------------------------------------------------
 // RADIO_init
@@ -19,7 +65,8 @@ void RADIO_init(pin_t ce, pin_t csn)
 {
     NRF24L01_init(ce, csn);
 
-    NRF24L01_setup(NRF24L01_1MBPS, NRF24L01_0DBM, 1);
+    g_link.link = RADIO_LINK_COUNT;
+    RADIO_set_link(RADIO_LINK_DEFAULT);
     NRF24L01_set_frequency(RADIO_DEFAULT_FREQUENCY);
     NRF24L01_clear_status();
 
@@ -35,6 +82,7 @@ void RADIO_init(pin_t ce, pin_t csn)
 
     NRF24L01_power_up();
     g_mode = RADIO_MODE_STANDBY;
+    g_reuse = FALSE;
 }
 
 //------------------------------------------------------------------------------
@@ -63,13 +111,59 @@ bool_t RADIO_read(byte_t *dst, length_t len)
 
 bool_t RADIO_write(const byte_t *payload, length_t len)
 {
+    bool_t sent;
+
+    PROFILE_BEGIN(PROFILE_RADIO_WRITE);
     NRF24L01_disable();
+    if (g_reuse)
+    {
+        NRF24L01_flush_tx();
+    } // the reused payload would be sent again before the new one
     NRF24L01_write_payload(payload, len);
+    g_reuse = TRUE;
 
-    NRF24L01_mode_tx();
+    sent = RADIO_transmit();
+    PROFILE_END(PROFILE_RADIO_WRITE);
+    return (sent);
+}
+
+//------------------------------------------------------------------------------
+// RADIO_resend
+//------------------------------------------------------------------------------
+
+bool_t RADIO_resend(void)
+{
+    if (FALSE == g_reuse)
+    {
+        return (FALSE);
+    } // last payload was flushed
     NRF24L01_disable();
+    NRF24L01_reuse_payload();
+
+    return (RADIO_transmit());
+}
+
+//------------------------------------------------------------------------------
+// RADIO_can_resend
+//------------------------------------------------------------------------------
+
+bool_t RADIO_can_resend(void)
+{
+    return (g_reuse);
+}
 
+//------------------------------------------------------------------------------
+// RADIO_transmit
+//------------------------------------------------------------------------------
+
+bool_t RADIO_transmit(void)
+{
+    uint32_t start = TIMER_millis();
     byte_t status = 0;
+
+    NRF24L01_mode_tx();
+    NRF24L01_disable();
+
     do
     {
         status = NRF24L01_status();
@@ -77,19 +171,96 @@ bool_t RADIO_write(const byte_t *payload, length_t len)
         {
             break;
         } // max retransission reached
-        // delay(100);
+        if (TIMER_elapsed(start) >= RADIO_TX_TIMEOUT)
+        {
+            BIT_set(status, NRF24L01_MAX_RT);
+            break;
+        } // nothing was sent, e.g. the TX FIFO was empty
     } while (BIT_is_clear(status, NRF24L01_TX_DS)); // wait transmit complete
 
-    NRF24L01_standby();
+    ++g_link.sent;
+    g_link.retries += NRF24L01_retransmit_count();
+
+    // the TX FIFO is kept, so that the payload can be reused
+    NRF24L01_clear_status();
+    NRF24L01_flush_rx();
     g_mode = RADIO_MODE_STANDBY;
 
     if (BIT_is_set(status, NRF24L01_MAX_RT))
     {
         NRF24L01_flush_tx();
+        g_reuse = FALSE;
+        ++g_link.lost;
         return (FALSE); // failure
     } // flush TX FIFO
     return (TRUE); // success;
 }
 
+//------------------------------------------------------------------------------
+// RADIO_set_link
+//------------------------------------------------------------------------------
+
+void RADIO_set_link(radio_link_t link)
+{
+    if (RADIO_LINK_COUNT <= link)
+    {
+        return;
+    } // unknown profile
+    if (link != g_link.link)
+    {
+        NRF24L01_disable();
+        NRF24L01_setup(g_radio_profile[link].rate,
+                       g_radio_profile[link].power, 1);
+        g_link.link = link;
+        g_mode = RADIO_MODE_STANDBY; // RX mode must be entered again
+    }
+    g_link.sent = 0;
+    g_link.lost = 0;
+    g_link.retries = 0;
+}
+
+//------------------------------------------------------------------------------
+// RADIO_get_link
+//------------------------------------------------------------------------------
+
+radio_link_t RADIO_get_link(void)
+{
+    return (g_link.link);
+}
+
+//------------------------------------------------------------------------------
+// RADIO_evaluate_link
+//------------------------------------------------------------------------------
+
+radio_link_t RADIO_evaluate_link(void)
+{
+    radio_link_t link = g_link.link;
+
+    if (RADIO_LINK_WINDOW > g_link.sent)
+    {
+        return (link);
+    } // not enough transmissions
+    if ((RADIO_LINK_LOSS_MAX <= g_link.lost) ||
+        (RADIO_LINK_RETRY_MAX <= g_link.retries))
+    {
+        if (RADIO_LINK_250KBPS < link)
+        {
+            --link;
+        }
+    } // step down to a more robust profile
+    else if ((0 == g_link.lost) && (RADIO_LINK_RETRY_MIN > g_link.retries))
+    {
+        if (RADIO_LINK_2MBPS_LOW > link)
+        {
+            ++link;
+        }
+    } // step up to a faster profile
+    g_link.sent = 0;
+    g_link.lost = 0;
+    g_link.retries = 0;
+
+    return (link);
+}
+
 extern inline void RADIO_set_address_tx(const byte_t *);
 extern inline void RADIO_set_address_rx(pipe_t, const byte_t *);
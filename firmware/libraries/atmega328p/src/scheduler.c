@@ -0,0 +1,181 @@
+#include "scheduler.h"
+#include "timer.h"
+#include "config.h"
+
+/**
+ * @brief Task slot
+ */
+typedef struct
+{
+    sched_fn_t fn;       /**< Function, `NULL` if the slot is free */
+    uint32_t release;    /**< Time of the next release, in milliseconds */
+    uint16_t period;     /**< Period, `0` for a one-shot task */
+    uint16_t deadline;   /**< Relative deadline, `0` for none */
+    sched_prio_t prio;   /**< Priority */
+    sched_stats_t stats; /**< Execution statistics */
+} sched_task_t;
+
+static sched_task_t g_sched_task[SCHED_TASK_MAX];
+
+//------------------------------------------------------------------------------
+// _SCHED_add
+//------------------------------------------------------------------------------
+
+static sched_id_t _SCHED_add(sched_fn_t fn, uint16_t period, uint16_t delay,
+                             sched_prio_t prio)
+{
+    for (sched_id_t id = 0; id < SCHED_TASK_MAX; ++id)
+    {
+        sched_task_t *task = &g_sched_task[id];
+
+        if (NULL == task->fn)
+        {
+            task->fn = fn;
+            task->release = TIMER_millis() + delay;
+            task->period = period;
+            task->deadline = period;
+            task->prio = prio;
+            task->stats = (sched_stats_t){0};
+            return (id);
+        }
+    }
+    return (SCHED_INVALID);
+}
+
+//------------------------------------------------------------------------------
+// SCHED_every
+//------------------------------------------------------------------------------
+
+sched_id_t SCHED_every(sched_fn_t fn, uint16_t period, sched_prio_t prio)
+{
+    return (_SCHED_add(fn, period, 0, prio));
+}
+
+//------------------------------------------------------------------------------
+// SCHED_after
+//------------------------------------------------------------------------------
+
+sched_id_t SCHED_after(sched_fn_t fn, uint16_t delay, sched_prio_t prio)
+{
+    return (_SCHED_add(fn, 0, delay, prio));
+}
+
+//------------------------------------------------------------------------------
+// SCHED_set_deadline
+//------------------------------------------------------------------------------
+
+void SCHED_set_deadline(sched_id_t id, uint16_t deadline)
+{
+    if (SCHED_TASK_MAX > id)
+    {
+        g_sched_task[id].deadline = deadline;
+    }
+}
+
+//------------------------------------------------------------------------------
+// SCHED_cancel
+//------------------------------------------------------------------------------
+
+void SCHED_cancel(sched_id_t id)
+{
+    if (SCHED_TASK_MAX > id)
+    {
+        g_sched_task[id].fn = NULL;
+    }
+}
+
+//------------------------------------------------------------------------------
+// SCHED_dispatch
+//------------------------------------------------------------------------------
+
+bool_t SCHED_dispatch(void)
+{
+    uint32_t now = TIMER_millis();
+    sched_task_t *next = NULL;
+    uint32_t next_due = 0;
+
+    for (sched_id_t id = 0; id < SCHED_TASK_MAX; ++id)
+    {
+        sched_task_t *task = &g_sched_task[id];
+        uint32_t due;
+
+        if ((NULL == task->fn) || (0 > (int32_t)(now - task->release)))
+        {
+            continue;
+        } // free slot, or not released yet
+        due = task->release + task->deadline;
+        if ((NULL == next) || (task->prio < next->prio) ||
+            ((task->prio == next->prio) && (0 > (int32_t)(due - next_due))))
+        {
+            next = task;
+            next_due = due;
+        }
+    }
+    if (NULL == next)
+    {
+        return (FALSE);
+    }
+
+    uint32_t late = now - next->release;
+    uint32_t start = TIMER_micros();
+
+    next->fn();
+
+    uint32_t elapsed = TIMER_micros() - start;
+    sched_stats_t *stats = &next->stats;
+
+    ++stats->runs;
+    stats->total_us += elapsed;
+    if (stats->max_us < elapsed)
+    {
+        stats->max_us = (UINT16_MAX < elapsed) ? UINT16_MAX : elapsed;
+    }
+    if (stats->max_late < late)
+    {
+        stats->max_late = (UINT16_MAX < late) ? UINT16_MAX : late;
+    }
+    if ((0 != next->deadline) &&
+        (0 < (int32_t)(TIMER_millis() - next_due)))
+    {
+        ++stats->overruns;
+    } // finished after its deadline
+
+    if (0 == next->period)
+    {
+        next->fn = NULL;
+    } // one-shot: free the slot
+    else
+    {
+        next->release += next->period;
+        if (0 <= (int32_t)(now - next->release - next->period))
+        {
+            next->release = now + next->period;
+            ++stats->overruns;
+        } // a whole period behind: drop the missed releases
+    }
+    return (TRUE);
+}
+
+//------------------------------------------------------------------------------
+// SCHED_get_stats
+//------------------------------------------------------------------------------
+
+void SCHED_get_stats(sched_id_t id, sched_stats_t *stats)
+{
+    if (SCHED_TASK_MAX > id)
+    {
+        *stats = g_sched_task[id].stats;
+    }
+}
+
+//------------------------------------------------------------------------------
+// SCHED_reset_stats
+//------------------------------------------------------------------------------
+
+void SCHED_reset_stats(void)
+{
+    for (sched_id_t id = 0; id < SCHED_TASK_MAX; ++id)
+    {
+        g_sched_task[id].stats = (sched_stats_t){0};
+    }
+}
@@ -1,10 +1,7 @@
-#include <limits.h>
+#include <stdarg.h>
 
 #include "serial.h"
-
-#define SERIAL_BASE_STRING "0123456789ABCDEF"
-#define SERIAL_BASE_DECIMAL 10
-#define SERIAL_BASE_HEXADECIMAL 16
+#include "fmt.h"
 
 #define SERIAL_BUFFER_SIZE 32
 
@@ -16,26 +13,6 @@
 
 char serial_buffer[SERIAL_BUFFER_SIZE];
 
-static void SERIAL_print_base(unsigned long nbr, byte_t radix, byte_t len)
-{
-    if ((0 == nbr) && (1 == len))
-    {
-        UART_transmit((byte_t)SERIAL_BASE_STRING[0]);
-        return;
-    }
-    byte_t pos = (nbr % radix);
-    nbr /= radix;
-    if (1 < len)
-    {
-        SERIAL_print_base(nbr, radix, len - 1);
-    }
-    else if (0 < nbr)
-    {
-        SERIAL_print_base(nbr, radix, len);
-    }
-    UART_transmit((byte_t)SERIAL_BASE_STRING[pos]);
-}
-
 void SERIAL_init(void)
 {
     UART_init(UART_8N1, UART_TX | UART_RX);
@@ -48,45 +25,42 @@ void SERIAL_print_char(char ch)
 
 void SERIAL_print_int(int nbr)
 {
-    if (0 > nbr)
-    {
-        UART_transmit((byte_t)'-');
-        SERIAL_print_base(ULONG_MAX - (unsigned long)nbr + 1UL,
-                          SERIAL_BASE_DECIMAL, 1);
-    }
-    else
-    {
-        SERIAL_print_base((unsigned long)(nbr), SERIAL_BASE_DECIMAL, 1);
-    }
+    char buf[FMT_BUFFER_SIZE];
+
+    FMT_i16(buf, (int16_t)nbr);
+    SERIAL_print_str(buf);
 }
 
 void SERIAL_print_uint(unsigned int nbr)
 {
-    SERIAL_print_base(nbr, SERIAL_BASE_DECIMAL, 1);
+    char buf[FMT_BUFFER_SIZE];
+
+    FMT_u16(buf, (uint16_t)nbr);
+    SERIAL_print_str(buf);
 }
 
 void SERIAL_print_long(long nbr)
 {
-    if (0 > nbr)
-    {
-        UART_transmit((byte_t)'-');
-        SERIAL_print_base(ULONG_MAX - (unsigned long)nbr + 1UL,
-                          SERIAL_BASE_DECIMAL, 1);
-    }
-    else
-    {
-        SERIAL_print_base((unsigned long)nbr, SERIAL_BASE_DECIMAL, 1);
-    }
+    char buf[FMT_BUFFER_SIZE];
+
+    FMT_i32(buf, (int32_t)nbr);
+    SERIAL_print_str(buf);
 }
 
 void SERIAL_print_ulong(unsigned long nbr)
 {
-    SERIAL_print_base(nbr, SERIAL_BASE_DECIMAL, 1);
+    char buf[FMT_BUFFER_SIZE];
+
+    FMT_u32(buf, (uint32_t)nbr);
+    SERIAL_print_str(buf);
 }
 
 void SERIAL_print_hex(unsigned long nbr, length_t len)
 {
-    SERIAL_print_base(nbr, SERIAL_BASE_HEXADECIMAL, len);
+    char buf[FMT_BUFFER_SIZE];
+
+    FMT_hex(buf, (uint32_t)nbr, len);
+    SERIAL_print_str(buf);
 }
 
 void SERIAL_print_str(const char *str)
@@ -102,12 +76,111 @@ void SERIAL_print_bool(bool_t bool)
 {
     if (bool)
     {
-        SERIAL_print_str("true");
+        SERIAL_print_str_P(PSTR("true"));
     }
     else
     {
-        SERIAL_print_str("false");
+        SERIAL_print_str_P(PSTR("false"));
+    }
+}
+
+void SERIAL_print_str_P(const char *str)
+{
+    char ch;
+
+    while ('\0' != (ch = (char)pgm_read_byte(str++)))
+    {
+        UART_transmit((byte_t)ch);
+    }
+}
+
+void SERIAL_printf_P(const char *fmt, ...)
+{
+    char buf[FMT_BUFFER_SIZE];
+    va_list args;
+    char ch;
+
+    va_start(args, fmt);
+    while ('\0' != (ch = (char)pgm_read_byte(fmt++)))
+    {
+        if ('%' != ch)
+        {
+            UART_transmit((byte_t)ch);
+            continue;
+        }
+
+        char pad = ' ';
+        length_t width = 0;
+        bool_t is_long = FALSE;
+        length_t len = 0;
+
+        ch = (char)pgm_read_byte(fmt++);
+        if ('0' == ch)
+        {
+            pad = '0';
+            ch = (char)pgm_read_byte(fmt++);
+        }
+        while (('0' <= ch) && ('9' >= ch))
+        {
+            width = width * 10 + (length_t)(ch - '0');
+            ch = (char)pgm_read_byte(fmt++);
+        }
+        if ('l' == ch)
+        {
+            is_long = TRUE;
+            ch = (char)pgm_read_byte(fmt++);
+        }
+
+        switch (ch)
+        {
+        case 'c':
+            buf[len++] = (char)va_arg(args, int);
+            buf[len] = '\0';
+            break;
+        case 'd':
+        case 'i':
+            len = is_long ? FMT_i32(buf, va_arg(args, int32_t))
+                          : FMT_i16(buf, (int16_t)va_arg(args, int));
+            break;
+        case 'u':
+            len = is_long ? FMT_u32(buf, va_arg(args, uint32_t))
+                          : FMT_u16(buf, (uint16_t)va_arg(args, unsigned int));
+            break;
+        case 'x':
+        case 'X':
+            len = FMT_hex(buf, is_long ? va_arg(args, uint32_t)
+                                       : va_arg(args, unsigned int),
+                          1);
+            break;
+        case 's':
+            SERIAL_print_str(va_arg(args, const char *));
+            continue;
+        case 'S':
+            SERIAL_print_str_P(va_arg(args, const char *));
+            continue;
+        case '\0':
+            va_end(args);
+            return; // format ends with '%'
+        default:
+            UART_transmit((byte_t)ch); // '%%' and unknown conversions
+            continue;
+        }
+
+        const char *digits = buf;
+
+        if (('0' == pad) && ('-' == *digits) && (len < width))
+        {
+            UART_transmit('-');
+            ++digits;
+        } // sign goes before the zeros
+        while (len < width)
+        {
+            UART_transmit((byte_t)pad);
+            ++len;
+        }
+        SERIAL_print_str(digits);
     }
+    va_end(args);
 }
 
 static void SERIAL_scan_buffer(void)
@@ -1,3 +1,5 @@
+#include <avr/pgmspace.h>
+
 #include "spi.h"
 
 #define SPI_SS 0x04   /**< PB2 (~Slave Select) */
@@ -7,6 +9,12 @@
 
 #define _SPI_MASK_PRESCALER 0x03
 
+/**
+ * @brief SPCR value of a master device
+ */
+#define _SPI_SPCR(order, mode, prescaler) \
+    (BIT(SPE) | (order) | BIT(MSTR) | (mode) | ((prescaler) & _SPI_MASK_PRESCALER))
+
 //------------------------------------------------------------------------------
 // SPI_init
 //------------------------------------------------------------------------------
@@ -19,12 +27,58 @@ void SPI_init(spi_order_t order, spi_mode_t mode, spi_ps_t prescaler)
         BIT_clear(DDRB, SPI_MISO);
 
         // enable SPI, set as Master
-        SPCR = BIT(SPE) | (order) | BIT(MSTR) | (mode) |
-               (prescaler & _SPI_MASK_PRESCALER);
+        SPCR = _SPI_SPCR(order, mode, prescaler);
         SPSR = (prescaler) >> 4; // write `SPI2X` bit if necessary
     } // if SPI is not initialized
 }
 
+//------------------------------------------------------------------------------
+// SPI_device_new
+//------------------------------------------------------------------------------
+spi_device_t SPI_device_new(pin_t cs,
+                            spi_order_t order,
+                            spi_mode_t mode,
+                            spi_ps_t prescaler)
+{
+    spi_device_t device = {
+        .cs = cs,
+        .spcr = _SPI_SPCR(order, mode, prescaler),
+        .spsr = (prescaler) >> 4,
+    };
+
+    PIN_mode(cs, PIN_OUTPUT);
+    PIN_write(cs, PIN_HIGH);
+    SPI_init(order, mode, prescaler);
+
+    return (device);
+}
+
+//------------------------------------------------------------------------------
+// SPI_acquire
+//------------------------------------------------------------------------------
+void SPI_acquire(const spi_device_t *device)
+{
+    // registers are compared instead of tracking the owner, so that drivers
+    // writing SPCR directly cannot leave stale settings behind
+    if (device->spcr != SPCR)
+    {
+        SPCR = device->spcr;
+    }
+    if (device->spsr != BIT_read(SPSR, BIT(SPI2X)))
+    {
+        SPSR = device->spsr;
+    }
+}
+
+//------------------------------------------------------------------------------
+// SPI_begin
+//------------------------------------------------------------------------------
+void SPI_begin(const spi_device_t *device)
+{
+    SPI_acquire(device);
+    PIN_write(device->cs, PIN_LOW);
+}
+
 //------------------------------------------------------------------------------
 // SPI_transmit
 //------------------------------------------------------------------------------
@@ -47,26 +101,87 @@ byte_t SPI_receive(void)
 //------------------------------------------------------------------------------
 // SPI_write
 //------------------------------------------------------------------------------
-void SPI_write(const byte_t *data, length_t len)
+void SPI_write(const byte_t *data, uint16_t len)
 {
-    for (byte_t pos = 0; pos < len; ++pos)
+    if (0 == len)
+    {
+        return;
+    }
+    SPDR = *data; // Load first byte
+    while (0 != --len)
     {
-        SPDR = data[pos]; // Load data
+        byte_t next = *(++data); // prepared during the transfer
         WAIT_UNTIL(SPI_is_complete());
+        SPDR = next;
     }
+    WAIT_UNTIL(SPI_is_complete());
+}
+
+//------------------------------------------------------------------------------
+// SPI_write_P
+//------------------------------------------------------------------------------
+void SPI_write_P(const byte_t *data, uint16_t len)
+{
+    if (0 == len)
+    {
+        return;
+    }
+    SPDR = pgm_read_byte(data); // Load first byte
+    while (0 != --len)
+    {
+        byte_t next = pgm_read_byte(++data); // prepared during the transfer
+        WAIT_UNTIL(SPI_is_complete());
+        SPDR = next;
+    }
+    WAIT_UNTIL(SPI_is_complete());
+}
+
+//------------------------------------------------------------------------------
+// SPI_fill16
+//------------------------------------------------------------------------------
+void SPI_fill16(uint16_t pattern, uint16_t count)
+{
+    byte_t high = (byte_t)(pattern >> 8);
+    byte_t low = (byte_t)(pattern & 0xFF);
+
+    if (0 == count)
+    {
+        return;
+    }
+    SPDR = high;
+    for (;;)
+    {
+        WAIT_UNTIL(SPI_is_complete());
+        SPDR = low;
+        if (0 == --count)
+        {
+            break;
+        } // counter updated during the transfer
+        WAIT_UNTIL(SPI_is_complete());
+        SPDR = high;
+    }
+    WAIT_UNTIL(SPI_is_complete());
 }
 
 //------------------------------------------------------------------------------
 // SPI_read
 //------------------------------------------------------------------------------
-void SPI_read(byte_t *data, length_t len)
+void SPI_read(byte_t *data, uint16_t len)
 {
-    for (byte_t pos = 0; pos < len; ++pos)
+    if (0 == len)
+    {
+        return;
+    }
+    SPDR = 0xFF; // Dummy data
+    while (0 != --len)
     {
-        SPDR = 0xFF; // Dummy data
         WAIT_UNTIL(SPI_is_complete());
-        data[pos] = SPDR;
+        byte_t received = SPDR;
+        SPDR = 0xFF; // next transfer starts before storing
+        *data++ = received;
     }
+    WAIT_UNTIL(SPI_is_complete());
+    *data = SPDR;
 }
 
 //------------------------------------------------------------------------------
@@ -113,3 +228,5 @@ extern inline spi_mode_t SPI_get_mode(void);
 
 extern inline void SPI_set_order(spi_order_t);
 extern inline void SPI_set_mode(spi_mode_t);
+
+extern inline void SPI_end(const spi_device_t *);
@@ -0,0 +1,110 @@
+#include <avr/interrupt.h>
+#include <avr/pgmspace.h>
+
+#include "spi_uart.h"
+
+#define _SPI_UART_XCK BIT(DDD4) /**< PD4 (XCK0, SPI clock) */
+
+/**
+ * @brief Wait until the transmit buffer accepts a new byte
+ */
+#define _SPI_UART_wait() WAIT_UNTIL(BIT_is_set(UCSR0A, BIT(UDRE0)))
+
+//------------------------------------------------------------------------------
+// _SPI_UART_put
+//------------------------------------------------------------------------------
+
+/**
+ * @brief Buffer a byte and clear the transmit complete flag
+ * @details
+ * The flag is cleared after the write, while the byte is still on its way
+ * out: cleared before, the previous byte could set it again in between and
+ * `SPI_UART_flush` would return early. Interrupts are held off so the two
+ * accesses stay closer than one byte on the wire.
+ */
+static inline void _SPI_UART_put(byte_t data)
+{
+    byte_t sreg = SREG;
+
+    cli();
+    UDR0 = data;
+    BIT_set(UCSR0A, BIT(TXC0)); // written 1 to clear
+    SREG = sreg;
+}
+
+//------------------------------------------------------------------------------
+// SPI_UART_init
+//------------------------------------------------------------------------------
+void SPI_UART_init(spi_order_t order, spi_mode_t mode, uint16_t ubrr)
+{
+    UBRR0 = 0;
+    BIT_set(DDRD, _SPI_UART_XCK); // XCK0 as output: master mode
+
+    UCSR0C = BIT(UMSEL01) | BIT(UMSEL00) |
+             ((SPI_LSB == order) ? BIT(UDORD0) : 0) |
+             ((mode & SPI_MODE1) ? BIT(UCPHA0) : 0) |
+             ((mode & SPI_MODE2) ? BIT(UCPOL0) : 0);
+    UCSR0B = BIT(TXEN0);
+
+    UBRR0 = ubrr; // baud rate is set once the transmitter is enabled
+}
+
+//------------------------------------------------------------------------------
+// SPI_UART_transmit
+//------------------------------------------------------------------------------
+void SPI_UART_transmit(byte_t data)
+{
+    _SPI_UART_wait();
+    _SPI_UART_put(data);
+}
+
+//------------------------------------------------------------------------------
+// SPI_UART_write
+//------------------------------------------------------------------------------
+void SPI_UART_write(const byte_t *src, uint16_t len)
+{
+    while (0 != len--)
+    {
+        SPI_UART_transmit(*src++);
+    }
+}
+
+//------------------------------------------------------------------------------
+// SPI_UART_write_P
+//------------------------------------------------------------------------------
+void SPI_UART_write_P(const byte_t *src, uint16_t len)
+{
+    while (0 != len--)
+    {
+        SPI_UART_transmit(pgm_read_byte(src++));
+    }
+}
+
+//------------------------------------------------------------------------------
+// SPI_UART_fill16
+//------------------------------------------------------------------------------
+void SPI_UART_fill16(uint16_t pattern, uint16_t count)
+{
+    byte_t high = (byte_t)(pattern >> 8);
+    byte_t low = (byte_t)(pattern & 0xFF);
+
+    if (0 == count)
+    {
+        return;
+    }
+    while (0 != count--)
+    {
+        _SPI_UART_wait();
+        _SPI_UART_put(high);
+        _SPI_UART_wait();
+        _SPI_UART_put(low);
+    }
+}
+
+//------------------------------------------------------------------------------
+// SPI_UART_flush
+//------------------------------------------------------------------------------
+void SPI_UART_flush(void)
+{
+    WAIT_UNTIL(BIT_is_set(UCSR0A, BIT(TXC0)));
+}
@@ -0,0 +1,107 @@
+#include "sram.h"
+
+extern byte_t __data_start;
+extern byte_t __data_end;
+extern byte_t __bss_start;
+extern byte_t __bss_end;
+extern byte_t __heap_start;
+extern byte_t __stack;
+
+/**
+ * @brief Top of the heap, `NULL` until `malloc` is called
+ * @note Weak: referencing it does not link `malloc` into boards that never
+ * allocate, its address is then `NULL`
+ */
+extern void *__brkval __attribute__((weak));
+
+//------------------------------------------------------------------------------
+// _SRAM_paint
+//------------------------------------------------------------------------------
+
+/**
+ * @brief Fill the SRAM from `_end` to `__stack` with `SRAM_CANARY`
+ * @note Runs before the stack and the zero register are set up: written in
+ * assembly so that it uses neither
+ */
+void _SRAM_paint(void) __attribute__((naked, used, section(".init1")));
+
+void _SRAM_paint(void)
+{
+    __asm__ volatile(
+        "    ldi r30, lo8(_end)\n"
+        "    ldi r31, hi8(_end)\n"
+        "    ldi r24, %0\n"
+        "    ldi r25, hi8(__stack)\n"
+        "    rjmp 2f\n"
+        "1:  st Z+, r24\n"
+        "2:  cpi r30, lo8(__stack)\n"
+        "    cpc r31, r25\n"
+        "    brlo 1b\n"
+        "    breq 1b\n"
+        :
+        : "i"(SRAM_CANARY));
+}
+
+//------------------------------------------------------------------------------
+// _SRAM_heap_end
+//------------------------------------------------------------------------------
+
+/**
+ * @brief First byte above the heap
+ */
+static inline byte_t *_SRAM_heap_end(void)
+{
+    if ((NULL == &__brkval) || (NULL == __brkval))
+    {
+        return (&__heap_start);
+    } // no heap
+    return ((byte_t *)__brkval);
+}
+
+//------------------------------------------------------------------------------
+// SRAM_stack_free
+//------------------------------------------------------------------------------
+
+uint16_t SRAM_stack_free(void)
+{
+    return ((uint16_t)SP - (uint16_t)(uintptr_t)_SRAM_heap_end());
+}
+
+//------------------------------------------------------------------------------
+// SRAM_stack_free_min
+//------------------------------------------------------------------------------
+
+uint16_t SRAM_stack_free_min(void)
+{
+    const byte_t *p = _SRAM_heap_end();
+    uint16_t count = 0;
+
+    while ((p <= &__stack) && (SRAM_CANARY == *p))
+    {
+        ++p;
+        ++count;
+    }
+    return (count);
+}
+
+//------------------------------------------------------------------------------
+// SRAM_get_usage
+//------------------------------------------------------------------------------
+
+void SRAM_get_usage(sram_usage_t *usage)
+{
+    usage->data = (uint16_t)(&__data_end - &__data_start);
+    usage->bss = (uint16_t)(&__bss_end - &__bss_start);
+    usage->heap = (uint16_t)(_SRAM_heap_end() - &__heap_start);
+    usage->stack_free = SRAM_stack_free();
+    usage->stack_free_min = SRAM_stack_free_min();
+}
+
+//------------------------------------------------------------------------------
+// SRAM_check
+//------------------------------------------------------------------------------
+
+bool_t SRAM_check(uint16_t margin)
+{
+    return (SRAM_stack_free_min() > margin);
+}
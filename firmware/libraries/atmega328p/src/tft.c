@@ -55,3 +55,4 @@ extern inline void TFT_fill_area(uint16_t x, uint16_t y,
                                  color16_t color);
 extern inline void TFT_print_char(uint16_t x, uint16_t y, char ch);
 extern inline void TFT_print_str(uint16_t x, uint16_t y, const char *str);
+extern inline void TFT_print_str_P(uint16_t x, uint16_t y, const char *str);
@@ -1,8 +1,35 @@
+#include <avr/interrupt.h>
+
 #include "timer.h"
+#include "config.h"
 
 #define TIMER1_WGM_LOW_MASK 0x03
 #define TIMER1_WGM_HIGH_MASK 0x18
 
+#if (0 != (F_CPU % 1000000UL))
+#error "the system tick requires F_CPU to be a multiple of 1 MHz"
+#endif
+
+#define TIMER_CYCLES_PER_US (F_CPU / 1000000UL)
+
+/**
+ * @brief State of the system tick
+ */
+typedef struct
+{
+    volatile uint32_t ms;   /**< Milliseconds */
+    volatile uint32_t us;   /**< Microseconds at the last interrupt */
+    volatile uint16_t frac; /**< Microseconds not yet counted in `ms` */
+    uint16_t step;          /**< Microseconds per interrupt */
+    uint16_t period;        /**< Timer counts per interrupt */
+    byte_t source;          /**< Timer number */
+    byte_t shift;           /**< Prescaler, as a power of 2 */
+    byte_t hooks;           /**< Number of attached hooks */
+} timer_tick_t;
+
+static timer_tick_t g_timer_tick;
+static timer_hook_t g_timer_hook[TIMER_TICK_HOOK_MAX];
+
 void TIMER0_init(timer0_mode_t mode, timer0_ps_t prescaler)
 {
     if ((0 == TCCR0A) && (0 == TCCR0B))
@@ -29,3 +56,99 @@ void TIMER2_init(timer2_mode_t mode, timer2_ps_t prescaler)
         TCCR2B = (byte_t)(prescaler);
     }
 }
+
+//------------------------------------------------------------------------------
+// System Tick
+//------------------------------------------------------------------------------
+
+void _TIMER_tick_setup(byte_t source, byte_t shift, uint16_t period)
+{
+    byte_t sreg = SREG;
+
+    cli();
+    g_timer_tick.ms = 0;
+    g_timer_tick.us = 0;
+    g_timer_tick.frac = 0;
+    g_timer_tick.step = (uint16_t)(((uint32_t)period << shift) /
+                                   TIMER_CYCLES_PER_US);
+    g_timer_tick.period = period;
+    g_timer_tick.source = source;
+    g_timer_tick.shift = shift;
+    SREG = sreg;
+}
+
+void _TIMER_tick_update(void)
+{
+    uint16_t frac = g_timer_tick.frac + g_timer_tick.step;
+
+    g_timer_tick.us += g_timer_tick.step;
+    while (1000 <= frac)
+    {
+        frac -= 1000;
+        ++g_timer_tick.ms;
+        for (byte_t i = 0; i < g_timer_tick.hooks; ++i)
+        {
+            g_timer_hook[i]();
+        }
+    } // one pass per elapsed millisecond
+    g_timer_tick.frac = frac;
+}
+
+uint32_t TIMER_millis(void)
+{
+    uint32_t ms;
+    byte_t sreg = SREG;
+
+    cli();
+    ms = g_timer_tick.ms;
+    SREG = sreg;
+    return (ms);
+}
+
+uint32_t TIMER_micros(void)
+{
+    uint32_t us;
+    uint16_t count;
+    bool_t pending;
+    byte_t sreg = SREG;
+
+    cli();
+    us = g_timer_tick.us;
+    if (0 == g_timer_tick.source)
+    {
+        count = TCNT0;
+        pending = BIT_is_set(TIFR0, BIT(TOV0));
+    }
+    else
+    {
+        count = TCNT2;
+        pending = BIT_is_set(TIFR2, BIT(OCF2A));
+    }
+    SREG = sreg;
+
+    if (pending && (count < g_timer_tick.period - 1))
+    {
+        us += g_timer_tick.step;
+    } // the counter wrapped, its interrupt has not run yet
+    return (us + ((uint32_t)count << g_timer_tick.shift) / TIMER_CYCLES_PER_US);
+}
+
+bool_t TIMER_tick_attach(timer_hook_t hook)
+{
+    byte_t sreg = SREG;
+
+    if (TIMER_TICK_HOOK_MAX <= g_timer_tick.hooks)
+    {
+        return (FALSE);
+    }
+    cli();
+    g_timer_hook[g_timer_tick.hooks++] = hook;
+    SREG = sreg;
+    return (TRUE);
+}
+
+//------------------------------------------------------------------------------
+// Inline Functions
+//------------------------------------------------------------------------------
+
+extern inline uint32_t TIMER_elapsed(uint32_t);
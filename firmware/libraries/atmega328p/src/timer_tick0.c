@@ -0,0 +1,37 @@
+#include <avr/interrupt.h>
+
+#include "timer.h"
+
+#define _TIMER_TICK0_PERIOD 256U /**< Counts per overflow, up to `0xFF` */
+
+/**
+ * @brief Prescaler of Timer0 as a power of 2, indexed by its clock select
+ */
+static const byte_t g_timer_tick0_shift[] = {0, 0, 3, 6, 8, 10};
+
+//------------------------------------------------------------------------------
+// TIMER_tick_init_timer0
+//------------------------------------------------------------------------------
+
+void TIMER_tick_init_timer0(void)
+{
+    byte_t cs = TCCR0B & (BIT(CS02) | BIT(CS01) | BIT(CS00));
+
+    if ((0 == cs) || (sizeof(g_timer_tick0_shift) <= cs))
+    {
+        TIMER0_init(TIMER0_FPWM, TIMER0_PS64);
+        cs = TIMER0_PS64;
+    } // stopped, or clocked from the T0 pin
+    _TIMER_tick_setup(0, g_timer_tick0_shift[cs], _TIMER_TICK0_PERIOD);
+    BIT_set(TIFR0, BIT(TOV0)); // discard a stale overflow
+    BIT_set(TIMSK0, BIT(TOIE0));
+}
+
+//------------------------------------------------------------------------------
+// ISR
+//------------------------------------------------------------------------------
+
+ISR(TIMER0_OVF_vect)
+{
+    _TIMER_tick_update();
+}
@@ -0,0 +1,36 @@
+#include <avr/interrupt.h>
+
+#include "timer.h"
+
+#define _TIMER_TICK2_SHIFT 6 /**< Prescaler of 64 */
+
+/**
+ * @brief Timer2 counts per millisecond
+ */
+#define _TIMER_TICK2_PERIOD ((F_CPU >> _TIMER_TICK2_SHIFT) / 1000UL)
+
+#if (256 < _TIMER_TICK2_PERIOD)
+#error "F_CPU too high for the Timer2 tick"
+#endif
+
+//------------------------------------------------------------------------------
+// TIMER_tick_init_timer2
+//------------------------------------------------------------------------------
+
+void TIMER_tick_init_timer2(void)
+{
+    _TIMER_tick_setup(2, _TIMER_TICK2_SHIFT, _TIMER_TICK2_PERIOD);
+    OCR2A = (byte_t)(_TIMER_TICK2_PERIOD - 1);
+    TIMER2_init(TIMER2_CTC, TIMER2_PS64);
+    BIT_set(TIFR2, BIT(OCF2A)); // discard a stale compare match
+    BIT_set(TIMSK2, BIT(OCIE2A));
+}
+
+//------------------------------------------------------------------------------
+// ISR
+//------------------------------------------------------------------------------
+
+ISR(TIMER2_COMPA_vect)
+{
+    _TIMER_tick_update();
+}
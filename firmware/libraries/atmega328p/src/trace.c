@@ -0,0 +1,196 @@
+#include <avr/interrupt.h>
+#include <util/crc16.h>
+
+#include "trace.h"
+
+static byte_t g_trace_seq;
+static uint16_t g_trace_dropped;
+
+//------------------------------------------------------------------------------
+// _TRACE_cobs
+//------------------------------------------------------------------------------
+
+/**
+ * @brief COBS-encode a record and append the frame delimiter
+ * @param src Record to encode, shorter than 254 bytes
+ * @param len Size of the record
+ * @param dst Frame buffer, at least `len + 2` bytes
+ * @return Size of the frame
+ */
+static length_t _TRACE_cobs(const byte_t *src, length_t len, byte_t *dst)
+{
+    length_t code_pos = 0;
+    length_t pos = 1;
+    byte_t code = 1;
+
+    while (0 != len--)
+    {
+        if (0 == *src)
+        {
+            dst[code_pos] = code;
+            code_pos = pos++;
+            code = 1;
+        }
+        else
+        {
+            dst[pos++] = *src;
+            ++code;
+        }
+        ++src;
+    }
+    dst[code_pos] = code;
+    dst[pos++] = 0x00; // frame delimiter
+    return (pos);
+}
+
+//------------------------------------------------------------------------------
+// TRACE_init
+//------------------------------------------------------------------------------
+
+void TRACE_init(void)
+{
+    UART_init(UART_8N1, UART_TX);
+    UART_set_overflow(UART_DROP);
+    g_trace_seq = 0;
+    g_trace_dropped = 0;
+}
+
+//------------------------------------------------------------------------------
+// TRACE_record
+//------------------------------------------------------------------------------
+
+void TRACE_record(byte_t id, const byte_t *payload, length_t len)
+{
+    byte_t record[TRACE_RECORD_MAX];
+    byte_t frame[TRACE_FRAME_MAX];
+    uint16_t crc = TRACE_CRC_INIT;
+    length_t size = 0;
+    byte_t sreg;
+
+    if (TRACE_PAYLOAD_MAX < len)
+    {
+        len = TRACE_PAYLOAD_MAX;
+    }
+    record[size++] = id;
+    sreg = SREG;
+    cli();
+    record[size++] = g_trace_seq++;
+    SREG = sreg;
+    while (0 != len--)
+    {
+        record[size++] = *payload++;
+    }
+    for (length_t i = 0; i < size; ++i)
+    {
+        crc = _crc_ccitt_update(crc, record[i]);
+    }
+    record[size++] = (byte_t)(crc & 0xFF);
+    record[size++] = (byte_t)(crc >> 8);
+    size = _TRACE_cobs(record, size, frame);
+
+    sreg = SREG;
+    cli();
+    if (UART_tx_free() < size)
+    {
+        ++g_trace_dropped; // never queue a partial frame
+    }
+    else
+    {
+        UART_write(frame, size);
+    }
+    SREG = sreg;
+}
+
+//------------------------------------------------------------------------------
+// TRACE_packet
+//------------------------------------------------------------------------------
+
+void TRACE_packet(const byte_t *packet)
+{
+    TRACE_record(TRACE_ID_PACKET, packet, TRACE_PACKET_BYTES);
+}
+
+//------------------------------------------------------------------------------
+// TRACE_module
+//------------------------------------------------------------------------------
+
+void TRACE_module(const byte_t *packet)
+{
+    TRACE_record(TRACE_ID_MODULE, packet, TRACE_MODULE_BYTES);
+}
+
+//------------------------------------------------------------------------------
+// TRACE_motor
+//------------------------------------------------------------------------------
+
+void TRACE_motor(int16_t left, int16_t right)
+{
+    byte_t payload[4];
+
+    payload[0] = (byte_t)((uint16_t)left & 0xFF);
+    payload[1] = (byte_t)((uint16_t)left >> 8);
+    payload[2] = (byte_t)((uint16_t)right & 0xFF);
+    payload[3] = (byte_t)((uint16_t)right >> 8);
+    TRACE_record(TRACE_ID_MOTOR, payload, sizeof(payload));
+}
+
+//------------------------------------------------------------------------------
+// TRACE_i2c_error
+//------------------------------------------------------------------------------
+
+void TRACE_i2c_error(byte_t address, int8_t error)
+{
+    byte_t payload[2];
+
+    payload[0] = address;
+    payload[1] = (byte_t)error;
+    TRACE_record(TRACE_ID_I2C, payload, sizeof(payload));
+}
+
+//------------------------------------------------------------------------------
+// TRACE_timing
+//------------------------------------------------------------------------------
+
+void TRACE_timing(byte_t probe, uint32_t value)
+{
+    byte_t payload[5];
+
+    payload[0] = probe;
+    payload[1] = (byte_t)(value & 0xFF);
+    payload[2] = (byte_t)((value >> 8) & 0xFF);
+    payload[3] = (byte_t)((value >> 16) & 0xFF);
+    payload[4] = (byte_t)(value >> 24);
+    TRACE_record(TRACE_ID_TIMING, payload, sizeof(payload));
+}
+
+//------------------------------------------------------------------------------
+// TRACE_sram
+//------------------------------------------------------------------------------
+
+void TRACE_sram(uint16_t free_min, uint16_t free, uint16_t heap)
+{
+    byte_t payload[6];
+
+    payload[0] = (byte_t)(free_min & 0xFF);
+    payload[1] = (byte_t)(free_min >> 8);
+    payload[2] = (byte_t)(free & 0xFF);
+    payload[3] = (byte_t)(free >> 8);
+    payload[4] = (byte_t)(heap & 0xFF);
+    payload[5] = (byte_t)(heap >> 8);
+    TRACE_record(TRACE_ID_SRAM, payload, sizeof(payload));
+}
+
+//------------------------------------------------------------------------------
+// TRACE_dropped
+//------------------------------------------------------------------------------
+
+uint16_t TRACE_dropped(void)
+{
+    uint16_t dropped;
+    byte_t sreg = SREG;
+
+    cli();
+    dropped = g_trace_dropped;
+    SREG = sreg;
+    return (dropped);
+}
@@ -1,6 +1,98 @@
+#include <avr/interrupt.h>
+
 #include "uart.h"
 #include "config.h"
 
+#if (UART_TX_BUFFER_SIZE & (UART_TX_BUFFER_SIZE - 1)) || \
+    (256 < UART_TX_BUFFER_SIZE) || (2 > UART_TX_BUFFER_SIZE)
+#error "UART_TX_BUFFER_SIZE must be a power of 2 between 2 and 256"
+#endif
+#if (UART_RX_BUFFER_SIZE & (UART_RX_BUFFER_SIZE - 1)) || \
+    (256 < UART_RX_BUFFER_SIZE) || (2 > UART_RX_BUFFER_SIZE)
+#error "UART_RX_BUFFER_SIZE must be a power of 2 between 2 and 256"
+#endif
+
+#define _UART_TX_MASK ((byte_t)(UART_TX_BUFFER_SIZE - 1))
+#define _UART_RX_MASK ((byte_t)(UART_RX_BUFFER_SIZE - 1))
+
+/**
+ * @brief Data Register Empty interrupt enable bit
+ */
+#define _UART_UDRIE BIT(UDRIE0)
+
+/**
+ * @brief Check whether the global interrupts are enabled
+ */
+#define _UART_INTERRUPTS_ENABLED() BIT_is_set(SREG, BIT(SREG_I))
+
+/**
+ * @brief Ring buffer, one slot is always left empty to tell full from empty
+ */
+typedef struct
+{
+    volatile byte_t head; /**< Next slot to write */
+    volatile byte_t tail; /**< Next slot to read */
+} uart_ring_t;
+
+static byte_t g_uart_tx_buffer[UART_TX_BUFFER_SIZE];
+static byte_t g_uart_rx_buffer[UART_RX_BUFFER_SIZE];
+static uart_ring_t g_uart_tx;
+static uart_ring_t g_uart_rx;
+
+static uart_overflow_t g_uart_overflow = UART_DROP;
+static volatile uint16_t g_uart_dropped;
+
+//------------------------------------------------------------------------------
+// _UART_send
+//------------------------------------------------------------------------------
+
+/**
+ * @brief Write a byte to the data register and clear the transmit complete
+ * flag, keeping the configuration bits of UCSR0A
+ */
+static inline void _UART_send(byte_t data)
+{
+    UCSR0A = (UCSR0A & (BIT(U2X0) | BIT(MPCM0))) | BIT(TXC0);
+    UDR0 = data;
+}
+
+//------------------------------------------------------------------------------
+// _UART_drop
+//------------------------------------------------------------------------------
+
+/**
+ * @brief Count bytes lost on the transmit side, the receive interrupt
+ * updates the same counter
+ */
+static void _UART_drop(length_t count)
+{
+    byte_t sreg = SREG;
+
+    cli();
+    g_uart_dropped += count;
+    SREG = sreg;
+}
+
+//------------------------------------------------------------------------------
+// _UART_poll
+//------------------------------------------------------------------------------
+
+/**
+ * @brief Move one byte from the transmit buffer to the data register by
+ * polling, used when the interrupts are disabled
+ */
+static void _UART_poll(void)
+{
+    byte_t tail = g_uart_tx.tail;
+
+    if (tail != g_uart_tx.head)
+    {
+        WAIT_UNTIL(UART_is_ready());
+        _UART_send(g_uart_tx_buffer[tail]);
+        g_uart_tx.tail = (tail + 1) & _UART_TX_MASK;
+    }
+}
+
 //------------------------------------------------------------------------------
 // UART_init
 //------------------------------------------------------------------------------
@@ -13,8 +105,16 @@ void UART_init(uart_fmt_t format, uart_mode_t mode)
     UBRR0H = UART_REG_UBRR0H;
     UBRR0L = UART_REG_UBRR0L;
 
+    g_uart_tx.head = g_uart_tx.tail = 0;
+    g_uart_rx.head = g_uart_rx.tail = 0;
+    g_uart_dropped = 0;
+
     UCSR0C = (byte_t)(format); // set format
     UCSR0B = (byte_t)(mode);   // enable RX/TX
+    if (mode & UART_RX)
+    {
+        UART_enable_interrupt(UART_RX); // buffer incoming data
+    }
 }
 
 //------------------------------------------------------------------------------
@@ -23,8 +123,50 @@ void UART_init(uart_fmt_t format, uart_mode_t mode)
 
 void UART_transmit(byte_t data)
 {
-    WAIT_UNTIL(UART_is_ready());
-    UDR0 = data;
+    byte_t head = g_uart_tx.head;
+    byte_t next = (head + 1) & _UART_TX_MASK;
+
+    if ((head == g_uart_tx.tail) && UART_is_ready())
+    {
+        _UART_send(data); // idle transmitter: skip the buffer
+        return;
+    }
+    while (next == g_uart_tx.tail)
+    {
+        if (!_UART_INTERRUPTS_ENABLED())
+        {
+            _UART_poll(); // the ISR cannot run, make room by hand
+        }
+        else if (UART_DROP == g_uart_overflow)
+        {
+            _UART_drop(1);
+            return;
+        }
+    } // while the transmit buffer is full
+    g_uart_tx_buffer[head] = data;
+    g_uart_tx.head = next;
+    BIT_set(UCSR0B, _UART_UDRIE);
+}
+
+//------------------------------------------------------------------------------
+// UART_write
+//------------------------------------------------------------------------------
+
+length_t UART_write(const byte_t *src, length_t len)
+{
+    length_t sent = 0;
+
+    while (sent < len)
+    {
+        if ((UART_DROP == g_uart_overflow) && _UART_INTERRUPTS_ENABLED() &&
+            (0 == UART_tx_free()))
+        {
+            _UART_drop(len - sent);
+            break;
+        }
+        UART_transmit(src[sent++]);
+    }
+    return (sent);
 }
 
 //------------------------------------------------------------------------------
@@ -33,8 +175,94 @@ void UART_transmit(byte_t data)
 
 byte_t UART_receive(void)
 {
-    WAIT_UNTIL(UART_is_rx_complete());
-    return UDR0;
+    byte_t data = 0;
+
+    if (!_UART_INTERRUPTS_ENABLED() && (g_uart_rx.head == g_uart_rx.tail))
+    {
+        WAIT_UNTIL(UART_is_rx_complete());
+        return (UDR0);
+    } // the ISR cannot fill the buffer
+    WAIT_UNTIL(g_uart_rx.head != g_uart_rx.tail);
+    UART_read(&data);
+    return (data);
+}
+
+//------------------------------------------------------------------------------
+// UART_read
+//------------------------------------------------------------------------------
+
+bool_t UART_read(byte_t *data)
+{
+    byte_t tail = g_uart_rx.tail;
+
+    if (tail == g_uart_rx.head)
+    {
+        return (FALSE);
+    }
+    *data = g_uart_rx_buffer[tail];
+    g_uart_rx.tail = (tail + 1) & _UART_RX_MASK;
+    return (TRUE);
+}
+
+//------------------------------------------------------------------------------
+// UART_available
+//------------------------------------------------------------------------------
+
+length_t UART_available(void)
+{
+    return ((g_uart_rx.head - g_uart_rx.tail) & _UART_RX_MASK);
+}
+
+//------------------------------------------------------------------------------
+// UART_tx_free
+//------------------------------------------------------------------------------
+
+length_t UART_tx_free(void)
+{
+    return ((g_uart_tx.tail - g_uart_tx.head - 1) & _UART_TX_MASK);
+}
+
+//------------------------------------------------------------------------------
+// UART_set_overflow
+//------------------------------------------------------------------------------
+
+void UART_set_overflow(uart_overflow_t policy)
+{
+    g_uart_overflow = policy;
+}
+
+//------------------------------------------------------------------------------
+// UART_dropped
+//------------------------------------------------------------------------------
+
+uint16_t UART_dropped(void)
+{
+    uint16_t dropped;
+    byte_t sreg = SREG;
+
+    cli();
+    dropped = g_uart_dropped;
+    SREG = sreg;
+    return (dropped);
+}
+
+//------------------------------------------------------------------------------
+// UART_drain
+//------------------------------------------------------------------------------
+
+void UART_drain(void)
+{
+    while (g_uart_tx.head != g_uart_tx.tail)
+    {
+        if (!_UART_INTERRUPTS_ENABLED())
+        {
+            _UART_poll();
+        }
+    } // while the transmit buffer is not empty
+    if (BIT_is_set(UCSR0B, BIT(TXEN0)))
+    {
+        WAIT_UNTIL(UART_is_ready() && UART_is_tx_complete());
+    }
 }
 
 //------------------------------------------------------------------------------
@@ -50,6 +278,7 @@ void UART_flush(void)
         dummy = UDR0; // read UDR0 register
         (void)dummy;
     } // while RXC0 flag is set
+    g_uart_rx.tail = g_uart_rx.head;
 }
 
 //------------------------------------------------------------------------------
@@ -62,6 +291,40 @@ void UART_reset(void)
     BIT_write(UCSR0A, 0x00, (BIT(U2X0) | BIT(MPCM0)));
     UCSR0B = 0x00;
     UCSR0C = (BIT(UCSZ01) | BIT(UCSZ00));
+    g_uart_tx.head = g_uart_tx.tail = 0;
+    g_uart_rx.head = g_uart_rx.tail = 0;
+}
+
+//------------------------------------------------------------------------------
+// ISR
+//------------------------------------------------------------------------------
+
+ISR(USART_UDRE_vect)
+{
+    byte_t tail = g_uart_tx.tail;
+
+    if (tail == g_uart_tx.head)
+    {
+        BIT_clear(UCSR0B, _UART_UDRIE); // nothing left to send
+        return;
+    }
+    _UART_send(g_uart_tx_buffer[tail]);
+    g_uart_tx.tail = (tail + 1) & _UART_TX_MASK;
+}
+
+ISR(USART_RX_vect)
+{
+    byte_t data = UDR0;
+    byte_t head = g_uart_rx.head;
+    byte_t next = (head + 1) & _UART_RX_MASK;
+
+    if (next == g_uart_rx.tail)
+    {
+        ++g_uart_dropped; // buffer full: the newest byte is lost
+        return;
+    }
+    g_uart_rx_buffer[head] = data;
+    g_uart_rx.head = next;
 }
 
 //------------------------------------------------------------------------------
@@ -21,14 +21,34 @@
 #include <util/delay.h>
 #include <string.h>
 
+/* Profiling markers of the VEMAR library, built with VEMAR_PROFILE_ENABLED
+   and its include directory; compiled out otherwise. */
+#ifdef VEMAR_PROFILE_ENABLED
+#include "profile.h"
+#else
+#define PROFILE_BEGIN(id)
+#define PROFILE_END(id)
+#endif
+
 /* =========================================================================
  * SPI / CS
  * ========================================================================= */
 
 static volatile uint8_t *_cs_port;
 static uint8_t           _cs_mask;
+static uint8_t           _spcr;     /* SPCR of the card, reloaded on select  */
+static uint8_t           _spsr;     /* SPSR (SPI2X) of the card              */
+
+/* The bus may be shared with other devices (TFT, radio) running their own
+   clock and mode: the card settings are loaded again whenever it is
+   selected, only if another device changed them. */
+static void cs_low(void)
+{
+    if (SPCR != _spcr) SPCR = _spcr;
+    if ((SPSR & (1 << SPI2X)) != _spsr) SPSR = _spsr;
+    *_cs_port &= ~_cs_mask;
+}
 
-#define cs_low()   (*_cs_port &= ~_cs_mask)
 #define cs_high()  (*_cs_port |=  _cs_mask)
 
 static uint8_t spi_byte(uint8_t b)
@@ -38,18 +58,48 @@ static uint8_t spi_byte(uint8_t b)
     return SPDR;
 }
 
+/* Block transfers: the next byte is prepared while the current one is
+   shifted out, instead of waiting for SPIF before touching the buffer. */
+static void spi_read_block(uint8_t *dst, uint16_t len)
+{
+    SPDR = 0xFF;
+    while (--len) {
+        while (!(SPSR & (1 << SPIF)));
+        uint8_t b = SPDR;
+        SPDR = 0xFF;
+        *dst++ = b;
+    }
+    while (!(SPSR & (1 << SPIF)));
+    *dst = SPDR;
+}
+
+static void spi_write_block(const uint8_t *src, uint16_t len)
+{
+    SPDR = *src;
+    while (--len) {
+        uint8_t b = *++src;
+        while (!(SPSR & (1 << SPIF)));
+        SPDR = b;
+    }
+    while (!(SPSR & (1 << SPIF)));
+}
+
 /* ≤400 kHz for card power-on / init sequence */
 static void spi_slow(void)
 {
-    SPCR = (1 << SPE) | (1 << MSTR) | (1 << SPR1) | (1 << SPR0); /* F_CPU/128 */
-    SPSR = 0;
+    _spcr = (1 << SPE) | (1 << MSTR) | (1 << SPR1) | (1 << SPR0); /* F_CPU/128 */
+    _spsr = 0;
+    SPCR = _spcr;
+    SPSR = _spsr;
 }
 
 /* F_CPU/4 for normal operation (~4 MHz at 16 MHz) */
 static void spi_fast(void)
 {
-    SPCR = (1 << SPE) | (1 << MSTR);
-    SPSR = 0;
+    _spcr = (1 << SPE) | (1 << MSTR);
+    _spsr = 0;
+    SPCR = _spcr;
+    SPSR = _spsr;
 }
 
 /* =========================================================================
@@ -150,7 +200,7 @@ static uint8_t sd_read(uint32_t lba)
     uint8_t t; uint16_t n = 0xFFFF;
     do { t = spi_byte(0xFF); } while (t != 0xFE && --n);
     if (!n) { cs_high(); spi_byte(0xFF); return SD_ERR_IO; }
-    for (uint16_t i = 0; i < 512; i++) _buf[i] = spi_byte(0xFF);
+    spi_read_block(_buf, sizeof(_buf));
     spi_byte(0xFF); spi_byte(0xFF);  /* discard CRC */
     cs_high();
     spi_byte(0xFF);
@@ -167,7 +217,7 @@ static uint8_t sd_write(uint32_t lba)
     }
     spi_byte(0xFF);
     spi_byte(0xFE);                              /* data token */
-    for (uint16_t i = 0; i < 512; i++) spi_byte(_buf[i]);
+    spi_write_block(_buf, sizeof(_buf));
     spi_byte(0xFF); spi_byte(0xFF);              /* dummy CRC  */
     uint8_t r = spi_byte(0xFF);                  /* data response token */
     if ((r & 0x1F) != 0x05) {
@@ -541,7 +591,7 @@ uint8_t SD_json_create(const char *name)
  * Updates _file_size and the directory entry file-size field.
  * ========================================================================= */
 
-static uint8_t file_write(const uint8_t *data, uint8_t len)
+static uint8_t file_write_data(const uint8_t *data, uint8_t len)
 {
     uint32_t cluster_bytes = (uint32_t)_spc * 512;
     uint8_t  written = 0;
@@ -584,6 +634,14 @@ static uint8_t file_write(const uint8_t *data, uint8_t len)
     return sd_write(_file_dir_lba);
 }
 
+static uint8_t file_write(const uint8_t *data, uint8_t len)
+{
+    PROFILE_BEGIN(PROFILE_SD_WRITE);
+    uint8_t err = file_write_data(data, len);
+    PROFILE_END(PROFILE_SD_WRITE);
+    return err;
+}
+
 /* =========================================================================
  * SD_json_append
  * ========================================================================= */
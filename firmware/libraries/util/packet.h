@@ -9,6 +9,7 @@
 #define PACKET_ID_GAS 0x03   /**< Packet ID of the gas sensor module */
 #define PACKET_ID_LIDAR 0x04 /**< Packet ID of the LiDAR */
 #define PACKET_ID_GMC 0x05   /**< Packet ID of the Geiger counter */
+#define PACKET_ID_LINK 0x06  /**< Packet ID of the radio link control */
 
 #define LIDAR_DATA_PER_LINE 5
 #define LIDAR_DATA_PER_PACKET 5
@@ -92,6 +93,13 @@ typedef union
         uint16_t cpm;
         uint8_t padding[PACKET_SIZE - 8];
     } geiger;
+
+    struct
+    {
+        uint8_t id;                       /**< ID */
+        uint8_t link;                     /**< Link profile to switch to */
+        uint8_t padding[PACKET_SIZE - 2]; /**< Padding */
+    } link;                               /**< Radio link control */
 } packet_t;
 
 //------------------------------------------------------------------------------
@@ -0,0 +1,68 @@
+#ifndef VEMAR_TRACE_RECORD_H
+#define VEMAR_TRACE_RECORD_H
+
+#include <stdint.h>
+
+#define TRACE_ID_PACKET 0x01  /**< Radio packet received */
+#define TRACE_ID_MOTOR 0x02   /**< Motor command */
+#define TRACE_ID_I2C 0x03     /**< I2C error */
+#define TRACE_ID_TIMING 0x04  /**< Timing sample */
+#define TRACE_ID_PROFILE 0x05 /**< Profile table entry */
+#define TRACE_ID_SRAM 0x06    /**< Low free SRAM warning */
+#define TRACE_ID_MODULE 0x07  /**< Whole module packet, for the ground station */
+
+#define TRACE_PACKET_BYTES 16 /**< Leading packet bytes kept in a record */
+#define TRACE_PROFILE_SIZE 15 /**< Payload of a profile record */
+#define TRACE_MODULE_BYTES 32 /**< Whole radio packet (`PACKET_SIZE`) */
+
+#define TRACE_HEADER_SIZE 2 /**< Record ID and sequence number */
+#define TRACE_CRC_SIZE 2    /**< CRC-16/CCITT, little-endian */
+
+/**
+ * @brief Largest record payload
+ */
+#define TRACE_PAYLOAD_MAX TRACE_MODULE_BYTES
+
+/**
+ * @brief Largest record, before framing
+ */
+#define TRACE_RECORD_MAX (TRACE_HEADER_SIZE + TRACE_PAYLOAD_MAX + TRACE_CRC_SIZE)
+
+/**
+ * @brief Largest frame on the wire: COBS code byte, record and delimiter
+ */
+#define TRACE_FRAME_MAX (TRACE_RECORD_MAX + 2)
+
+/**
+ * @brief Initial value of the CRC, computed over header and payload
+ */
+#define TRACE_CRC_INIT 0xFFFF
+
+/**
+ * @brief Trace Record Frame
+ * @details
+ * Each record is COBS-encoded and terminated by a `0x00` delimiter. Multi-byte
+ * fields are little-endian.
+ *
+ * | BYTE    | 0  |  1  | 2 ...                                     | n - 2 |
+ * | RECORD  | id | seq | payload                                   | crc   |
+ * | PACKET  |    |     | packet[0:16]                              |       |
+ * | MOTOR   |    |     | left:i16 right:i16                        |       |
+ * | I2C     |    |     | addr:u8 error:i8                          |       |
+ * | TIMING  |    |     | probe:u8 value:u32                        |       |
+ * | PROFILE |    |     | id:u8 count:u16 min:u32 max:u32 total:u32 |       |
+ * | SRAM    |    |     | free_min:u16 free:u16 heap:u16            |       |
+ * | MODULE  |    |     | packet[0:32]                              |       |
+ *
+ * The sequence number increments on every record, including the ones dropped
+ * when the transmit buffer is full, so gaps are visible on the host.
+ */
+
+#endif // VEMAR_TRACE_RECORD_H
+
+/**
+ * @file trace.h
+ * @brief Wire format of the binary trace stream, shared with the host decoder
+ * @author Christian Hugon <chriss.hugon@gmail.com>
+ * @version 1.2.0
+ */
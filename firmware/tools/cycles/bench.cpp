@@ -0,0 +1,327 @@
+/**
+ * @file bench.cpp
+ * @brief Cycle benchmark of the board images on simavr
+ * @details
+ * Runs an image built with `PROFILE=sim` on the simulated ATmega328P, with
+ * the devices and inputs of a script, and reports the CPU cycles of every
+ * profiled section. Against a baseline, a section whose mean grew by more
+ * than the threshold fails the run.
+ *
+ * Usage: cycles_bench [-b baseline] [-t percent] script...
+ */
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <unistd.h>
+
+#include "devices.h"
+#include "sim.h"
+
+namespace
+{
+
+using namespace cycles;
+
+constexpr double THRESHOLD = 5.0; // percent
+
+// order of profile_id_t, see profile.h
+const char *const SECTION_NAMES[SECTION_COUNT] = {
+    "controller_read", "ili9341_fill", "radio_write", "i2c_read",
+    "sd_write",        "loop",         "user0",       "user1",
+};
+
+using Baseline = std::map<std::pair<std::string, std::string>, double>;
+
+/**
+ * @brief Load the means of a previous report
+ * @return `false` if the file cannot be read
+ */
+bool load_baseline(const std::string &path, Baseline &baseline)
+{
+    std::ifstream in(path);
+    std::string line;
+
+    if (!in)
+    {
+        std::fprintf(stderr, "%s: cannot open\n", path.c_str());
+        return false;
+    }
+    std::getline(in, line); // header
+    while (std::getline(in, line))
+    {
+        std::istringstream row(line);
+        std::string script;
+        std::string section;
+        unsigned long count;
+        uint64_t min;
+        uint64_t max;
+        double mean;
+
+        if (row >> script >> section >> count >> min >> max >> mean)
+        {
+            baseline[{script, section}] = mean;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Read hexadecimal bytes until the end of the line
+ */
+std::vector<uint8_t> hex_bytes(std::istringstream &args)
+{
+    std::vector<uint8_t> bytes;
+    unsigned byte;
+
+    while (args >> std::hex >> byte)
+    {
+        bytes.push_back(static_cast<uint8_t>(byte));
+    }
+    return bytes;
+}
+
+/**
+ * @brief Read the pins until the end of the line
+ * @return `false` if one cannot be parsed
+ */
+bool pins(std::istringstream &args, std::vector<Pin> &out)
+{
+    std::string name;
+
+    while (args >> name)
+    {
+        Pin pin;
+
+        if (!Pin::parse(name, pin))
+        {
+            return false;
+        }
+        out.push_back(pin);
+    }
+    return !out.empty();
+}
+
+/**
+ * @brief Run a script, see README.md for the commands
+ * @return `false` on error (reported on stderr)
+ */
+bool script(const std::string &path, Sim &sim)
+{
+    std::ifstream in(path);
+    std::string line;
+    unsigned number = 0;
+    bool loaded = false;
+    Radio *radio = nullptr;
+
+    if (!in)
+    {
+        std::fprintf(stderr, "%s: cannot open\n", path.c_str());
+        return false;
+    }
+    while (std::getline(in, line))
+    {
+        std::istringstream args(line.substr(0, line.find('#')));
+        std::string cmd;
+        bool ok = true;
+
+        ++number;
+        if (!(args >> cmd))
+        {
+            continue;
+        }
+        if ("firmware" == cmd)
+        {
+            std::string file;
+
+            ok = !loaded && (args >> file) && sim.load(file);
+            loaded = ok;
+        }
+        else if (!loaded)
+        {
+            ok = false; // every other command needs the CPU
+        }
+        else if ("spi" == cmd)
+        {
+            std::string device;
+            std::vector<Pin> p;
+
+            args >> device;
+            ok = pins(args, p);
+            if (ok && ("tft" == device) && (1 == p.size()))
+            {
+                sim.attach(std::make_unique<Display>(sim, p[0]));
+            }
+            else if (ok && ("radio" == device) && (2 == p.size()) &&
+                     (nullptr == radio))
+            {
+                auto model = std::make_unique<Radio>(sim, p[0], p[1]);
+
+                radio = model.get();
+                sim.attach(std::move(model));
+            }
+            else
+            {
+                ok = false;
+            }
+        }
+        else if ("twi" == cmd)
+        {
+            std::string device;
+            unsigned address = 0;
+
+            ok = (args >> device >> std::hex >> address) && ("gas" == device);
+            if (ok)
+            {
+                sim.attach(std::make_unique<GasModule>(
+                    sim, static_cast<uint8_t>(address), hex_bytes(args)));
+            }
+        }
+        else if (("high" == cmd) || ("low" == cmd))
+        {
+            std::vector<Pin> p;
+
+            ok = pins(args, p);
+            for (const Pin &pin : p)
+            {
+                sim.drive(pin, "high" == cmd);
+            }
+        }
+        else if ("adc" == cmd)
+        {
+            unsigned channel = 0;
+            unsigned millivolts = 0;
+
+            ok = (args >> channel >> millivolts) && (8 > channel);
+            if (ok)
+            {
+                sim.analog(channel, millivolts);
+            }
+        }
+        else if ("run" == cmd)
+        {
+            unsigned ms = 0;
+
+            ok = (args >> ms) && sim.run(ms);
+        }
+        else if ("reset" == cmd)
+        {
+            sim.reset_sections();
+        }
+        else if ("rx" == cmd)
+        {
+            ok = nullptr != radio;
+            if (ok)
+            {
+                radio->receive(hex_bytes(args));
+            }
+        }
+        else
+        {
+            std::fprintf(stderr, "%s:%u: unknown command '%s'\n",
+                         path.c_str(), number, cmd.c_str());
+            return false;
+        }
+        if (!ok)
+        {
+            std::fprintf(stderr, "%s:%u: '%s' failed\n", path.c_str(), number,
+                         cmd.c_str());
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Print the sections run by a script, check them against `baseline`
+ * @return `false` if one of them regressed
+ */
+bool report(const std::string &name, const Sim &sim, const Baseline &baseline,
+            double threshold)
+{
+    bool ok = true;
+
+    for (unsigned id = 0; id < SECTION_COUNT; ++id)
+    {
+        const Section &s = sim.section(id);
+
+        if (0 == s.count)
+        {
+            continue;
+        }
+        double mean = static_cast<double>(s.total) / s.count;
+
+        std::printf("%s\t%s\t%lu\t%llu\t%llu\t%.1f\n", name.c_str(),
+                    SECTION_NAMES[id], s.count,
+                    static_cast<unsigned long long>(s.min),
+                    static_cast<unsigned long long>(s.max), mean);
+
+        auto base = baseline.find({name, SECTION_NAMES[id]});
+
+        if ((baseline.end() != base) &&
+            (mean > base->second * (1.0 + threshold / 100.0)))
+        {
+            std::fprintf(stderr, "%s %s: %.1f cycles, was %.1f (+%.1f%%)\n",
+                         name.c_str(), SECTION_NAMES[id], mean, base->second,
+                         (mean / base->second - 1.0) * 100.0);
+            ok = false;
+        }
+    }
+    std::fflush(stdout);
+    return ok;
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    Baseline baseline;
+    double threshold = THRESHOLD;
+    bool ok = true;
+    int opt;
+
+    while (-1 != (opt = getopt(argc, argv, "b:t:")))
+    {
+        switch (opt)
+        {
+        case 'b':
+            if (!load_baseline(optarg, baseline))
+            {
+                return EXIT_FAILURE;
+            }
+            break;
+        case 't':
+            threshold = std::atof(optarg);
+            break;
+        default:
+            std::fprintf(stderr,
+                         "usage: %s [-b baseline] [-t percent] script...\n",
+                         argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+    std::printf("script\tsection\tcount\tmin\tmax\tmean\n");
+    for (int i = optind; i < argc; ++i)
+    {
+        std::string path = argv[i];
+        std::string name = path.substr(path.find_last_of('/') + 1);
+        Sim sim; // from reset
+
+        name = name.substr(0, name.find('.'));
+        if (!script(path, sim))
+        {
+            ok = false;
+            continue;
+        }
+        ok = report(name, sim, baseline, threshold) && ok;
+    }
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
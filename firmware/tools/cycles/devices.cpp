@@ -0,0 +1,316 @@
+#include "devices.h"
+
+#include <util/packet.h>
+
+namespace cycles
+{
+
+namespace
+{
+
+// nRF24L01 registers and commands, see nrf24l01.h
+constexpr uint8_t CONFIG = 0x00;
+constexpr uint8_t EN_AA = 0x01;
+constexpr uint8_t EN_RXADDR = 0x02;
+constexpr uint8_t SETUP_AW = 0x03;
+constexpr uint8_t SETUP_RETR = 0x04;
+constexpr uint8_t RF_CH = 0x05;
+constexpr uint8_t RF_SETUP = 0x06;
+constexpr uint8_t STATUS = 0x07;
+constexpr uint8_t OBSERVE_TX = 0x08;
+constexpr uint8_t RX_ADDR_P0 = 0x0A;
+constexpr uint8_t TX_ADDR = 0x10;
+constexpr uint8_t FIFO_STATUS = 0x17;
+
+constexpr uint8_t W_REGISTER = 0x20;
+constexpr uint8_t R_RX_PL_WID = 0x60;
+constexpr uint8_t R_RX_PAYLOAD = 0x61;
+constexpr uint8_t W_TX_PAYLOAD = 0xA0;
+constexpr uint8_t W_TX_PAYLOAD_NOACK = 0xB0;
+constexpr uint8_t FLUSH_TX = 0xE1;
+constexpr uint8_t FLUSH_RX = 0xE2;
+constexpr uint8_t REUSE_TX_PL = 0xE3;
+
+constexpr uint8_t PRIM_RX = 0x01;
+constexpr uint8_t PWR_UP = 0x02;
+constexpr uint8_t CRCO = 0x04;
+constexpr uint8_t EN_CRC = 0x08;
+constexpr uint8_t RF_DR_HIGH = 0x08;
+constexpr uint8_t RF_DR_LOW = 0x20;
+
+constexpr uint8_t RX_DR = 0x40;
+constexpr uint8_t TX_DS = 0x20;
+constexpr uint8_t MAX_RT = 0x10;
+constexpr uint8_t RX_P_NO_EMPTY = 0x0E;
+
+constexpr size_t FIFO_DEPTH = 3;
+constexpr unsigned SETTLING_US = 130; // TX, then RX for the ACK
+constexpr unsigned PCF_BITS = 9;      // Packet Control Field
+
+} // namespace
+
+//------------------------------------------------------------------------------
+// Display
+//------------------------------------------------------------------------------
+
+uint8_t Display::exchange(uint8_t data)
+{
+    (void)data;
+    ++bytes;
+    return 0x00;
+}
+
+//------------------------------------------------------------------------------
+// Radio
+//------------------------------------------------------------------------------
+
+Radio::Radio(Sim &sim, const Pin &csn, const Pin &ce)
+    : SpiDevice(sim, csn), _ce(ce)
+{
+    _regs[CONFIG][0] = EN_CRC;
+    _regs[EN_AA][0] = 0x3F;
+    _regs[EN_RXADDR][0] = 0x03;
+    _regs[SETUP_AW][0] = 0x03;
+    _regs[SETUP_RETR][0] = 0x03;
+    _regs[RF_CH][0] = 0x02;
+    _regs[RF_SETUP][0] = 0x0E;
+    for (unsigned i = 0; i < 5; ++i)
+    {
+        _regs[RX_ADDR_P0][i] = 0xE7;
+        _regs[RX_ADDR_P0 + 1][i] = 0xC2;
+        _regs[TX_ADDR][i] = 0xE7;
+    }
+    for (uint8_t pipe = 2; pipe < 6; ++pipe)
+    {
+        _regs[RX_ADDR_P0 + pipe][0] = static_cast<uint8_t>(0xC1 + pipe);
+    }
+    sim.watch(csn, this);
+    sim.watch(ce, this);
+}
+
+uint8_t Radio::exchange(uint8_t data)
+{
+    if (!_command)
+    {
+        _command = true;
+        _instruction = data;
+        _index = 0;
+        if (FLUSH_TX == data)
+        {
+            _tx.clear();
+            _reuse = false;
+        }
+        else if (FLUSH_RX == data)
+        {
+            _rx.clear();
+        }
+        else if (REUSE_TX_PL == data)
+        {
+            _reuse = true;
+        }
+        else if ((W_TX_PAYLOAD == data) || (W_TX_PAYLOAD_NOACK == data))
+        {
+            _tx_payload.clear();
+        }
+        return _status(); // shifted out with the command
+    }
+
+    unsigned index = _index++;
+
+    if (W_REGISTER > _instruction)
+    {
+        return _read(_instruction, index);
+    }
+    if (R_RX_PL_WID > _instruction)
+    {
+        _write(_instruction & 0x1F, index, data);
+    }
+    else if (R_RX_PAYLOAD == _instruction)
+    {
+        return _rx.empty() ? 0x00 : _rx.front()[index % PACKET_SIZE];
+    }
+    else if (R_RX_PL_WID == _instruction)
+    {
+        return PACKET_SIZE;
+    }
+    else if (((W_TX_PAYLOAD == _instruction) ||
+              (W_TX_PAYLOAD_NOACK == _instruction)) &&
+             (PACKET_SIZE > _tx_payload.size()))
+    {
+        _tx_payload.push_back(data);
+    }
+    return 0x00;
+}
+
+void Radio::pin_changed(const Pin &pin, bool level)
+{
+    if ((pin.port == cs.port) && (pin.bit == cs.bit))
+    {
+        if (!level && !_selected)
+        {
+            _selected = true;
+            _command = false;
+        }
+        else if (level && _selected)
+        {
+            _selected = false;
+            _end();
+        }
+        return;
+    }
+    if (level && !_ce_level && !_on_air && !_tx.empty() &&
+        (_regs[CONFIG][0] & PWR_UP) && !(_regs[CONFIG][0] & PRIM_RX))
+    {
+        _on_air = true;
+        _sim.after(_airtime_us(), this);
+    } // pulse of CE in TX mode
+    _ce_level = level;
+}
+
+void Radio::timer()
+{
+    _on_air = false;
+    _flags |= TX_DS;
+    ++sent;
+    if (!_reuse && !_tx.empty())
+    {
+        _tx.pop_front();
+    }
+}
+
+void Radio::receive(const std::vector<uint8_t> &payload)
+{
+    if (FIFO_DEPTH <= _rx.size())
+    {
+        return;
+    } // lost, as on the air
+    _rx.push_back(payload);
+    _rx.back().resize(PACKET_SIZE, 0x00);
+    _flags |= RX_DR;
+}
+
+uint8_t Radio::_status() const
+{
+    return static_cast<uint8_t>(_flags | (_rx.empty() ? RX_P_NO_EMPTY : 0x00) |
+                                ((FIFO_DEPTH <= _tx.size()) ? 0x01 : 0x00));
+}
+
+uint8_t Radio::_fifo_status() const
+{
+    return static_cast<uint8_t>((_reuse ? 0x40 : 0x00) |
+                                ((FIFO_DEPTH <= _tx.size()) ? 0x20 : 0x00) |
+                                (_tx.empty() ? 0x10 : 0x00) |
+                                ((FIFO_DEPTH <= _rx.size()) ? 0x02 : 0x00) |
+                                (_rx.empty() ? 0x01 : 0x00));
+}
+
+uint8_t Radio::_read(uint8_t reg, unsigned index) const
+{
+    if (STATUS == reg)
+    {
+        return _status();
+    }
+    if (FIFO_STATUS == reg)
+    {
+        return _fifo_status();
+    }
+    if (OBSERVE_TX == reg)
+    {
+        return 0x00;
+    } // acknowledged at the first attempt
+    return (5 > index) ? _regs[reg][index] : 0x00;
+}
+
+void Radio::_write(uint8_t reg, unsigned index, uint8_t data)
+{
+    if (STATUS == reg)
+    {
+        _flags &= static_cast<uint8_t>(~(data & (RX_DR | TX_DS | MAX_RT)));
+    } // write 1 to clear
+    else if (5 > index)
+    {
+        _regs[reg][index] = data;
+    }
+}
+
+void Radio::_end()
+{
+    if ((R_RX_PAYLOAD == _instruction) && (0 != _index) && !_rx.empty())
+    {
+        _rx.pop_front();
+    }
+    else if (((W_TX_PAYLOAD == _instruction) ||
+              (W_TX_PAYLOAD_NOACK == _instruction)) &&
+             !_tx_payload.empty() && (FIFO_DEPTH > _tx.size()))
+    {
+        _tx.push_back(_tx_payload);
+        _reuse = false;
+    }
+    _command = false;
+}
+
+unsigned Radio::_airtime_us() const
+{
+    unsigned address = (_regs[SETUP_AW][0] & 0x03) + 2;
+    unsigned crc = (_regs[CONFIG][0] & EN_CRC) ? ((_regs[CONFIG][0] & CRCO) ? 2 : 1)
+                                               : 0;
+    unsigned packet = 8 * (1 + address + PACKET_SIZE + crc) + PCF_BITS;
+    unsigned ack = 8 * (1 + address + crc) + PCF_BITS;
+    unsigned kbps = (_regs[RF_SETUP][0] & RF_DR_LOW)    ? 250
+                    : (_regs[RF_SETUP][0] & RF_DR_HIGH) ? 2000
+                                                        : 1000;
+
+    return 2 * SETTLING_US + (packet + ack) * 1000 / kbps;
+}
+
+//------------------------------------------------------------------------------
+// GasModule
+//------------------------------------------------------------------------------
+
+GasModule::GasModule(Sim &sim, uint8_t address,
+                     const std::vector<uint8_t> &data)
+    : TwiDevice(sim, address)
+{
+    std::vector<uint8_t> packet = data;
+
+    if (packet.empty())
+    {
+        packet.assign(GAS_SIZE, 0x00);
+        packet[1] = GAS_SIZE - 2;
+        packet[IDX_CO2 + 1] = 0x90; // 400 ppm
+        packet[IDX_CO2] = 0x01;
+        packet[IDX_CO + 1] = 100;
+        packet[IDX_NH3 + 1] = 50;
+        packet[IDX_NO2 + 1] = 20;
+        packet[IDX_O2 + 1] = 200;
+        packet[IDX_TEMP] = 21 + CO2_TEMP_OFFSET;
+        packet[IDX_STATUS] = STATUS_CO2_VALID;
+    } // fresh air, sensors warmed up
+    _frame.push_back(static_cast<uint8_t>(packet.size() >> 8));
+    _frame.push_back(static_cast<uint8_t>(packet.size() & 0xFF));
+    _frame.insert(_frame.end(), packet.begin(), packet.end());
+}
+
+bool GasModule::start(bool read)
+{
+    _index = 0;
+    if (read)
+    {
+        ++reads;
+    }
+    return true;
+}
+
+bool GasModule::write(uint8_t data)
+{
+    (void)data;
+    return true;
+}
+
+uint8_t GasModule::read(bool ack)
+{
+    (void)ack;
+    return (_frame.size() > _index) ? _frame[_index++] : 0xFF;
+}
+
+} // namespace cycles
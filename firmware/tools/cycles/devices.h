@@ -0,0 +1,100 @@
+/**
+ * @file devices.h
+ * @brief Stand-ins of the chips around the boards
+ * @details Each one answers just enough for the firmware to keep running at
+ * its real pace: nothing is checked, nothing fails.
+ */
+
+#ifndef VEMAR_CYCLES_DEVICES_H
+#define VEMAR_CYCLES_DEVICES_H
+
+#include <deque>
+#include <vector>
+
+#include "sim.h"
+
+namespace cycles
+{
+
+/**
+ * @brief ILI9341 display: takes every byte, reads return `0`
+ */
+class Display : public SpiDevice
+{
+public:
+    using SpiDevice::SpiDevice;
+
+    uint8_t exchange(uint8_t data) override;
+
+    unsigned long bytes = 0; /**< Bytes received */
+};
+
+/**
+ * @brief nRF24L01 transceiver
+ * @details Registers, FIFOs and the STATUS flags of the driver. Every
+ * transmission started by a pulse of __CE__ is acknowledged after its time
+ * on the air; payloads are received only when the script says so.
+ */
+class Radio : public SpiDevice
+{
+public:
+    Radio(Sim &sim, const Pin &csn, const Pin &ce);
+
+    uint8_t exchange(uint8_t data) override;
+    void pin_changed(const Pin &pin, bool level) override;
+    void timer() override;
+
+    /**
+     * @brief Payload received from the other end, padded to 32 bytes
+     */
+    void receive(const std::vector<uint8_t> &payload);
+
+    unsigned long sent = 0; /**< Transmissions acknowledged */
+
+private:
+    using Payload = std::vector<uint8_t>;
+
+    uint8_t _status() const;
+    uint8_t _fifo_status() const;
+    uint8_t _read(uint8_t reg, unsigned index) const;
+    void _write(uint8_t reg, unsigned index, uint8_t data);
+    void _end();
+    unsigned _airtime_us() const;
+
+    Pin _ce;
+    uint8_t _regs[0x20][5] = {};
+    uint8_t _flags = 0;      /**< RX_DR, TX_DS and MAX_RT of STATUS */
+    bool _selected = false;  /**< __CSN__ LOW */
+    bool _command = false;   /**< Command byte received */
+    uint8_t _instruction = 0;
+    unsigned _index = 0;     /**< Data bytes of the command */
+    Payload _tx_payload;     /**< Payload being written */
+    std::deque<Payload> _tx;
+    std::deque<Payload> _rx;
+    bool _reuse = false;     /**< `REUSE_TX_PL` */
+    bool _ce_level = false;
+    bool _on_air = false;
+};
+
+/**
+ * @brief Gas module: a length-prefixed packet at every read
+ */
+class GasModule : public TwiDevice
+{
+public:
+    GasModule(Sim &sim, uint8_t address, const std::vector<uint8_t> &data);
+
+    bool start(bool read) override;
+    bool write(uint8_t data) override;
+    uint8_t read(bool ack) override;
+
+    unsigned long reads = 0; /**< Packets read */
+
+private:
+    std::vector<uint8_t> _frame; /**< Length, then data */
+    size_t _index = 0;
+};
+
+} // namespace cycles
+
+#endif // VEMAR_CYCLES_DEVICES_H
@@ -0,0 +1,309 @@
+#include "sim.h"
+
+#include <cstdio>
+
+#include <avr_adc.h>
+#include <avr_ioport.h>
+#include <avr_spi.h>
+#include <avr_twi.h>
+#include <sim_avr.h>
+#include <sim_cycle_timers.h>
+#include <sim_elf.h>
+#include <sim_io.h>
+#include <sim_irq.h>
+
+namespace cycles
+{
+
+namespace
+{
+
+constexpr const char *MCU = "atmega328p";
+constexpr uint32_t FREQUENCY = 16000000;
+constexpr uint32_t VCC_MV = 5000;
+
+// data space addresses, see profile.h
+constexpr uint16_t REG_PINB = 0x23;
+constexpr uint16_t REG_SECTION_BEGIN = 0x4A; // GPIOR1
+constexpr uint16_t REG_SECTION_END = 0x4B;   // GPIOR2
+
+/**
+ * @brief PORT register of a pin: PINx, DDRx and PORTx follow each other
+ */
+uint16_t port_register(const Pin &pin)
+{
+    return static_cast<uint16_t>(REG_PINB + 3 * (pin.port - 'B') + 2);
+}
+
+} // namespace
+
+//------------------------------------------------------------------------------
+// Pin
+//------------------------------------------------------------------------------
+
+bool Pin::parse(const std::string &name, Pin &pin)
+{
+    if ((3 != name.size()) || ('P' != name[0]) || (name[1] < 'B') ||
+        (name[1] > 'D') || (name[2] < '0') || (name[2] > '7'))
+    {
+        return false;
+    }
+    pin.port = name[1];
+    pin.bit = static_cast<uint8_t>(name[2] - '0');
+    return true;
+}
+
+//------------------------------------------------------------------------------
+// Sim
+//------------------------------------------------------------------------------
+
+Sim::~Sim()
+{
+    if (nullptr != _avr)
+    {
+        avr_terminate(_avr);
+    }
+}
+
+bool Sim::load(const std::string &path)
+{
+    elf_firmware_t firmware = {};
+
+    if (0 != elf_read_firmware(path.c_str(), &firmware))
+    {
+        std::fprintf(stderr, "%s: cannot read the image\n", path.c_str());
+        return false;
+    }
+    _avr = avr_make_mcu_by_name(MCU);
+    if (nullptr == _avr)
+    {
+        std::fprintf(stderr, "simavr does not know the %s\n", MCU);
+        return false;
+    }
+    avr_init(_avr);
+    avr_load_firmware(_avr, &firmware);
+    _avr->frequency = FREQUENCY;
+    _avr->vcc = VCC_MV;
+    _avr->avcc = VCC_MV;
+    _avr->aref = VCC_MV;
+
+    avr_register_io_write(_avr, REG_SECTION_BEGIN, _on_begin, this);
+    avr_register_io_write(_avr, REG_SECTION_END, _on_end, this);
+    avr_irq_register_notify(
+        avr_io_getirq(_avr, AVR_IOCTL_SPI_GETIRQ(0), SPI_IRQ_OUTPUT), _on_spi,
+        this);
+    avr_irq_register_notify(
+        avr_io_getirq(_avr, AVR_IOCTL_TWI_GETIRQ(0), TWI_IRQ_OUTPUT), _on_twi,
+        this);
+    return true;
+}
+
+bool Sim::run(unsigned ms)
+{
+    avr_cycle_count_t end =
+        _avr->cycle + static_cast<avr_cycle_count_t>(ms) * (FREQUENCY / 1000);
+
+    while (_avr->cycle < end)
+    {
+        int state = avr_run(_avr);
+
+        if ((cpu_Done == state) || (cpu_Crashed == state))
+        {
+            std::fprintf(stderr, "firmware %s at PC 0x%04x\n",
+                         (cpu_Crashed == state) ? "crashed" : "stopped",
+                         static_cast<unsigned>(_avr->pc));
+            return false;
+        }
+    }
+    return true;
+}
+
+void Sim::attach(std::unique_ptr<SpiDevice> device)
+{
+    _spi.push_back(std::move(device));
+}
+
+void Sim::attach(std::unique_ptr<TwiDevice> device)
+{
+    _twi_devices.push_back(std::move(device));
+}
+
+void Sim::drive(const Pin &pin, bool level)
+{
+    avr_raise_irq(avr_io_getirq(_avr, AVR_IOCTL_IOPORT_GETIRQ(pin.port),
+                                pin.bit),
+                  level ? 1 : 0);
+}
+
+void Sim::analog(unsigned channel, unsigned millivolts)
+{
+    avr_raise_irq(avr_io_getirq(_avr, AVR_IOCTL_ADC_GETIRQ,
+                                static_cast<int>(ADC_IRQ_ADC0 + channel)),
+                  millivolts);
+}
+
+bool Sim::level(const Pin &pin) const
+{
+    return 0 != (_avr->data[port_register(pin)] & (1 << pin.bit));
+}
+
+void Sim::watch(const Pin &pin, Device *device)
+{
+    _watches.push_back(std::make_unique<Watch>(Watch{pin, device}));
+    avr_irq_register_notify(avr_io_getirq(_avr,
+                                          AVR_IOCTL_IOPORT_GETIRQ(pin.port),
+                                          pin.bit),
+                            _on_pin, _watches.back().get());
+}
+
+void Sim::after(unsigned us, Device *device)
+{
+    avr_cycle_timer_register_usec(_avr, us, _on_timer, device);
+}
+
+void Sim::reset_sections()
+{
+    for (Section &section : _sections)
+    {
+        Section cleared;
+
+        cleared.start = section.start;
+        cleared.open = section.open;
+        section = cleared;
+    }
+}
+
+//------------------------------------------------------------------------------
+// Callbacks of simavr
+//------------------------------------------------------------------------------
+
+void Sim::_on_begin(avr_t *avr, uint16_t addr, uint8_t v, void *param)
+{
+    Sim *sim = static_cast<Sim *>(param);
+
+    avr->data[addr] = v;
+    if (SECTION_COUNT > v)
+    {
+        sim->_sections[v].start = avr->cycle;
+        sim->_sections[v].open = true;
+    }
+}
+
+void Sim::_on_end(avr_t *avr, uint16_t addr, uint8_t v, void *param)
+{
+    Sim *sim = static_cast<Sim *>(param);
+
+    avr->data[addr] = v;
+    if ((SECTION_COUNT <= v) || !sim->_sections[v].open)
+    {
+        return;
+    } // begun before the image was loaded, or not at all
+    Section &section = sim->_sections[v];
+    uint64_t elapsed = avr->cycle - section.start;
+
+    section.open = false;
+    ++section.count;
+    section.total += elapsed;
+    if (section.min > elapsed)
+    {
+        section.min = elapsed;
+    }
+    if (section.max < elapsed)
+    {
+        section.max = elapsed;
+    }
+}
+
+void Sim::_on_spi(avr_irq_t *irq, uint32_t value, void *param)
+{
+    Sim *sim = static_cast<Sim *>(param);
+    uint8_t reply = 0xFF; // MISO pulled up
+
+    (void)irq;
+    for (auto &device : sim->_spi)
+    {
+        if (!sim->level(device->cs))
+        {
+            reply = device->exchange(static_cast<uint8_t>(value));
+            break;
+        }
+    }
+    avr_raise_irq(avr_io_getirq(sim->_avr, AVR_IOCTL_SPI_GETIRQ(0),
+                                SPI_IRQ_INPUT),
+                  reply);
+}
+
+void Sim::_on_twi(avr_irq_t *irq, uint32_t value, void *param)
+{
+    (void)irq;
+    static_cast<Sim *>(param)->_twi(value);
+}
+
+void Sim::_on_pin(avr_irq_t *irq, uint32_t value, void *param)
+{
+    Watch *watch = static_cast<Watch *>(param);
+
+    (void)irq;
+    watch->device->pin_changed(watch->pin, 0 != value);
+}
+
+uint64_t Sim::_on_timer(avr_t *avr, uint64_t when, void *param)
+{
+    (void)avr;
+    (void)when;
+    static_cast<Device *>(param)->timer();
+    return 0; // one shot
+}
+
+void Sim::_twi(uint32_t value)
+{
+    avr_irq_t *input = avr_io_getirq(_avr, AVR_IOCTL_TWI_GETIRQ(0),
+                                     TWI_IRQ_INPUT);
+    avr_twi_msg_irq_t msg;
+
+    msg.u.v = value;
+    if (msg.u.twi.msg & TWI_COND_STOP)
+    {
+        if (nullptr != _twi_selected)
+        {
+            _twi_selected->stop();
+        }
+        _twi_selected = nullptr;
+    }
+    if (msg.u.twi.msg & TWI_COND_START)
+    {
+        bool read = 0 != (msg.u.twi.addr & 0x01);
+
+        _twi_selected = nullptr;
+        for (auto &device : _twi_devices)
+        {
+            if ((device->address == (msg.u.twi.addr >> 1)) &&
+                device->start(read))
+            {
+                _twi_selected = device.get();
+                avr_raise_irq(input, avr_twi_irq_msg(TWI_COND_ACK,
+                                                     msg.u.twi.addr, 1));
+                break;
+            }
+        } // no ACK: the master reads a NACK status
+    }
+    if (nullptr == _twi_selected)
+    {
+        return;
+    }
+    if ((msg.u.twi.msg & TWI_COND_WRITE) &&
+        _twi_selected->write(msg.u.twi.data))
+    {
+        avr_raise_irq(input, avr_twi_irq_msg(TWI_COND_ACK, msg.u.twi.addr, 1));
+    }
+    if (msg.u.twi.msg & TWI_COND_READ)
+    {
+        uint8_t data =
+            _twi_selected->read(0 != (msg.u.twi.msg & TWI_COND_ACK));
+
+        avr_raise_irq(input, avr_twi_irq_msg(TWI_COND_READ, msg.u.twi.addr,
+                                             data));
+    }
+}
+
+} // namespace cycles
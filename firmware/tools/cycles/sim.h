@@ -0,0 +1,218 @@
+/**
+ * @file sim.h
+ * @brief Board image running on simavr, with the devices of its buses
+ */
+
+#ifndef VEMAR_CYCLES_SIM_H
+#define VEMAR_CYCLES_SIM_H
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+struct avr_t;
+struct avr_irq_t;
+
+namespace cycles
+{
+
+constexpr unsigned SECTION_COUNT = 8; // PROFILE_COUNT of profile.h
+
+/**
+ * @brief Statistics of a profiled section, in CPU cycles
+ */
+struct Section
+{
+    unsigned long count = 0;
+    uint64_t min = UINT64_MAX;
+    uint64_t max = 0;
+    uint64_t total = 0;
+    uint64_t start = 0; /**< Cycle of the last `PROFILE_BEGIN` */
+    bool open = false;  /**< `PROFILE_BEGIN` without `PROFILE_END` yet */
+};
+
+/**
+ * @brief Pin of an I/O port, written `PB2` in the scripts
+ */
+struct Pin
+{
+    char port = 'B';
+    uint8_t bit = 0;
+
+    static bool parse(const std::string &name, Pin &pin);
+};
+
+class Sim;
+
+/**
+ * @brief Model of a chip on the board
+ */
+class Device
+{
+public:
+    explicit Device(Sim &sim) : _sim(sim)
+    {
+    }
+    virtual ~Device() = default;
+
+    /**
+     * @brief Output level of a pin watched with `Sim::watch`
+     */
+    virtual void pin_changed(const Pin &pin, bool level)
+    {
+        (void)pin;
+        (void)level;
+    }
+
+    /**
+     * @brief Timer armed with `Sim::after`
+     */
+    virtual void timer()
+    {
+    }
+
+protected:
+    Sim &_sim;
+};
+
+/**
+ * @brief SPI slave, exchanges bytes while its Chip Select is LOW
+ */
+class SpiDevice : public Device
+{
+public:
+    SpiDevice(Sim &sim, const Pin &cs) : Device(sim), cs(cs)
+    {
+    }
+
+    /**
+     * @return Byte shifted in by the master for `data`
+     */
+    virtual uint8_t exchange(uint8_t data) = 0;
+
+    const Pin cs;
+};
+
+/**
+ * @brief TWI slave
+ */
+class TwiDevice : public Device
+{
+public:
+    TwiDevice(Sim &sim, uint8_t address) : Device(sim), address(address)
+    {
+    }
+
+    /**
+     * @brief Addressed after a START
+     * @return `true` to ACK
+     */
+    virtual bool start(bool read) = 0;
+
+    /**
+     * @return `true` to ACK
+     */
+    virtual bool write(uint8_t data) = 0;
+
+    /**
+     * @param ack The master acknowledges the byte
+     */
+    virtual uint8_t read(bool ack) = 0;
+
+    virtual void stop()
+    {
+    }
+
+    const uint8_t address; /**< 7-bit address */
+};
+
+/**
+ * @brief ATmega328P running a board image
+ */
+class Sim
+{
+public:
+    Sim() = default;
+    ~Sim();
+    Sim(const Sim &) = delete;
+    Sim &operator=(const Sim &) = delete;
+
+    /**
+     * @brief Load an ELF image and reset the CPU
+     * @return `false` if the image cannot be read
+     */
+    bool load(const std::string &path);
+
+    /**
+     * @brief Run the CPU
+     * @return `false` if the firmware crashed or stopped
+     */
+    bool run(unsigned ms);
+
+    void attach(std::unique_ptr<SpiDevice> device);
+    void attach(std::unique_ptr<TwiDevice> device);
+
+    /**
+     * @brief Drive an input pin
+     */
+    void drive(const Pin &pin, bool level);
+
+    /**
+     * @brief Voltage on an analog input
+     */
+    void analog(unsigned channel, unsigned millivolts);
+
+    /**
+     * @brief Output level of a pin, as written to its PORT register
+     */
+    bool level(const Pin &pin) const;
+
+    /**
+     * @brief Call `device->pin_changed` on every change of `pin`
+     */
+    void watch(const Pin &pin, Device *device);
+
+    /**
+     * @brief Call `device->timer` in `us` microseconds, replaces the timer
+     * already armed for `device`
+     */
+    void after(unsigned us, Device *device);
+
+    const Section &section(unsigned id) const
+    {
+        return _sections[id];
+    }
+
+    /**
+     * @brief Clear the statistics, sections already started are kept
+     */
+    void reset_sections();
+
+private:
+    struct Watch
+    {
+        Pin pin;
+        Device *device;
+    };
+
+    static void _on_begin(avr_t *avr, uint16_t addr, uint8_t v, void *param);
+    static void _on_end(avr_t *avr, uint16_t addr, uint8_t v, void *param);
+    static void _on_spi(avr_irq_t *irq, uint32_t value, void *param);
+    static void _on_twi(avr_irq_t *irq, uint32_t value, void *param);
+    static void _on_pin(avr_irq_t *irq, uint32_t value, void *param);
+    static uint64_t _on_timer(avr_t *avr, uint64_t when, void *param);
+
+    void _twi(uint32_t value);
+
+    avr_t *_avr = nullptr;
+    Section _sections[SECTION_COUNT];
+    std::vector<std::unique_ptr<SpiDevice>> _spi;
+    std::vector<std::unique_ptr<TwiDevice>> _twi_devices;
+    TwiDevice *_twi_selected = nullptr;
+    std::vector<std::unique_ptr<Watch>> _watches;
+};
+
+} // namespace cycles
+
+#endif // VEMAR_CYCLES_SIM_H
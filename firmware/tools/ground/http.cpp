@@ -0,0 +1,355 @@
+#include "http.h"
+
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace ground
+{
+
+namespace
+{
+
+constexpr int POLL_TIMEOUT = 50;             // ms, latency of `/events`
+constexpr size_t REQUEST_MAX = 4096;         // header bytes of a request
+constexpr size_t PENDING_MAX = 1024 * 1024;  // output bytes of a slow client
+constexpr size_t EVENTS_MAX = 256;           // samples per `/events` round
+
+const char PAGE[] = R"(<!DOCTYPE html>
+<html>
+<head>
+<meta charset="utf-8">
+<title>VEMAR ground station</title>
+<style>
+body { font-family: monospace; background: #111; color: #ddd; }
+table { border-collapse: collapse; margin-bottom: 1em; }
+td, th { border: 1px solid #444; padding: 2px 8px; text-align: right; }
+th { color: #8cf; }
+.stale { color: #777; }
+</style>
+</head>
+<body>
+<h1>VEMAR</h1>
+<p id="status">connecting</p>
+<div id="modules"></div>
+<script>
+const tables = {};
+const seen = {};
+function table(name, sample) {
+    if (!tables[name]) {
+        const t = document.createElement('table');
+        const keys = Object.keys(sample).filter(k => k !== 'module');
+        t.innerHTML = '<caption>' + name + '</caption><tr>' +
+            keys.map(k => '<th>' + k + '</th>').join('') + '</tr><tr>' +
+            keys.map(k => '<td data-k="' + k + '"></td>').join('') + '</tr>';
+        document.getElementById('modules').appendChild(t);
+        tables[name] = t;
+    }
+    return tables[name];
+}
+function show(sample) {
+    const t = table(sample.module, sample);
+    for (const td of t.querySelectorAll('td')) {
+        td.textContent = sample[td.dataset.k];
+    }
+    t.className = '';
+    seen[sample.module] = Date.now();
+}
+fetch('/api/latest').then(r => r.json()).then(all => {
+    for (const name in all) { show(all[name]); }
+});
+const events = new EventSource('/events');
+events.onopen = () => { document.getElementById('status').textContent = 'live'; };
+events.onerror = () => { document.getElementById('status').textContent = 'disconnected'; };
+events.onmessage = e => show(JSON.parse(e.data));
+setInterval(() => {
+    for (const name in seen) {
+        if (Date.now() - seen[name] > 3000) { tables[name].className = 'stale'; }
+    }
+}, 1000);
+</script>
+</body>
+</html>
+)";
+
+std::string response(const char *status, const char *type,
+                     const std::string &body)
+{
+    return std::string("HTTP/1.1 ") + status +
+           "\r\nContent-Type: " + type +
+           "\r\nContent-Length: " + std::to_string(body.size()) +
+           "\r\nCache-Control: no-store\r\nConnection: close\r\n\r\n" + body;
+}
+
+/**
+ * @brief Value of a query parameter, empty if absent
+ */
+std::string query(const std::string &target, const char *key)
+{
+    size_t start = target.find('?');
+    std::string name = std::string(key) + "=";
+
+    while (std::string::npos != start)
+    {
+        ++start;
+        if (0 == target.compare(start, name.size(), name))
+        {
+            size_t end = target.find('&', start);
+            return target.substr(start + name.size(),
+                                 (std::string::npos == end)
+                                     ? std::string::npos
+                                     : end - start - name.size());
+        }
+        start = target.find('&', start);
+    }
+    return "";
+}
+
+} // namespace
+
+HttpServer::HttpServer(const Store &store, uint16_t port)
+    : _store(store), _port(port)
+{
+}
+
+HttpServer::~HttpServer()
+{
+    stop();
+    if (_thread.joinable())
+    {
+        _thread.join();
+    }
+    for (Client &client : _clients)
+    {
+        close(client.fd);
+    }
+    if (0 <= _listen)
+    {
+        close(_listen);
+    }
+}
+
+bool HttpServer::start()
+{
+    struct sockaddr_in addr = {};
+    int one = 1;
+
+    _listen = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK, 0);
+    if (0 > _listen)
+    {
+        std::fprintf(stderr, "socket: %s\n", std::strerror(errno));
+        return false;
+    }
+    setsockopt(_listen, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(_port);
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK); // local view only
+    if ((0 != bind(_listen, reinterpret_cast<struct sockaddr *>(&addr),
+                   sizeof(addr))) ||
+        (0 != listen(_listen, 8)))
+    {
+        std::fprintf(stderr, "port %u: %s\n", _port, std::strerror(errno));
+        return false;
+    }
+    _thread = std::thread(&HttpServer::run, this);
+    return true;
+}
+
+void HttpServer::stop()
+{
+    _stop = true;
+}
+
+void HttpServer::run()
+{
+    std::vector<struct pollfd> fds;
+
+    while (!_stop)
+    {
+        fds.assign(1, {_listen, POLLIN, 0});
+        for (const Client &client : _clients)
+        {
+            short events = POLLIN;
+            if (!client.out.empty())
+            {
+                events |= POLLOUT;
+            }
+            fds.push_back({client.fd, events, 0});
+        }
+        if (0 > poll(fds.data(), fds.size(), POLL_TIMEOUT))
+        {
+            continue;
+        }
+        if (fds[0].revents & POLLIN)
+        {
+            accept_client();
+        }
+        for (size_t i = 0; i + 1 < fds.size() && i < _clients.size(); ++i)
+        {
+            Client &client = _clients[i];
+            short revents = fds[i + 1].revents;
+            bool alive = true;
+
+            if (revents & (POLLIN | POLLHUP | POLLERR))
+            {
+                alive = read_client(client);
+            }
+            if (alive && client.events)
+            {
+                stream(client);
+            }
+            if (alive && !client.out.empty())
+            {
+                alive = write_client(client);
+            }
+            client.closed = !alive || (client.done && client.out.empty());
+        } // closed below, the indices still match `fds`
+        for (size_t i = 0; i < _clients.size();)
+        {
+            if (_clients[i].closed)
+            {
+                close(_clients[i].fd);
+                _clients.erase(_clients.begin() +
+                               static_cast<std::ptrdiff_t>(i));
+            }
+            else
+            {
+                ++i;
+            }
+        }
+    }
+}
+
+void HttpServer::accept_client()
+{
+    int fd = accept4(_listen, nullptr, nullptr, SOCK_NONBLOCK);
+
+    if (0 <= fd)
+    {
+        Client client;
+        client.fd = fd;
+        _clients.push_back(std::move(client));
+    }
+}
+
+bool HttpServer::read_client(Client &client)
+{
+    char buf[1024];
+    ssize_t n = recv(client.fd, buf, sizeof(buf), 0);
+
+    if (0 > n)
+    {
+        return (EAGAIN == errno) || (EINTR == errno);
+    }
+    if (0 == n)
+    {
+        return false;
+    }
+    if (client.events || client.done)
+    {
+        return true;
+    } // one request per connection, anything else is ignored
+    client.in.append(buf, static_cast<size_t>(n));
+    size_t end = client.in.find("\r\n\r\n");
+    if (std::string::npos == end)
+    {
+        return REQUEST_MAX > client.in.size();
+    }
+    size_t sp1 = client.in.find(' ');
+    size_t sp2 = client.in.find(' ', sp1 + 1);
+    if ((std::string::npos == sp2) || (0 != client.in.compare(0, sp1, "GET")))
+    {
+        client.out = response("405 Method Not Allowed", "text/plain",
+                              "GET only\n");
+        client.done = true;
+        return true;
+    }
+    handle(client, client.in.substr(sp1 + 1, sp2 - sp1 - 1));
+    client.in.clear();
+    return true;
+}
+
+bool HttpServer::write_client(Client &client)
+{
+    ssize_t n = send(client.fd, client.out.data(), client.out.size(),
+                     MSG_NOSIGNAL);
+
+    if (0 > n)
+    {
+        return (EAGAIN == errno) || (EINTR == errno);
+    }
+    client.out.erase(0, static_cast<size_t>(n));
+    return PENDING_MAX > client.out.size();
+}
+
+void HttpServer::handle(Client &client, const std::string &target)
+{
+    std::string path = target.substr(0, target.find('?'));
+
+    client.done = true;
+    if ("/" == path)
+    {
+        client.out = response("200 OK", "text/html", PAGE);
+    }
+    else if ("/api/latest" == path)
+    {
+        client.out = response("200 OK", "application/json",
+                              _store.latest_json());
+    }
+    else if ("/api/series" == path)
+    {
+        long id = std::strtol(query(target, "id").c_str(), nullptr, 0);
+        long long since = std::strtoll(query(target, "since").c_str(),
+                                       nullptr, 10);
+
+        if ((0 >= id) || (0xFF < id))
+        {
+            client.out = response("400 Bad Request", "text/plain",
+                                  "id: packet ID of a module\n");
+            return;
+        }
+        client.out = response("200 OK", "application/json",
+                              _store.series_json(static_cast<uint8_t>(id),
+                                                 since));
+    }
+    else if ("/events" == path)
+    {
+        client.out = "HTTP/1.1 200 OK\r\n"
+                     "Content-Type: text/event-stream\r\n"
+                     "Cache-Control: no-store\r\n"
+                     "Connection: keep-alive\r\n\r\n"
+                     "retry: 1000\n\n";
+        client.events = true;
+        client.done = false;
+        client.seq = _store.last_seq(); // new samples only
+    }
+    else
+    {
+        client.out = response("404 Not Found", "text/plain", "not found\n");
+    }
+}
+
+void HttpServer::stream(Client &client)
+{
+    std::string lines = _store.events_json(client.seq, EVENTS_MAX);
+    size_t start = 0;
+
+    while (start < lines.size())
+    {
+        size_t end = lines.find('\n', start);
+        client.out += "data: ";
+        client.out.append(lines, start, end - start);
+        client.out += "\n\n";
+        start = end + 1;
+    }
+}
+
+} // namespace ground
@@ -0,0 +1,77 @@
+/**
+ * @file http.h
+ * @brief Local HTTP view of the telemetry
+ * @details
+ * | PATH                            | CONTENT                                |
+ * | `/`                             | Live page                              |
+ * | `/api/latest`                   | Latest sample of each module, JSON     |
+ * | `/api/series?id=<id>&since=<ms>`| Samples of a module, JSON array        |
+ * | `/events`                       | Server-Sent Events, one per sample     |
+ */
+
+#ifndef VEMAR_GROUND_HTTP_H
+#define VEMAR_GROUND_HTTP_H
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "telemetry.h"
+
+namespace ground
+{
+
+/**
+ * @brief Single-threaded server on the loopback interface
+ * @details The server only reads the `Store`: a stalled browser never holds
+ * back the ingest, its connection is dropped once too much output is pending.
+ */
+class HttpServer
+{
+public:
+    HttpServer(const Store &store, uint16_t port);
+    ~HttpServer();
+
+    HttpServer(const HttpServer &) = delete;
+    HttpServer &operator=(const HttpServer &) = delete;
+
+    /**
+     * @brief Bind the port and start the server thread
+     * @return `false` on error (reported on stderr)
+     */
+    bool start();
+
+    void stop();
+
+private:
+    struct Client
+    {
+        int fd;
+        std::string in;
+        std::string out;
+        bool events = false; // streaming `/events`
+        bool done = false;   // close once `out` is sent
+        uint64_t seq = 0;    // last sample sent on `/events`
+        bool closed = false;
+    };
+
+    void run();
+    void accept_client();
+    bool read_client(Client &client);
+    bool write_client(Client &client);
+    void handle(Client &client, const std::string &target);
+    void stream(Client &client);
+
+    const Store &_store;
+    uint16_t _port;
+    int _listen = -1;
+    std::vector<Client> _clients;
+    std::atomic<bool> _stop{false};
+    std::thread _thread;
+};
+
+} // namespace ground
+
+#endif // VEMAR_GROUND_HTTP_H
@@ -0,0 +1,137 @@
+#include "ingest.h"
+
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+
+#include <poll.h>
+#include <unistd.h>
+
+namespace ground
+{
+
+namespace
+{
+
+constexpr size_t READ_SIZE = 4096; // 350 ms of a 115200 baud line
+constexpr int POLL_TIMEOUT = 100;  // ms, bounds the reaction to stop()
+
+} // namespace
+
+int64_t now_ms()
+{
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+               std::chrono::system_clock::now().time_since_epoch())
+        .count();
+}
+
+void ChunkQueue::push(Chunk chunk)
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _bytes += chunk.data.size();
+        if (_bytes > _high_water)
+        {
+            _high_water = _bytes;
+        }
+        _chunks.push_back(std::move(chunk));
+    }
+    _cond.notify_one();
+}
+
+bool ChunkQueue::pop(Chunk &chunk)
+{
+    std::unique_lock<std::mutex> lock(_mutex);
+
+    _cond.wait(lock, [this] { return _closed || !_chunks.empty(); });
+    if (_chunks.empty())
+    {
+        return false;
+    }
+    chunk = std::move(_chunks.front());
+    _chunks.pop_front();
+    _bytes -= chunk.data.size();
+    return true;
+}
+
+void ChunkQueue::close()
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _closed = true;
+    }
+    _cond.notify_all();
+}
+
+size_t ChunkQueue::high_water() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _high_water;
+}
+
+Ingest::Ingest(int fd, ChunkQueue &queue)
+    : _fd(fd), _queue(queue), _thread(&Ingest::run, this)
+{
+}
+
+Ingest::~Ingest()
+{
+    stop();
+    if (_thread.joinable())
+    {
+        _thread.join();
+    }
+}
+
+void Ingest::stop()
+{
+    _stop = true;
+}
+
+uint64_t Ingest::bytes() const
+{
+    return _bytes;
+}
+
+void Ingest::run()
+{
+    struct pollfd pfd = {_fd, POLLIN, 0};
+
+    while (!_stop)
+    {
+        int ready = poll(&pfd, 1, POLL_TIMEOUT);
+        if ((0 > ready) && (EINTR != errno))
+        {
+            std::fprintf(stderr, "poll: %s\n", std::strerror(errno));
+            break;
+        }
+        if (0 >= ready)
+        {
+            continue;
+        }
+        Chunk chunk;
+        chunk.data.resize(READ_SIZE);
+        ssize_t n = read(_fd, chunk.data.data(), chunk.data.size());
+        if (0 > n)
+        {
+            if ((EINTR == errno) || (EAGAIN == errno))
+            {
+                continue;
+            }
+            std::fprintf(stderr, "read: %s\n", std::strerror(errno));
+            break;
+        }
+        if (0 == n)
+        {
+            break;
+        } // end of a capture file, or the port went away
+        chunk.time_ms = now_ms();
+        chunk.data.resize(static_cast<size_t>(n));
+        _bytes += static_cast<uint64_t>(n);
+        _queue.push(std::move(chunk));
+    }
+    _queue.close();
+}
+
+} // namespace ground
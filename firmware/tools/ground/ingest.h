@@ -0,0 +1,100 @@
+/**
+ * @file ingest.h
+ * @brief Reader thread of the serial port, decoupled from the decoding
+ */
+
+#ifndef VEMAR_GROUND_INGEST_H
+#define VEMAR_GROUND_INGEST_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace ground
+{
+
+/**
+ * @brief Bytes read at once, with the host time of the read
+ */
+struct Chunk
+{
+    int64_t time_ms = 0;
+    std::vector<uint8_t> data;
+};
+
+/**
+ * @brief Unbounded queue between the reader thread and the decoder
+ * @details The reader never waits on the decoder: a slow consumer (disk, HTTP
+ * clients) makes the queue grow instead of leaving bytes in the kernel buffer
+ * of the serial port, which overflows silently. The high-water mark tells how
+ * far behind the decoder got.
+ */
+class ChunkQueue
+{
+public:
+    void push(Chunk chunk);
+
+    /**
+     * @brief Wait for a chunk, or for the end of the input
+     * @return `false` once the queue is closed and empty
+     */
+    bool pop(Chunk &chunk);
+
+    /**
+     * @brief Mark the end of the input, `pop` drains what is left
+     */
+    void close();
+
+    size_t high_water() const;
+
+private:
+    std::deque<Chunk> _chunks;
+    size_t _bytes = 0;
+    size_t _high_water = 0; // in bytes
+    bool _closed = false;
+    mutable std::mutex _mutex;
+    std::condition_variable _cond;
+};
+
+/**
+ * @brief Thread reading a file descriptor into a `ChunkQueue`
+ */
+class Ingest
+{
+public:
+    Ingest(int fd, ChunkQueue &queue);
+    ~Ingest();
+
+    Ingest(const Ingest &) = delete;
+    Ingest &operator=(const Ingest &) = delete;
+
+    /**
+     * @brief Ask the thread to stop, the queue is closed when it does
+     */
+    void stop();
+
+    uint64_t bytes() const;
+
+private:
+    void run();
+
+    int _fd;
+    ChunkQueue &_queue;
+    std::atomic<bool> _stop{false};
+    std::atomic<uint64_t> _bytes{0};
+    std::thread _thread;
+};
+
+/**
+ * @brief Host time, Unix milliseconds
+ */
+int64_t now_ms();
+
+} // namespace ground
+
+#endif // VEMAR_GROUND_INGEST_H
@@ -0,0 +1,142 @@
+#include "logger.h"
+
+#include <cerrno>
+#include <cinttypes>
+#include <cstring>
+#include <ctime>
+#include <utility>
+
+#include <unistd.h>
+
+namespace ground
+{
+
+namespace
+{
+
+/**
+ * @brief COBS-encode a record and append the `0x00` delimiter
+ */
+void cobs_encode(const std::vector<uint8_t> &src, std::vector<uint8_t> &dst)
+{
+    size_t code_pos = 0;
+    uint8_t code = 1;
+
+    dst.assign(1, 0x00); // code byte, filled in once known
+    for (uint8_t byte : src)
+    {
+        if (0x00 != byte)
+        {
+            dst.push_back(byte);
+            ++code;
+        }
+        if ((0x00 == byte) || (0xFF == code))
+        {
+            dst[code_pos] = code;
+            code_pos = dst.size();
+            dst.push_back(0x00);
+            code = 1;
+        }
+    }
+    dst[code_pos] = code;
+    dst.push_back(0x00);
+}
+
+} // namespace
+
+Logger::Logger(std::string dir, size_t rotate_bytes, size_t keep)
+    : _dir(std::move(dir)), _rotate_bytes(rotate_bytes), _keep(keep)
+{
+}
+
+Logger::~Logger()
+{
+    close();
+}
+
+bool Logger::open()
+{
+    char stamp[32];
+    std::time_t now = std::time(nullptr);
+    struct tm tm;
+
+    localtime_r(&now, &tm);
+    std::strftime(stamp, sizeof(stamp), "%Y%m%d-%H%M%S", &tm);
+
+    std::string stem = _dir + "/ground-" + stamp + "-" +
+                       std::to_string(_index++);
+    _bin = std::fopen((stem + ".bin").c_str(), "wb");
+    _csv = std::fopen((stem + ".csv").c_str(), "w");
+    if ((nullptr == _bin) || (nullptr == _csv))
+    {
+        std::fprintf(stderr, "%s: %s\n", stem.c_str(), std::strerror(errno));
+        close();
+        return false;
+    }
+    std::fputc(0x00, _bin); // the reader skips up to the first delimiter
+    std::fprintf(_csv, "time_ms,module,field,value\n");
+    _written = 1;
+    _stems.push_back(stem);
+    while ((0 != _keep) && (_stems.size() > _keep))
+    {
+        unlink((_stems.front() + ".bin").c_str());
+        unlink((_stems.front() + ".csv").c_str());
+        _stems.pop_front();
+    }
+    return true;
+}
+
+void Logger::close()
+{
+    if (nullptr != _bin)
+    {
+        std::fclose(_bin);
+        _bin = nullptr;
+    }
+    if (nullptr != _csv)
+    {
+        std::fclose(_csv);
+        _csv = nullptr;
+    }
+}
+
+bool Logger::write(const std::vector<uint8_t> &record, const Module *module,
+                   const Sample &sample)
+{
+    if ((nullptr != _bin) && (_written >= _rotate_bytes))
+    {
+        close();
+    }
+    if ((nullptr == _bin) && !open())
+    {
+        return false;
+    }
+    cobs_encode(record, _frame);
+    if (_frame.size() != std::fwrite(_frame.data(), 1, _frame.size(), _bin))
+    {
+        std::fprintf(stderr, "log: %s\n", std::strerror(errno));
+        return false;
+    }
+    _written += _frame.size();
+    if (nullptr == module)
+    {
+        return true;
+    }
+    for (size_t i = 0; i < module->count; ++i)
+    {
+        std::fprintf(_csv, "%" PRId64 ",%s,%s,%" PRId64 "\n", sample.time_ms,
+                     module->name, module->fields[i], sample.value[i]);
+    }
+    return true;
+}
+
+void Logger::flush()
+{
+    if (nullptr != _bin)
+    {
+        std::fflush(_bin);
+        std::fflush(_csv);
+    }
+}
+
+} // namespace ground
@@ -0,0 +1,77 @@
+/**
+ * @file logger.h
+ * @brief Rotating logs of the telemetry: raw capture and CSV
+ */
+
+#ifndef VEMAR_GROUND_LOGGER_H
+#define VEMAR_GROUND_LOGGER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <string>
+#include <vector>
+
+#include "telemetry.h"
+
+namespace ground
+{
+
+/**
+ * @brief Write every record to a pair of rotating files
+ * @details
+ * - `<stem>.bin` holds the checked records, framed again, so it replays with
+ *   `trace_decode` or `ground` as any capture file.
+ * - `<stem>.csv` holds one `time_ms,module,field,value` line per field.
+ *
+ * A new pair is started once the binary file reaches the rotation size, and
+ * only the newest pairs are kept.
+ */
+class Logger
+{
+public:
+    /**
+     * @param dir Directory of the logs, must exist
+     * @param rotate_bytes Size of a binary file before rotation
+     * @param keep Number of pairs kept, `0` keeps them all
+     */
+    Logger(std::string dir, size_t rotate_bytes, size_t keep);
+    ~Logger();
+
+    Logger(const Logger &) = delete;
+    Logger &operator=(const Logger &) = delete;
+
+    /**
+     * @brief Log a record, and its fields if it is a module packet
+     * @param record Checked record, `id seq payload crc`
+     * @param module Decoded module, `nullptr` for any other record
+     * @param sample Decoded values
+     * @return `false` on a write error (reported on stderr)
+     */
+    bool write(const std::vector<uint8_t> &record, const Module *module,
+               const Sample &sample);
+
+    /**
+     * @brief Push the buffered lines to the disk
+     */
+    void flush();
+
+private:
+    bool open();
+    void close();
+
+    std::string _dir;
+    size_t _rotate_bytes;
+    size_t _keep;
+    unsigned _index = 0;
+    size_t _written = 0;
+    FILE *_bin = nullptr;
+    FILE *_csv = nullptr;
+    std::deque<std::string> _stems; // oldest first
+    std::vector<uint8_t> _frame;
+};
+
+} // namespace ground
+
+#endif // VEMAR_GROUND_LOGGER_H
@@ -0,0 +1,225 @@
+/**
+ * @file main.cpp
+ * @brief Ground station: live telemetry of the controller on the host
+ * @details
+ * Reads the trace stream of a controller built with `make TELEMETRY=1`, keeps
+ * the latest samples of each module, logs every record and serves a local
+ * HTTP view. A capture file replays as a live stream.
+ *
+ * Usage: ground [-b baudrate] [-l dir] [-r MiB] [-k keep] [-p port]
+ *               [-n samples] [device|file|-]
+ */
+
+#include <atomic>
+#include <cinttypes>
+#include <csignal>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+
+#include "http.h"
+#include "ingest.h"
+#include "logger.h"
+#include "serial_port.h"
+#include "telemetry.h"
+#include "trace_frame.h"
+
+namespace
+{
+
+constexpr int64_t FLUSH_PERIOD = 1000; // ms between two flushes of the logs
+
+std::atomic<bool> g_interrupted{false};
+ground::Ingest *g_ingest = nullptr;
+
+void on_signal(int)
+{
+    g_interrupted = true;
+    if (nullptr != g_ingest)
+    {
+        g_ingest->stop();
+    }
+}
+
+void usage(const char *name)
+{
+    std::fprintf(stderr,
+                 "usage: %s [-b baudrate] [-l dir] [-r MiB] [-k keep] "
+                 "[-p port] [-n samples] [device|file|-]\n"
+                 "  -b  baud rate of a serial port (115200)\n"
+                 "  -l  directory of the logs, none if not given\n"
+                 "  -r  size of a binary log before rotation (16 MiB)\n"
+                 "  -k  number of logs kept, 0 for all (8)\n"
+                 "  -p  HTTP port on 127.0.0.1, 0 for none (8080)\n"
+                 "  -n  samples kept per module for the HTTP view (3600)\n",
+                 name);
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    long baudrate = 115200;
+    std::string log_dir;
+    long rotate_mib = 16;
+    long keep = 8;
+    long port = 8080;
+    long history = 3600;
+    int opt;
+
+    while (-1 != (opt = getopt(argc, argv, "b:l:r:k:p:n:")))
+    {
+        switch (opt)
+        {
+        case 'b':
+            baudrate = std::strtol(optarg, nullptr, 10);
+            break;
+        case 'l':
+            log_dir = optarg;
+            break;
+        case 'r':
+            rotate_mib = std::strtol(optarg, nullptr, 10);
+            break;
+        case 'k':
+            keep = std::strtol(optarg, nullptr, 10);
+            break;
+        case 'p':
+            port = std::strtol(optarg, nullptr, 10);
+            break;
+        case 'n':
+            history = std::strtol(optarg, nullptr, 10);
+            break;
+        default:
+            usage(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+    if ((0 >= rotate_mib) || (0 > keep) || (0 > port) || (0xFFFF < port) ||
+        (0 >= history))
+    {
+        usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+    int fd = trace::open_input((optind < argc) ? argv[optind] : "-", baudrate);
+    if (0 > fd)
+    {
+        return EXIT_FAILURE;
+    }
+
+    ground::Store store(static_cast<size_t>(history));
+    std::unique_ptr<ground::Logger> logger;
+    std::unique_ptr<ground::HttpServer> server;
+
+    if (!log_dir.empty())
+    {
+        logger = std::make_unique<ground::Logger>(
+            log_dir, static_cast<size_t>(rotate_mib) << 20,
+            static_cast<size_t>(keep));
+    }
+    if (0 != port)
+    {
+        server = std::make_unique<ground::HttpServer>(
+            store, static_cast<uint16_t>(port));
+        if (!server->start())
+        {
+            return EXIT_FAILURE;
+        }
+        std::fprintf(stderr, "http://127.0.0.1:%ld/\n", port);
+    }
+
+    ground::ChunkQueue queue;
+    ground::Ingest ingest(fd, queue);
+    struct sigaction action = {};
+
+    g_ingest = &ingest;
+    action.sa_handler = on_signal;
+    sigaction(SIGINT, &action, nullptr);
+    sigaction(SIGTERM, &action, nullptr);
+
+    trace::FrameReader reader;
+    ground::Chunk chunk;
+    uint64_t seq = 0;
+    std::vector<unsigned long> counts(256, 0);
+    int64_t start = ground::now_ms();
+    int64_t flushed = start;
+    bool log_ok = true;
+
+    while (queue.pop(chunk))
+    {
+        reader.feed(chunk.data.data(), chunk.data.size(),
+                    [&](const std::vector<uint8_t> &record) {
+                        ground::Sample sample;
+                        const ground::Module *module = nullptr;
+
+                        if (TRACE_ID_MODULE == record[0])
+                        {
+                            module = ground::decode_packet(
+                                record.data() + TRACE_HEADER_SIZE,
+                                record.size() - TRACE_HEADER_SIZE -
+                                    TRACE_CRC_SIZE,
+                                sample);
+                        }
+                        if (nullptr != module)
+                        {
+                            sample.seq = ++seq;
+                            sample.time_ms = chunk.time_ms;
+                            ++counts[module->id];
+                        }
+                        if (logger && log_ok)
+                        {
+                            log_ok = logger->write(record, module, sample);
+                        }
+                        if (nullptr != module)
+                        {
+                            store.push(*module, sample);
+                        }
+                    });
+        if (logger && (FLUSH_PERIOD <= chunk.time_ms - flushed))
+        {
+            logger->flush();
+            flushed = chunk.time_ms;
+        }
+    }
+    int64_t elapsed = ground::now_ms() - start;
+    if (server)
+    {
+        if (!g_interrupted)
+        {
+            std::fprintf(stderr, "end of input, serving until interrupted\n");
+        }
+        while (!g_interrupted)
+        {
+            usleep(100000);
+        }
+        server->stop();
+    }
+    logger.reset();
+
+    const trace::Stats &stats = reader.stats();
+    std::fprintf(stderr,
+                 "%lu records, %lu lost, %lu crc errors, %lu framing errors\n",
+                 stats.records, stats.lost, stats.crc_errors,
+                 stats.framing_errors);
+    for (const ground::Module *module : ground::modules())
+    {
+        if (0 != counts[module->id])
+        {
+            std::fprintf(stderr, "  %-10s %lu samples\n", module->name,
+                         counts[module->id]);
+        }
+    }
+    std::fprintf(stderr,
+                 "%" PRIu64 " bytes in %" PRId64 " ms, queue peak %zu bytes\n",
+                 ingest.bytes(), elapsed, queue.high_water());
+    g_ingest = nullptr;
+    if (STDIN_FILENO != fd)
+    {
+        close(fd);
+    }
+    return log_ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
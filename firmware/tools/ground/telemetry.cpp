@@ -0,0 +1,249 @@
+#include "telemetry.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cinttypes>
+#include <cstdio>
+
+extern "C" {
+#include <util/packet.h>
+}
+
+#include "trace_frame.h"
+
+namespace ground
+{
+
+namespace
+{
+
+// values are sent raw: tenths of a unit for the atmosphere, ADC counts for
+// the gas sensors except CO2, counts for the Geiger counter
+const Module CAR = {PACKET_ID_CAR, "car", 1, {"modules"}};
+const Module ATMOSPHERE = {PACKET_ID_ATM, "atmosphere", 3,
+                           {"temperature", "humidity", "pressure"}};
+const Module GAS = {PACKET_ID_GAS, "gas", 7,
+                    {"co2", "co", "nh3", "no2", "o2", "temperature",
+                     "status"}};
+const Module LIDAR = {PACKET_ID_LIDAR, "lidar", 2, {"first_row", "cells"}};
+const Module GEIGER = {PACKET_ID_GMC, "geiger", 3, {"total", "delta", "cpm"}};
+const Module LINK = {PACKET_ID_LINK, "link", 1, {"profile"}};
+
+const std::vector<const Module *> MODULES = {&CAR, &ATMOSPHERE, &GAS, &LIDAR,
+                                             &GEIGER, &LINK};
+
+using trace::u16;
+
+int popcount(uint8_t byte)
+{
+    int count = 0;
+
+    for (; 0 != byte; byte &= static_cast<uint8_t>(byte - 1))
+    {
+        ++count;
+    }
+    return count;
+}
+
+} // namespace
+
+const std::vector<const Module *> &modules()
+{
+    return MODULES;
+}
+
+const Module *decode_packet(const uint8_t *p, size_t len, Sample &sample)
+{
+    if (PACKET_SIZE > len)
+    {
+        return nullptr;
+    }
+    // byte offsets of the packed AVR layout of packet_t
+    switch (p[0])
+    {
+    case PACKET_ID_CAR:
+        sample.value[0] = p[1];
+        return &CAR;
+    case PACKET_ID_ATM:
+        sample.value[0] = u16(p + 1);
+        sample.value[1] = u16(p + 3);
+        sample.value[2] = u16(p + 5);
+        return &ATMOSPHERE;
+    case PACKET_ID_GAS:
+        for (size_t i = 0; i < 5; ++i)
+        {
+            sample.value[i] = u16(p + 3 + 2 * i);
+        }
+        sample.value[5] = static_cast<int8_t>(p[13]) - CO2_TEMP_OFFSET;
+        sample.value[6] = p[14];
+        return &GAS;
+    case PACKET_ID_LIDAR:
+    {
+        int cells = 0;
+
+        for (size_t line = 0; line < LIDAR_DATA_PER_PACKET; ++line)
+        {
+            const uint8_t *data = p + 1 + line * sizeof(lidar_data_t);
+            for (size_t col = 0; col < LIDAR_DATA_PER_LINE; ++col)
+            {
+                cells += popcount(data[1 + col]);
+            }
+        }
+        sample.value[0] = p[1];
+        sample.value[1] = cells;
+        return &LIDAR;
+    }
+    case PACKET_ID_GMC:
+        sample.value[0] = u16(p + 1);
+        sample.value[1] = u16(p + 3);
+        sample.value[2] = u16(p + 5);
+        return &GEIGER;
+    case PACKET_ID_LINK:
+        sample.value[0] = p[1];
+        return &LINK;
+    default:
+        return nullptr;
+    }
+}
+
+Store::Store(size_t capacity) : _capacity(capacity), _series(256)
+{
+    for (const Module *module : MODULES)
+    {
+        _series[module->id].module = module;
+    }
+}
+
+void Store::push(const Module &module, Sample sample)
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        std::deque<Sample> &samples = _series[module.id].samples;
+
+        _last_seq = sample.seq;
+        samples.push_back(sample);
+        if (samples.size() > _capacity)
+        {
+            samples.pop_front();
+        }
+    }
+    _cond.notify_all();
+}
+
+uint64_t Store::last_seq() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _last_seq;
+}
+
+bool Store::wait(uint64_t seq, int timeout_ms) const
+{
+    std::unique_lock<std::mutex> lock(_mutex);
+    return _cond.wait_for(lock, std::chrono::milliseconds(timeout_ms),
+                          [this, seq] { return _last_seq > seq; });
+}
+
+void Store::sample_json(std::string &out, const Module &module,
+                        const Sample &sample)
+{
+    char buf[64];
+
+    std::snprintf(buf, sizeof(buf),
+                  "{\"module\":\"%s\",\"seq\":%" PRIu64 ",\"time\":%" PRId64,
+                  module.name, sample.seq, sample.time_ms);
+    out += buf;
+    for (size_t i = 0; i < module.count; ++i)
+    {
+        std::snprintf(buf, sizeof(buf), ",\"%s\":%" PRId64, module.fields[i],
+                      sample.value[i]);
+        out += buf;
+    }
+    out += '}';
+}
+
+std::string Store::latest_json() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    std::string out = "{";
+    bool first = true;
+
+    for (const Series &series : _series)
+    {
+        if (series.samples.empty())
+        {
+            continue;
+        }
+        if (!first)
+        {
+            out += ',';
+        }
+        first = false;
+        out += '"';
+        out += series.module->name;
+        out += "\":";
+        sample_json(out, *series.module, series.samples.back());
+    }
+    out += '}';
+    return out;
+}
+
+std::string Store::series_json(uint8_t id, int64_t since_ms) const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    const Series &series = _series[id];
+    std::string out = "[";
+    bool first = true;
+
+    if (nullptr == series.module)
+    {
+        return "[]";
+    }
+    for (const Sample &sample : series.samples)
+    {
+        if (sample.time_ms <= since_ms)
+        {
+            continue;
+        }
+        if (!first)
+        {
+            out += ',';
+        }
+        first = false;
+        sample_json(out, *series.module, sample);
+    }
+    out += ']';
+    return out;
+}
+
+std::string Store::events_json(uint64_t &seq, size_t max) const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    std::vector<std::pair<const Module *, const Sample *>> pending;
+    std::string out;
+
+    for (const Series &series : _series)
+    {
+        for (auto it = series.samples.rbegin();
+             (series.samples.rend() != it) && (it->seq > seq); ++it)
+        {
+            pending.emplace_back(series.module, &*it);
+        }
+    } // newest first in each series, the older ones are gone anyway
+    std::sort(pending.begin(), pending.end(),
+              [](const auto &a, const auto &b) {
+                  return a.second->seq < b.second->seq;
+              });
+    if (pending.size() > max)
+    {
+        pending.erase(pending.begin(), pending.end() - max);
+    } // a slow client gets the newest samples
+    for (const auto &item : pending)
+    {
+        sample_json(out, *item.first, *item.second);
+        out += '\n';
+        seq = item.second->seq;
+    }
+    return out;
+}
+
+} // namespace ground
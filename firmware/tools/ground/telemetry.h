@@ -0,0 +1,121 @@
+/**
+ * @file telemetry.h
+ * @brief Module packets decoded into samples, and their time series
+ */
+
+#ifndef VEMAR_GROUND_TELEMETRY_H
+#define VEMAR_GROUND_TELEMETRY_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace ground
+{
+
+constexpr size_t FIELD_MAX = 8; /**< Largest number of fields of a module */
+
+/**
+ * @brief Layout of the samples of a module
+ */
+struct Module
+{
+    uint8_t id;                      /**< Packet ID, see `util/packet.h` */
+    const char *name;                /**< Name used in the logs and the API */
+    size_t count;                    /**< Number of fields */
+    const char *fields[FIELD_MAX];   /**< Field names */
+};
+
+/**
+ * @brief Values of one packet
+ */
+struct Sample
+{
+    uint64_t seq = 0;             /**< Position in the whole stream */
+    int64_t time_ms = 0;          /**< Host time of reception, Unix ms */
+    int64_t value[FIELD_MAX] = {}; /**< Raw values, in the module units */
+};
+
+/**
+ * @brief Decode a packet forwarded by the controller
+ * @param packet Packet bytes, packed AVR layout
+ * @param len Number of bytes
+ * @param sample Values, `seq` and `time_ms` are left to the caller
+ * @return Module of the packet, `nullptr` if unknown or too short
+ */
+const Module *decode_packet(const uint8_t *packet, size_t len, Sample &sample);
+
+/**
+ * @brief Every known module, for the listings
+ */
+const std::vector<const Module *> &modules();
+
+/**
+ * @brief Latest samples of every module, shared by the ingest and the server
+ * @details Each module keeps a bounded history. The oldest samples are
+ * forgotten here only: the logs keep everything.
+ */
+class Store
+{
+public:
+    explicit Store(size_t capacity);
+
+    /**
+     * @brief Add a sample and wake up the waiting readers
+     */
+    void push(const Module &module, Sample sample);
+
+    /**
+     * @brief Sequence number of the last sample, `0` before the first one
+     */
+    uint64_t last_seq() const;
+
+    /**
+     * @brief Wait for a sample newer than `seq`
+     * @return `true` if one arrived before the timeout
+     */
+    bool wait(uint64_t seq, int timeout_ms) const;
+
+    /**
+     * @brief JSON object with the latest sample of each module
+     */
+    std::string latest_json() const;
+
+    /**
+     * @brief JSON array of the samples of a module, oldest first
+     * @param id Packet ID of the module
+     * @param since_ms Only the samples received after this time
+     */
+    std::string series_json(uint8_t id, int64_t since_ms) const;
+
+    /**
+     * @brief JSON objects of the samples newer than `seq`, one per line
+     * @param seq Last sequence number already sent, updated
+     * @param max Largest number of samples returned
+     */
+    std::string events_json(uint64_t &seq, size_t max) const;
+
+private:
+    struct Series
+    {
+        const Module *module = nullptr;
+        std::deque<Sample> samples;
+    };
+
+    static void sample_json(std::string &out, const Module &module,
+                            const Sample &sample);
+
+    size_t _capacity;
+    std::vector<Series> _series; // indexed by packet ID
+    uint64_t _last_seq = 0;
+    mutable std::mutex _mutex;
+    mutable std::condition_variable _cond;
+};
+
+} // namespace ground
+
+#endif // VEMAR_GROUND_TELEMETRY_H
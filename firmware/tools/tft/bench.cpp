@@ -0,0 +1,310 @@
+/**
+ * @file bench.cpp
+ * @brief Render benchmark of the controller screens on the ILI9341 model
+ * @details
+ * Runs the controller firmware built for the host, feeds it the radio packets
+ * and button presses of a script, and reports the display traffic of each
+ * operation of the script. Each script runs in its own process, from reset.
+ *
+ * Usage: tft_bench [-c] [-o dir] script...
+ */
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "host.h"
+#include "panel.h"
+
+namespace
+{
+
+constexpr unsigned PRESS_MS = 30;     // longer than the UI task period
+constexpr double SPI_CLOCK = 8e6;     // F_CPU / 2, the display prescaler
+
+tft::Panel g_panel;
+
+/**
+ * @brief Print one row per operation, as text or CSV
+ */
+class Report
+{
+public:
+    Report(bool csv, std::string script) : _csv(csv), _script(std::move(script))
+    {
+    }
+
+    static void header(bool csv)
+    {
+        if (csv)
+        {
+            std::printf("script,op,bytes,commands,caset,paset,ramwr,pixels,"
+                        "unchanged,wire_ms,frame\n");
+        }
+        else
+        {
+            std::printf("%-12s %-14s %8s %6s %5s %5s %5s %7s %7s %8s %8s\n",
+                        "script", "op", "bytes", "cmds", "caset", "paset",
+                        "ramwr", "pixels", "same", "wire_ms", "frame");
+        }
+    }
+
+    void begin(const std::string &op)
+    {
+        end();
+        _op = op;
+        _start = g_panel.counters();
+    }
+
+    void end()
+    {
+        if (_op.empty())
+        {
+            return;
+        }
+        tft::Counters c = g_panel.counters() - _start;
+        double wire_ms = c.bytes * 8.0 / SPI_CLOCK * 1e3;
+
+        if (_csv)
+        {
+            std::printf("%s,%s,%lu,%lu,%lu,%lu,%lu,%lu,%lu,%.3f,%08x\n",
+                        _script.c_str(), _op.c_str(), c.bytes, c.commands,
+                        c.caset, c.paset, c.ramwr, c.pixels, c.unchanged,
+                        wire_ms, g_panel.hash());
+        }
+        else
+        {
+            std::printf("%-12s %-14s %8lu %6lu %5lu %5lu %5lu %7lu %7lu "
+                        "%8.3f %08x\n",
+                        _script.c_str(), _op.c_str(), c.bytes, c.commands,
+                        c.caset, c.paset, c.ramwr, c.pixels, c.unchanged,
+                        wire_ms, g_panel.hash());
+        }
+        std::fflush(stdout);
+        _op.clear();
+    }
+
+private:
+    bool _csv;
+    std::string _script;
+    std::string _op;
+    tft::Counters _start;
+};
+
+void run(unsigned ms)
+{
+    for (unsigned i = 0; i < ms; ++i)
+    {
+        TIMER2_COMPA_vect();
+        loop();
+    }
+}
+
+void put16(std::vector<uint8_t> &packet, long value)
+{
+    packet.push_back(static_cast<uint8_t>(value & 0xFF));
+    packet.push_back(static_cast<uint8_t>((value >> 8) & 0xFF));
+}
+
+/**
+ * @brief Build a module packet from its fields, see `util/packet.h`
+ * @return `false` if the module is unknown
+ */
+bool packet(const std::string &module, std::istringstream &args,
+            std::vector<uint8_t> &out)
+{
+    std::vector<long> v;
+    long value;
+
+    while (args >> value)
+    {
+        v.push_back(value);
+    }
+    v.resize(8, 0);
+    if ("car" == module)
+    {
+        out = {0x01, static_cast<uint8_t>(v[0])};
+    }
+    else if ("atm" == module)
+    {
+        out = {0x02};
+        for (int i = 0; i < 3; ++i)
+        {
+            put16(out, v[i]);
+        }
+    }
+    else if ("gas" == module)
+    {
+        out = {0x03, 0x00, 0x00}; // header
+        for (int i = 0; i < 5; ++i)
+        {
+            put16(out, v[i]);
+        }
+        out.push_back(static_cast<uint8_t>(v[5]));
+        out.push_back(static_cast<uint8_t>(v[6]));
+    }
+    else if ("gmc" == module)
+    {
+        out = {0x05};
+        for (int i = 0; i < 3; ++i)
+        {
+            put16(out, v[i]);
+        }
+    }
+    else
+    {
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Run a script, see README.md for the commands
+ * @return `false` on error (reported on stderr)
+ */
+bool script(const std::string &path, const std::string &out_dir, bool csv)
+{
+    std::ifstream in(path);
+    std::string name = path.substr(path.find_last_of('/') + 1);
+    std::string line;
+    unsigned number = 0;
+
+    if (!in)
+    {
+        std::fprintf(stderr, "%s: cannot open\n", path.c_str());
+        return false;
+    }
+    name = name.substr(0, name.find('.'));
+    Report report(csv, name);
+
+    HOST_panel_attach();
+    HOST_inputs_release();
+
+    while (std::getline(in, line))
+    {
+        std::istringstream args(line.substr(0, line.find('#')));
+        std::string cmd;
+
+        ++number;
+        if (!(args >> cmd))
+        {
+            continue;
+        }
+        if ("op" == cmd)
+        {
+            std::string op;
+            args >> op;
+            report.begin(op);
+        }
+        else if ("boot" == cmd)
+        {
+            setup();
+        }
+        else if ("run" == cmd)
+        {
+            unsigned ms = 0;
+            args >> ms;
+            run(ms);
+        }
+        else if ("press" == cmd)
+        {
+            HOST_button1(1);
+            run(PRESS_MS);
+            HOST_button1(0);
+        }
+        else if ("rx" == cmd)
+        {
+            std::vector<uint8_t> bytes;
+            std::string module;
+            unsigned byte;
+
+            args >> module;
+            if (!packet(module, args, bytes))
+            {
+                std::istringstream hex(line.substr(line.find("rx") + 2));
+                while (hex >> std::hex >> byte)
+                {
+                    bytes.push_back(static_cast<uint8_t>(byte));
+                }
+            } // raw bytes, in hexadecimal
+            HOST_radio_push(bytes.data(), bytes.size());
+        }
+        else if ("snap" == cmd)
+        {
+            std::string file;
+            args >> file;
+            if (!g_panel.save(out_dir + "/" + file))
+            {
+                return false;
+            }
+        }
+        else
+        {
+            std::fprintf(stderr, "%s:%u: unknown command '%s'\n",
+                         path.c_str(), number, cmd.c_str());
+            return false;
+        }
+    }
+    report.end();
+    return true;
+}
+
+} // namespace
+
+extern "C" void HOST_panel_write(uint8_t data, int selected, int command)
+{
+    g_panel.write(data, 0 != selected, 0 != command);
+}
+
+int main(int argc, char **argv)
+{
+    std::string out_dir = ".";
+    bool csv = false;
+    bool ok = true;
+    int opt;
+
+    while (-1 != (opt = getopt(argc, argv, "co:")))
+    {
+        switch (opt)
+        {
+        case 'c':
+            csv = true;
+            break;
+        case 'o':
+            out_dir = optarg;
+            break;
+        default:
+            std::fprintf(stderr, "usage: %s [-c] [-o dir] script...\n",
+                         argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+    Report::header(csv);
+    std::fflush(stdout);
+    for (int i = optind; i < argc; ++i)
+    {
+        int status = 0;
+        pid_t pid = fork();
+
+        if (0 == pid)
+        {
+            std::_Exit(script(argv[i], out_dir, csv) ? EXIT_SUCCESS
+                                                      : EXIT_FAILURE);
+        } // the firmware state is global: a fresh process per script
+        if ((0 > pid) || (0 > waitpid(pid, &status, 0)) ||
+            !WIFEXITED(status) || (EXIT_SUCCESS != WEXITSTATUS(status)))
+        {
+            ok = false;
+        }
+    }
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
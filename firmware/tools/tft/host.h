@@ -0,0 +1,62 @@
+/**
+ * @file host.h
+ * @brief Glue between the firmware built for the host and the bench
+ * @details Plain C types only, shared by the C stand-ins and the C++ bench.
+ */
+
+#ifndef VEMAR_TFT_HOST_H
+#define VEMAR_TFT_HOST_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//------------------------------------------------------------------------------
+// Bench side, called by the stand-ins
+//------------------------------------------------------------------------------
+
+/**
+ * @brief Byte shifted out on the SPI bus
+ * @param data Byte
+ * @param selected Chip Select of the display is LOW
+ * @param command Data/Command of the display is LOW
+ */
+void HOST_panel_write(uint8_t data, int selected, int command);
+
+/**
+ * @brief Connect the display to the SPI bus of the register file
+ */
+void HOST_panel_attach(void);
+
+//------------------------------------------------------------------------------
+// Firmware side, called by the bench
+//------------------------------------------------------------------------------
+
+/**
+ * @brief Queue a packet for `RADIO_read`
+ */
+void HOST_radio_push(const uint8_t *packet, size_t len);
+
+/**
+ * @brief Release the buttons and the toggle: inputs pulled up
+ */
+void HOST_inputs_release(void);
+
+/**
+ * @brief Press or release button 1, raising its pin change interrupt
+ */
+void HOST_button1(int pressed);
+
+void setup(void);
+void loop(void);
+
+void TIMER2_COMPA_vect(void); /**< System tick, one millisecond */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // VEMAR_TFT_HOST_H
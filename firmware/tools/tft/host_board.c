@@ -0,0 +1,30 @@
+#include "controller.h"
+#include "host.h"
+
+#define _HOST_release(pin) \
+    BIT_set(_PIN_REG_PIN(pin), _PIN_MASK(pin))
+
+void PCINT1_vect(void);
+
+void HOST_inputs_release(void)
+{
+    _HOST_release(PIN_BUTTON1);
+    _HOST_release(PIN_BUTTON2);
+    _HOST_release(PIN_JOY_RB);
+    _HOST_release(PIN_JOY_LB);
+    _HOST_release(PIN_TOGGLE_UP);
+    _HOST_release(PIN_TOGGLE_DOWN);
+}
+
+void HOST_button1(int pressed)
+{
+    if (pressed)
+    {
+        BIT_clear(_PIN_REG_PIN(PIN_BUTTON1), _PIN_MASK(PIN_BUTTON1));
+    }
+    else
+    {
+        _HOST_release(PIN_BUTTON1);
+    }
+    PCINT1_vect();
+}
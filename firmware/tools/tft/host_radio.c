@@ -0,0 +1,98 @@
+#include <string.h>
+
+#include <radio.h>
+#include <sram.h>
+#include <util/packet.h>
+
+#include "host.h"
+
+#define _HOST_RADIO_QUEUE 32 /**< Packets waiting for `RADIO_read` */
+
+static byte_t g_host_queue[_HOST_RADIO_QUEUE][PACKET_SIZE];
+static length_t g_host_head;
+static length_t g_host_count;
+static radio_link_t g_host_link = RADIO_LINK_DEFAULT;
+
+//------------------------------------------------------------------------------
+// Bench
+//------------------------------------------------------------------------------
+
+void HOST_radio_push(const uint8_t *packet, size_t len)
+{
+    byte_t *slot;
+
+    if (_HOST_RADIO_QUEUE == g_host_count)
+    {
+        return;
+    } // the car retries, the bench just loses it
+    slot = g_host_queue[(g_host_head + g_host_count) % _HOST_RADIO_QUEUE];
+    memset(slot, 0, PACKET_SIZE);
+    memcpy(slot, packet, (PACKET_SIZE < len) ? PACKET_SIZE : len);
+    ++g_host_count;
+}
+
+//------------------------------------------------------------------------------
+// Radio: every write is acknowledged, reads come from the bench
+//------------------------------------------------------------------------------
+
+void RADIO_init(pin_t ce, pin_t csn)
+{
+    (void)ce;
+    (void)csn;
+    g_host_link = RADIO_LINK_DEFAULT;
+}
+
+bool_t RADIO_read(byte_t *buffer, length_t len)
+{
+    if (0 == g_host_count)
+    {
+        return (FALSE);
+    }
+    memcpy(buffer, g_host_queue[g_host_head],
+           (PACKET_SIZE < len) ? PACKET_SIZE : len);
+    g_host_head = (g_host_head + 1) % _HOST_RADIO_QUEUE;
+    --g_host_count;
+    return (TRUE);
+}
+
+bool_t RADIO_write(const byte_t *buffer, length_t len)
+{
+    (void)buffer;
+    (void)len;
+    return (TRUE);
+}
+
+bool_t RADIO_resend(void)
+{
+    return (TRUE);
+}
+
+bool_t RADIO_can_resend(void)
+{
+    return (FALSE);
+}
+
+void RADIO_set_link(radio_link_t link)
+{
+    g_host_link = link;
+}
+
+radio_link_t RADIO_get_link(void)
+{
+    return (g_host_link);
+}
+
+radio_link_t RADIO_evaluate_link(void)
+{
+    return (g_host_link);
+}
+
+//------------------------------------------------------------------------------
+// SRAM: the host stack is not the target's
+//------------------------------------------------------------------------------
+
+bool_t SRAM_check(uint16_t margin)
+{
+    (void)margin;
+    return (TRUE);
+}
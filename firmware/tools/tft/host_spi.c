@@ -0,0 +1,20 @@
+#include <host_io.h>
+
+#include "controller.h"
+#include "host.h"
+
+// the display is the only device on the host bus: Chip Select and
+// Data/Command are read back from the register file, however they were driven
+#define _HOST_cs() BIT_is_clear(_PIN_REG_PORT(PIN_TFT_CS), _PIN_MASK(PIN_TFT_CS))
+#define _HOST_dc() BIT_is_clear(_PIN_REG_PORT(PIN_TFT_DC), _PIN_MASK(PIN_TFT_DC))
+
+static uint8_t _HOST_exchange(uint8_t data)
+{
+    HOST_panel_write(data, _HOST_cs(), _HOST_dc());
+    return (0xFF); // nothing is read back from the display
+}
+
+void HOST_panel_attach(void)
+{
+    HOST_spi_hook(_HOST_exchange);
+}
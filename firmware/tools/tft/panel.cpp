@@ -0,0 +1,354 @@
+#include "panel.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <utility>
+
+namespace tft
+{
+
+namespace
+{
+
+constexpr uint8_t CMD_SWRESET = 0x01;
+constexpr uint8_t CMD_CASET = 0x2A;
+constexpr uint8_t CMD_PASET = 0x2B;
+constexpr uint8_t CMD_RAMWR = 0x2C;
+constexpr uint8_t CMD_MADCTL = 0x36;
+
+constexpr uint8_t MADCTL_MY = 0x80; // page address order
+constexpr uint8_t MADCTL_MX = 0x40; // column address order
+constexpr uint8_t MADCTL_MV = 0x20; // page/column exchange
+
+void rgb888(uint16_t color, uint8_t *rgb)
+{
+    uint8_t r = (color >> 11) & 0x1F;
+    uint8_t g = (color >> 5) & 0x3F;
+    uint8_t b = color & 0x1F;
+
+    rgb[0] = static_cast<uint8_t>((r << 3) | (r >> 2));
+    rgb[1] = static_cast<uint8_t>((g << 2) | (g >> 4));
+    rgb[2] = static_cast<uint8_t>((b << 3) | (b >> 2));
+}
+
+uint32_t crc32(uint32_t crc, const uint8_t *data, size_t len)
+{
+    crc = ~crc;
+    while (0 != len--)
+    {
+        crc ^= *data++;
+        for (int i = 0; i < 8; ++i)
+        {
+            crc = (crc >> 1) ^ (0xEDB88320U & (0U - (crc & 1U)));
+        }
+    }
+    return ~crc;
+}
+
+void put32(std::vector<uint8_t> &out, uint32_t value)
+{
+    for (int shift = 24; 0 <= shift; shift -= 8)
+    {
+        out.push_back(static_cast<uint8_t>(value >> shift));
+    }
+}
+
+void chunk(std::vector<uint8_t> &out, const char *type,
+           const std::vector<uint8_t> &data)
+{
+    size_t start;
+
+    put32(out, static_cast<uint32_t>(data.size()));
+    start = out.size();
+    out.insert(out.end(), type, type + 4);
+    out.insert(out.end(), data.begin(), data.end());
+    put32(out, crc32(0, out.data() + start, out.size() - start));
+}
+
+/**
+ * @brief PNG with stored (uncompressed) deflate blocks, no zlib needed
+ */
+std::vector<uint8_t> png(unsigned w, unsigned h,
+                         const std::vector<uint8_t> &rgb)
+{
+    static const uint8_t SIGNATURE[] = {0x89, 'P', 'N', 'G', '\r', '\n',
+                                        0x1A, '\n'};
+    std::vector<uint8_t> out(SIGNATURE, SIGNATURE + sizeof(SIGNATURE));
+    std::vector<uint8_t> header;
+    std::vector<uint8_t> raw;
+    std::vector<uint8_t> zlib = {0x78, 0x01};
+    uint32_t a = 1;
+    uint32_t b = 0;
+
+    put32(header, w);
+    put32(header, h);
+    header.insert(header.end(), {8, 2, 0, 0, 0}); // 8-bit RGB
+    chunk(out, "IHDR", header);
+
+    for (unsigned y = 0; y < h; ++y)
+    {
+        raw.push_back(0); // no filter
+        raw.insert(raw.end(), rgb.begin() + y * w * 3,
+                   rgb.begin() + (y + 1) * w * 3);
+    }
+    for (size_t pos = 0; pos < raw.size();)
+    {
+        size_t len = std::min<size_t>(0xFFFF, raw.size() - pos);
+        bool last = (pos + len == raw.size());
+
+        zlib.push_back(last ? 1 : 0);
+        zlib.push_back(static_cast<uint8_t>(len));
+        zlib.push_back(static_cast<uint8_t>(len >> 8));
+        zlib.push_back(static_cast<uint8_t>(~len));
+        zlib.push_back(static_cast<uint8_t>(~len >> 8));
+        zlib.insert(zlib.end(), raw.begin() + pos, raw.begin() + pos + len);
+        pos += len;
+    }
+    for (uint8_t byte : raw)
+    {
+        a = (a + byte) % 65521;
+        b = (b + a) % 65521;
+    }
+    put32(zlib, (b << 16) | a);
+    chunk(out, "IDAT", zlib);
+    chunk(out, "IEND", {});
+    return out;
+}
+
+} // namespace
+
+Counters Counters::operator-(const Counters &other) const
+{
+    Counters diff;
+
+    diff.bytes = bytes - other.bytes;
+    diff.commands = commands - other.commands;
+    diff.caset = caset - other.caset;
+    diff.paset = paset - other.paset;
+    diff.ramwr = ramwr - other.ramwr;
+    diff.pixels = pixels - other.pixels;
+    diff.unchanged = unchanged - other.unchanged;
+    diff.ignored = ignored - other.ignored;
+    return diff;
+}
+
+Panel::Panel() : _memory(WIDTH * HEIGHT, 0)
+{
+    reset();
+}
+
+void Panel::reset()
+{
+    _madctl = 0;
+    _start[0] = 0;
+    _start[1] = 0;
+    _end[0] = WIDTH - 1;
+    _end[1] = HEIGHT - 1;
+    _cmd = 0;
+    _odd = false;
+} // the frame memory keeps its content
+
+void Panel::write(uint8_t data, bool selected, bool command)
+{
+    if (!selected)
+    {
+        ++_counters.ignored;
+        return;
+    }
+    ++_counters.bytes;
+    if (command)
+    {
+        this->command(data);
+    }
+    else
+    {
+        parameter(data);
+    }
+}
+
+void Panel::command(uint8_t cmd)
+{
+    ++_counters.commands;
+    _cmd = cmd;
+    _params = 0;
+    _odd = false;
+    switch (cmd)
+    {
+    case CMD_SWRESET:
+        reset();
+        break;
+    case CMD_CASET:
+        ++_counters.caset;
+        break;
+    case CMD_PASET:
+        ++_counters.paset;
+        break;
+    case CMD_RAMWR:
+        ++_counters.ramwr;
+        _col = _start[0];
+        _page = _start[1];
+        break;
+    default:
+        break;
+    }
+}
+
+void Panel::parameter(uint8_t data)
+{
+    unsigned n = _params++;
+
+    switch (_cmd)
+    {
+    case CMD_CASET:
+    case CMD_PASET:
+    {
+        unsigned axis = (CMD_CASET == _cmd) ? 0 : 1;
+        uint16_t &value = (2 > n) ? _start[axis] : _end[axis];
+
+        if (4 > n)
+        {
+            value = (0 == n % 2)
+                        ? static_cast<uint16_t>((data << 8) | (value & 0xFF))
+                        : static_cast<uint16_t>((value & 0xFF00) | data);
+        }
+        break;
+    }
+    case CMD_MADCTL:
+        if (0 == n)
+        {
+            _madctl = data;
+        }
+        break;
+    case CMD_RAMWR:
+        if (!_odd)
+        {
+            _high = data;
+            _odd = true;
+        }
+        else
+        {
+            store(static_cast<uint16_t>((_high << 8) | data));
+            _odd = false;
+        }
+        break;
+    default:
+        break;
+    }
+}
+
+void Panel::store(uint16_t color)
+{
+    ++_counters.pixels;
+    if ((_col < width()) && (_page < height()))
+    {
+        uint16_t &cell = _memory[index(_col, _page)];
+
+        if (cell == color)
+        {
+            ++_counters.unchanged;
+        }
+        cell = color;
+    } // outside the frame memory: dropped by the controller too
+    if (++_col > _end[0])
+    {
+        _col = _start[0];
+        if (++_page > _end[1])
+        {
+            _page = _start[1];
+        }
+    }
+}
+
+size_t Panel::index(unsigned col, unsigned page) const
+{
+    if (_madctl & MADCTL_MV)
+    {
+        std::swap(col, page);
+    }
+    if (_madctl & MADCTL_MX)
+    {
+        col = WIDTH - 1 - col;
+    }
+    if (_madctl & MADCTL_MY)
+    {
+        page = HEIGHT - 1 - page;
+    }
+    return static_cast<size_t>(page) * WIDTH + col;
+}
+
+unsigned Panel::width() const
+{
+    return (_madctl & MADCTL_MV) ? HEIGHT : WIDTH;
+}
+
+unsigned Panel::height() const
+{
+    return (_madctl & MADCTL_MV) ? WIDTH : HEIGHT;
+}
+
+uint16_t Panel::pixel(unsigned x, unsigned y) const
+{
+    return _memory[index(x, y)];
+}
+
+uint32_t Panel::hash() const
+{
+    uint32_t hash = 0x811C9DC5U;
+
+    for (unsigned y = 0; y < height(); ++y)
+    {
+        for (unsigned x = 0; x < width(); ++x)
+        {
+            uint16_t color = pixel(x, y);
+            hash = (hash ^ (color & 0xFF)) * 0x01000193U;
+            hash = (hash ^ (color >> 8)) * 0x01000193U;
+        }
+    }
+    return hash;
+}
+
+bool Panel::save(const std::string &path) const
+{
+    unsigned w = width();
+    unsigned h = height();
+    std::vector<uint8_t> rgb(static_cast<size_t>(w) * h * 3);
+    std::vector<uint8_t> out;
+    bool ppm = (4 <= path.size()) &&
+               (0 == path.compare(path.size() - 4, 4, ".ppm"));
+
+    for (unsigned y = 0; y < h; ++y)
+    {
+        for (unsigned x = 0; x < w; ++x)
+        {
+            rgb888(pixel(x, y), &rgb[(static_cast<size_t>(y) * w + x) * 3]);
+        }
+    }
+    if (ppm)
+    {
+        std::string header = "P6\n" + std::to_string(w) + " " +
+                             std::to_string(h) + "\n255\n";
+        out.assign(header.begin(), header.end());
+        out.insert(out.end(), rgb.begin(), rgb.end());
+    }
+    else
+    {
+        out = png(w, h, rgb);
+    }
+
+    FILE *file = std::fopen(path.c_str(), "wb");
+    if ((nullptr == file) ||
+        (out.size() != std::fwrite(out.data(), 1, out.size(), file)))
+    {
+        std::fprintf(stderr, "%s: %s\n", path.c_str(), std::strerror(errno));
+        if (nullptr != file)
+        {
+            std::fclose(file);
+        }
+        return false;
+    }
+    return 0 == std::fclose(file);
+}
+
+} // namespace tft
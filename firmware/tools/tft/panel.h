@@ -0,0 +1,102 @@
+/**
+ * @file panel.h
+ * @brief ILI9341 model: frame memory written through the SPI commands
+ */
+
+#ifndef VEMAR_TFT_PANEL_H
+#define VEMAR_TFT_PANEL_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace tft
+{
+
+/**
+ * @brief Traffic of the display bus
+ */
+struct Counters
+{
+    unsigned long bytes = 0;     /**< Bytes with the display selected */
+    unsigned long commands = 0;  /**< Command bytes */
+    unsigned long caset = 0;     /**< Column Address Set */
+    unsigned long paset = 0;     /**< Page Address Set */
+    unsigned long ramwr = 0;     /**< Memory Write */
+    unsigned long pixels = 0;    /**< Pixels written */
+    unsigned long unchanged = 0; /**< Pixels written with their own color */
+    unsigned long ignored = 0;   /**< Bytes with the display not selected */
+
+    Counters operator-(const Counters &other) const;
+};
+
+/**
+ * @brief Frame memory and the commands drawing into it
+ * @details Only what the driver sends is modelled: CASET, PASET, RAMWR with
+ * 16-bit pixels, MADCTL (MY, MX, MV) and SWRESET. Other commands are counted
+ * and their parameters skipped.
+ */
+class Panel
+{
+public:
+    static constexpr unsigned WIDTH = 240;  /**< Frame memory columns */
+    static constexpr unsigned HEIGHT = 320; /**< Frame memory pages */
+
+    Panel();
+
+    /**
+     * @brief Byte received on the bus
+     */
+    void write(uint8_t data, bool selected, bool command);
+
+    const Counters &counters() const
+    {
+        return _counters;
+    }
+
+    /**
+     * @brief Width of the image in the current orientation
+     */
+    unsigned width() const;
+
+    unsigned height() const;
+
+    /**
+     * @brief Pixel as drawn, in the current orientation
+     */
+    uint16_t pixel(unsigned x, unsigned y) const;
+
+    /**
+     * @brief FNV-1a hash of the image, compares two renderings
+     */
+    uint32_t hash() const;
+
+    /**
+     * @brief Write the image as PNG or PPM, after the extension of `path`
+     * @return `false` on error (reported on stderr)
+     */
+    bool save(const std::string &path) const;
+
+private:
+    void reset();
+    void command(uint8_t cmd);
+    void parameter(uint8_t data);
+    void store(uint16_t color);
+    size_t index(unsigned col, unsigned page) const;
+
+    std::vector<uint16_t> _memory; // WIDTH x HEIGHT, page-major
+    Counters _counters;
+    uint8_t _cmd = 0;
+    unsigned _params = 0; // parameters received since the command
+    uint16_t _start[2] = {}; // CASET and PASET start
+    uint16_t _end[2] = {};
+    unsigned _col = 0;
+    unsigned _page = 0;
+    uint8_t _madctl = 0;
+    uint8_t _high = 0;    // first byte of a pixel
+    bool _odd = false;    // `_high` holds a byte
+};
+
+} // namespace tft
+
+#endif // VEMAR_TFT_PANEL_H
@@ -0,0 +1,82 @@
+/**
+ * @file serial_port.h
+ * @brief Input of the host tools: serial port, capture file or stdin
+ */
+
+#ifndef VEMAR_SERIAL_PORT_H
+#define VEMAR_SERIAL_PORT_H
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+#include <fcntl.h>
+#include <termios.h>
+#include <unistd.h>
+
+namespace trace
+{
+
+inline speed_t to_speed(long baudrate)
+{
+    switch (baudrate)
+    {
+    case 9600:
+        return B9600;
+    case 19200:
+        return B19200;
+    case 38400:
+        return B38400;
+    case 57600:
+        return B57600;
+    case 115200:
+        return B115200;
+    case 230400:
+        return B230400;
+    default:
+        return B0;
+    }
+}
+
+/**
+ * @brief Open a serial port in raw mode, a capture file, or `-` for stdin
+ * @param path Device or file
+ * @param baudrate Baud rate of a serial port
+ * @return File descriptor, `-1` on error (reported on stderr)
+ */
+inline int open_input(const std::string &path, long baudrate)
+{
+    if ("-" == path)
+    {
+        return STDIN_FILENO;
+    }
+    int fd = open(path.c_str(), O_RDONLY | O_NOCTTY);
+    if (0 > fd)
+    {
+        std::fprintf(stderr, "%s: %s\n", path.c_str(), std::strerror(errno));
+        return -1;
+    }
+    struct termios tty;
+    if (0 == tcgetattr(fd, &tty))
+    {
+        speed_t speed = to_speed(baudrate);
+        if (B0 == speed)
+        {
+            std::fprintf(stderr, "unsupported baud rate %ld\n", baudrate);
+            close(fd);
+            return -1;
+        }
+        cfmakeraw(&tty);
+        cfsetispeed(&tty, speed);
+        cfsetospeed(&tty, speed);
+        tty.c_cc[VMIN] = 1;
+        tty.c_cc[VTIME] = 0;
+        tcsetattr(fd, TCSANOW, &tty);
+    } // serial port: raw mode at the requested baud rate
+    return fd;
+}
+
+} // namespace trace
+
+#endif // VEMAR_SERIAL_PORT_H
@@ -0,0 +1,226 @@
+/**
+ * @file trace_decode.cpp
+ * @brief Host decoder of the binary trace stream
+ * @details
+ * Reads COBS frames from a serial port or a capture file, checks their CRC
+ * and prints the records as text or CSV.
+ *
+ * Usage: trace_decode [-c] [-b baudrate] [device|file|-]
+ */
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+
+extern "C" {
+#include <util/packet.h>
+}
+
+#include "serial_port.h"
+#include "trace_frame.h"
+
+namespace
+{
+
+using trace::i16;
+using trace::u16;
+using trace::u32;
+
+/**
+ * @brief Print one record, a CSV line is `seq,record,field,value` per field
+ */
+class Printer
+{
+public:
+    explicit Printer(bool csv) : _csv(csv)
+    {
+        if (_csv)
+        {
+            std::printf("seq,record,field,value\n");
+        }
+    }
+
+    void record(unsigned seq, const char *name)
+    {
+        _seq = seq;
+        _name = name;
+        if (!_csv)
+        {
+            std::printf("%3u %-7s", seq, name);
+        }
+    }
+
+    void field(const char *key, long value)
+    {
+        if (_csv)
+        {
+            std::printf("%u,%s,%s,%ld\n", _seq, _name, key, value);
+        }
+        else
+        {
+            std::printf(" %s=%ld", key, value);
+        }
+    }
+
+    void end()
+    {
+        if (!_csv)
+        {
+            std::printf("\n");
+        }
+        std::fflush(stdout);
+    }
+
+private:
+    bool _csv;
+    unsigned _seq = 0;
+    const char *_name = "";
+};
+
+void print_packet(Printer &out, const uint8_t *p, size_t len)
+{
+    out.field("id", p[0]);
+    if ((PACKET_ID_CAR == p[0]) && (13 <= len))
+    {
+        // byte offsets of the packed AVR layout of packet_t.car
+        out.field("pot", u16(p + 1));
+        out.field("lx", i16(p + 3));
+        out.field("rx", i16(p + 5));
+        out.field("ly", i16(p + 7));
+        out.field("ry", i16(p + 9));
+        out.field("lb", p[11]);
+        out.field("rb", p[12]);
+    }
+}
+
+void decode(const std::vector<uint8_t> &record, Printer &out)
+{
+    size_t len = record.size();
+    unsigned seq = record[1];
+
+    const uint8_t *p = &record[TRACE_HEADER_SIZE];
+    size_t size = len - TRACE_HEADER_SIZE - TRACE_CRC_SIZE;
+    switch (record[0])
+    {
+    case TRACE_ID_PACKET:
+        out.record(seq, "packet");
+        print_packet(out, p, size);
+        break;
+    case TRACE_ID_MOTOR:
+        out.record(seq, "motor");
+        if (4 <= size)
+        {
+            out.field("left", i16(p));
+            out.field("right", i16(p + 2));
+        }
+        break;
+    case TRACE_ID_I2C:
+        out.record(seq, "i2c");
+        if (2 <= size)
+        {
+            out.field("addr", p[0]);
+            out.field("error", static_cast<int8_t>(p[1]));
+        }
+        break;
+    case TRACE_ID_TIMING:
+        out.record(seq, "timing");
+        if (5 <= size)
+        {
+            out.field("probe", p[0]);
+            out.field("value", static_cast<long>(u32(p + 1)));
+        }
+        break;
+    case TRACE_ID_PROFILE:
+        out.record(seq, "profile");
+        if (TRACE_PROFILE_SIZE <= size)
+        {
+            out.field("id", p[0]);
+            out.field("count", u16(p + 1));
+            out.field("min", static_cast<long>(u32(p + 3)));
+            out.field("max", static_cast<long>(u32(p + 7)));
+            out.field("total", static_cast<long>(u32(p + 11)));
+        }
+        break;
+    case TRACE_ID_MODULE:
+        out.record(seq, "module");
+        if (1 <= size)
+        {
+            out.field("id", p[0]); // `tools/ground` decodes the fields
+        }
+        break;
+    case TRACE_ID_SRAM:
+        out.record(seq, "sram");
+        if (6 <= size)
+        {
+            out.field("free_min", u16(p));
+            out.field("free", u16(p + 2));
+            out.field("heap", u16(p + 4));
+        }
+        break;
+    default:
+        out.record(seq, "unknown");
+        out.field("id", record[0]);
+        break;
+    }
+    out.end();
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    bool csv = false;
+    long baudrate = 115200;
+    int opt;
+
+    while (-1 != (opt = getopt(argc, argv, "cb:")))
+    {
+        switch (opt)
+        {
+        case 'c':
+            csv = true;
+            break;
+        case 'b':
+            baudrate = std::strtol(optarg, nullptr, 10);
+            break;
+        default:
+            std::fprintf(stderr, "usage: %s [-c] [-b baudrate] "
+                                 "[device|file|-]\n",
+                         argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+    int fd = trace::open_input((optind < argc) ? argv[optind] : "-", baudrate);
+    if (0 > fd)
+    {
+        return EXIT_FAILURE;
+    }
+
+    Printer out(csv);
+    trace::FrameReader reader;
+    uint8_t chunk[256];
+    ssize_t n;
+
+    while (0 < (n = read(fd, chunk, sizeof(chunk))))
+    {
+        reader.feed(chunk, static_cast<size_t>(n),
+                    [&out](const std::vector<uint8_t> &record) {
+                        decode(record, out);
+                    });
+    }
+    const trace::Stats &stats = reader.stats();
+    std::fprintf(stderr,
+                 "%lu records, %lu lost, %lu crc errors, %lu framing errors\n",
+                 stats.records, stats.lost, stats.crc_errors,
+                 stats.framing_errors);
+    if (STDIN_FILENO != fd)
+    {
+        close(fd);
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,170 @@
+/**
+ * @file trace_frame.h
+ * @brief Host side of the trace framing: COBS, CRC and sequence checks
+ * @details
+ * Shared by the host tools reading the trace stream. `FrameReader` takes the
+ * raw bytes as they come from the serial port or a capture file, in chunks of
+ * any size, and hands over every record whose frame and CRC are valid.
+ */
+
+#ifndef VEMAR_TRACE_FRAME_H
+#define VEMAR_TRACE_FRAME_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+extern "C" {
+#include <util/trace.h>
+}
+
+namespace trace
+{
+
+struct Stats
+{
+    unsigned long records = 0;
+    unsigned long crc_errors = 0;
+    unsigned long framing_errors = 0;
+    unsigned long lost = 0;
+};
+
+/**
+ * @brief Same update as `_crc_ccitt_update` from avr-libc
+ */
+inline uint16_t crc_ccitt_update(uint16_t crc, uint8_t data)
+{
+    data ^= static_cast<uint8_t>(crc & 0xFF);
+    data ^= static_cast<uint8_t>(data << 4);
+    return static_cast<uint16_t>(((static_cast<uint16_t>(data) << 8) |
+                                  (crc >> 8)) ^
+                                 static_cast<uint8_t>(data >> 4) ^
+                                 (static_cast<uint16_t>(data) << 3));
+}
+
+inline bool cobs_decode(const std::vector<uint8_t> &src,
+                        std::vector<uint8_t> &dst)
+{
+    size_t pos = 0;
+
+    dst.clear();
+    while (pos < src.size())
+    {
+        uint8_t code = src[pos++];
+        if (0 == code)
+        {
+            return false;
+        }
+        for (uint8_t i = 1; i < code; ++i)
+        {
+            if (pos >= src.size())
+            {
+                return false;
+            }
+            dst.push_back(src[pos++]);
+        }
+        if ((0xFF != code) && (pos < src.size()))
+        {
+            dst.push_back(0x00);
+        }
+    }
+    return true;
+}
+
+inline uint16_t u16(const uint8_t *p)
+{
+    return static_cast<uint16_t>(p[0] | (p[1] << 8));
+}
+
+inline int16_t i16(const uint8_t *p)
+{
+    return static_cast<int16_t>(u16(p));
+}
+
+inline uint32_t u32(const uint8_t *p)
+{
+    return static_cast<uint32_t>(u16(p)) |
+           (static_cast<uint32_t>(u16(p + 2)) << 16);
+}
+
+/**
+ * @brief Split a byte stream into checked records
+ * @details A record is `id seq payload crc`, see `util/trace.h`. The bytes
+ * before the first delimiter are skipped, the stream may start mid-frame.
+ */
+class FrameReader
+{
+public:
+    /**
+     * @brief Feed bytes from the stream
+     * @param data Bytes read
+     * @param len Number of bytes
+     * @param fn Called with each valid record, as `fn(record)`
+     */
+    template <typename Fn>
+    void feed(const uint8_t *data, size_t len, Fn &&fn)
+    {
+        for (size_t i = 0; i < len; ++i)
+        {
+            if (0x00 != data[i])
+            {
+                if (TRACE_FRAME_MAX > _frame.size())
+                {
+                    _frame.push_back(data[i]);
+                }
+                continue;
+            }
+            if (_synced && !_frame.empty() && check())
+            {
+                fn(static_cast<const std::vector<uint8_t> &>(_record));
+            }
+            _synced = true;
+            _frame.clear();
+        }
+    }
+
+    const Stats &stats() const
+    {
+        return _stats;
+    }
+
+private:
+    bool check()
+    {
+        if (!cobs_decode(_frame, _record) ||
+            (TRACE_HEADER_SIZE + TRACE_CRC_SIZE > _record.size()))
+        {
+            ++_stats.framing_errors;
+            return false;
+        }
+        size_t len = _record.size();
+        uint16_t crc = TRACE_CRC_INIT;
+        for (size_t i = 0; i < len - TRACE_CRC_SIZE; ++i)
+        {
+            crc = crc_ccitt_update(crc, _record[i]);
+        }
+        if (crc != u16(&_record[len - TRACE_CRC_SIZE]))
+        {
+            ++_stats.crc_errors;
+            return false;
+        }
+        unsigned seq = _record[1];
+        if (0 <= _last_seq)
+        {
+            _stats.lost += (seq - static_cast<unsigned>(_last_seq) - 1) & 0xFF;
+        }
+        _last_seq = static_cast<int>(seq);
+        ++_stats.records;
+        return true;
+    }
+
+    std::vector<uint8_t> _frame;
+    std::vector<uint8_t> _record;
+    Stats _stats;
+    int _last_seq = -1;
+    bool _synced = false; // the first frame may be truncated
+};
+
+} // namespace trace
+
+#endif // VEMAR_TRACE_FRAME_H